@@ -0,0 +1,200 @@
+#include "bench/benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Bench {
+
+namespace {
+
+double elapsed_ns(const Body& body, uint64_t iterations, Counters& counters) {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations, counters);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+bool selected(const Options& options, const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void print(const Result& result) {
+    std::cout << std::left << std::setw(44) << result.name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(1) << result.ns_per_op << " ns/op" << std::setw(16) << std::setprecision(0)
+              << result.ops_per_sec << " ops/s";
+    for (const auto& [key, value] : result.counters) {
+        std::cout << "  " << key << "=" << std::setprecision(1) << value;
+    }
+    std::cout << std::endl;
+}
+
+Result make_result(const std::string& name, uint64_t iterations, double ns, Counters counters) {
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ns_per_op = ns / iterations;
+    result.ops_per_sec = ns > 0 ? iterations * 1e9 / ns : 0;
+    result.counters = std::move(counters);
+    return result;
+}
+
+std::string escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+Runner::Runner(Options options) : options_(std::move(options)) {}
+
+bool Runner::run(const std::string& name, const Body& body) {
+    if (!selected(options_, name)) {
+        return false;
+    }
+    const double min_ns = options_.min_time_ms * 1e6;
+    uint64_t batch = 1;
+    Counters counters;
+    // Calibrate; the last calibration batch doubles as warm-up
+    while (true) {
+        counters.clear();
+        double ns = elapsed_ns(body, batch, counters);
+        if (ns >= min_ns || batch >= (1ULL << 40)) {
+            break;
+        }
+        double scale = ns > 0 ? std::min(10.0, std::max(2.0, 1.2 * min_ns / ns)) : 10.0;
+        batch = static_cast<uint64_t>(batch * scale);
+    }
+
+    double best = 0;
+    Counters best_counters;
+    for (int round = 0; round < std::max(1, options_.rounds); ++round) {
+        counters.clear();
+        double ns = elapsed_ns(body, batch, counters);
+        if (round == 0 || ns < best) {
+            best = ns;
+            best_counters = counters;
+        }
+    }
+    results_.push_back(make_result(name, batch, best, std::move(best_counters)));
+    print(results_.back());
+    return true;
+}
+
+bool Runner::run_fixed(const std::string& name, uint64_t iterations, const Body& body) {
+    if (!selected(options_, name)) {
+        return false;
+    }
+    Counters counters;
+    double ns = elapsed_ns(body, iterations, counters);
+    results_.push_back(make_result(name, iterations, ns, std::move(counters)));
+    print(results_.back());
+    return true;
+}
+
+Options parse_options(int argc, char* argv[], std::vector<std::string>& rest) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("--filter=", 0) == 0) {
+                options.filter = arg.substr(9);
+            } else if (arg.rfind("--min-time-ms=", 0) == 0) {
+                options.min_time_ms = std::stod(arg.substr(14));
+            } else if (arg.rfind("--rounds=", 0) == 0) {
+                options.rounds = std::stoi(arg.substr(9));
+            } else {
+                rest.push_back(arg);
+            }
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("Invalid value in " + arg);
+        }
+    }
+    if (options.min_time_ms <= 0 || options.rounds <= 0) {
+        throw std::invalid_argument("--min-time-ms and --rounds must be positive");
+    }
+    return options;
+}
+
+void write_json(const std::vector<Result>& results, const std::string& path) {
+    std::ostringstream json;
+    json << std::setprecision(17);
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    json << "{\n";
+    json << "  \"context\": {\"date\": \"" << date << "\", \"num_cpus\": " << std::thread::hardware_concurrency()
+#ifdef NDEBUG
+         << ", \"build\": \"opt\"},\n";
+#else
+         << ", \"build\": \"debug\"},\n";
+#endif
+    json << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json << "    {\"name\": \"" << escape(result.name) << "\", \"iterations\": " << result.iterations
+             << ", \"ns_per_op\": " << result.ns_per_op << ", \"ops_per_sec\": " << result.ops_per_sec;
+        for (const auto& [key, value] : result.counters) {
+            json << ", \"" << escape(key) << "\": " << value;
+        }
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    std::ofstream file(path, std::ios::trunc);
+    file << json.str();
+    if (!file) {
+        throw std::runtime_error("Unable to write benchmark results to " + path);
+    }
+}
+
+std::map<std::string, double> read_baseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Unable to open baseline " + path);
+    }
+    // write_json puts one benchmark per line, so a line scan is enough
+    std::map<std::string, double> baseline;
+    const std::string name_key = "{\"name\": \"";
+    const std::string time_key = "\"ns_per_op\": ";
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name_at = line.find(name_key);
+        size_t time_at = line.find(time_key);
+        if (name_at == std::string::npos || time_at == std::string::npos) {
+            continue;
+        }
+        size_t begin = name_at + name_key.size();
+        size_t end = line.find('"', begin);
+        baseline[line.substr(begin, end - begin)] = std::stod(line.substr(time_at + time_key.size()));
+    }
+    return baseline;
+}
+
+void print_comparison(const std::vector<Result>& results, const std::map<std::string, double>& baseline) {
+    std::cout << std::endl << "=== Against Baseline ===" << std::endl;
+    for (const auto& result : results) {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0) {
+            continue;
+        }
+        double change = (result.ns_per_op - it->second) / it->second * 100;
+        std::cout << std::left << std::setw(44) << result.name << std::right << std::setw(14) << std::fixed
+                  << std::setprecision(1) << it->second << " -> " << result.ns_per_op << " ns/op  ("
+                  << std::showpos << change << "%" << std::noshowpos << ")" << std::endl;
+    }
+}
+
+} // namespace Bench
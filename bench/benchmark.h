@@ -0,0 +1,83 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+// Counters a benchmark can report besides time per operation, e.g.
+// {"ticks_per_sec", ...}. They are written to the JSON report as-is.
+using Counters = std::map<std::string, double>;
+
+struct Result {
+    std::string name;
+    // Operations timed, summed over all rounds
+    uint64_t iterations = 0;
+    double ns_per_op = 0;
+    double ops_per_sec = 0;
+    Counters counters;
+};
+
+struct Options {
+    // Only benchmarks whose name contains this run
+    std::string filter;
+    // Each benchmark grows its batch size until one batch takes this long
+    double min_time_ms = 200;
+    // Timed rounds at the final batch size; the fastest one is reported
+    int rounds = 3;
+};
+
+// A benchmark body runs `iterations` operations and may fill in counters.
+// Setup that should not be timed belongs outside the body or in a fixture
+// created before Runner::run.
+using Body = std::function<void(uint64_t iterations, Counters& counters)>;
+
+// Hand-rolled timing loop in the spirit of Google Benchmark, without the
+// dependency: batches double until one takes min_time_ms, then the best of
+// `rounds` batches is kept, which filters out most scheduling noise.
+class Runner {
+private:
+    Options options_;
+    std::vector<Result> results_;
+public:
+    explicit Runner(Options options);
+
+    // Times body and prints one line for it. Returns false if filtered out.
+    bool run(const std::string& name, const Body& body);
+    // Runs body exactly `iterations` times, once (for macrobenchmarks whose
+    // operations are too slow to calibrate).
+    bool run_fixed(const std::string& name, uint64_t iterations, const Body& body);
+
+    const std::vector<Result>& results() const { return results_; }
+};
+
+// Parses the common benchmark flags (--filter=, --min-time-ms=, --rounds=)
+// and leaves the rest in `rest`. Throws std::invalid_argument on bad values.
+Options parse_options(int argc, char* argv[], std::vector<std::string>& rest);
+
+// {"context": {...}, "benchmarks": [{"name": ..., "iterations": ...,
+// "ns_per_op": ..., "ops_per_sec": ..., <counters>}, ...]}, one benchmark per
+// line. Throws std::runtime_error if path cannot be written.
+void write_json(const std::vector<Result>& results, const std::string& path);
+
+// Reads back the name and ns_per_op of every benchmark in a report written by
+// write_json. Throws std::runtime_error if path cannot be read.
+std::map<std::string, double> read_baseline(const std::string& path);
+
+// Prints, for every result also in the baseline, its change in ns_per_op.
+void print_comparison(const std::vector<Result>& results, const std::map<std::string, double>& baseline);
+
+// Keeps the optimizer from discarding a value a benchmark computes.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace Bench
+
+#endif // _BENCHMARK_H_
@@ -0,0 +1,165 @@
+#include "bench/benchmark.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> parse_list(const std::string& list) {
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoi(item));
+    }
+    return values;
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--groups=100,300,1000,3000] [--group-size=3] [--hosts=10]"
+              << " [--ticks=2000] [--warmup=500] [--bandwidth=<bytes/tick>] [--base-latency=<ticks>]"
+              << " [--overhead=<bytes>] [--queue-limit=<messages>] [--json=<file>]" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// Network messages and executor tasks per simulated tick against the number of
+// Raft groups sharing a fixed set of hosts, with every heartbeat sent on its
+// own and with heartbeats coalesced per host pair. With --bandwidth, links
+// between hosts are shaped (see IO::LinkModel) and the table adds their
+// utilization, queueing delay and drops.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    std::vector<int> group_counts = {100, 300, 1000, 3000};
+    int group_size = 3, hosts = 10, ticks = 2000, warmup = 500;
+    std::string json_path;
+    IO::LinkModel links;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+        for (const auto& arg : rest) {
+            if (arg.rfind("--groups=", 0) == 0) {
+                group_counts = parse_list(arg.substr(9));
+            } else if (arg.rfind("--group-size=", 0) == 0) {
+                group_size = std::stoi(arg.substr(13));
+            } else if (arg.rfind("--hosts=", 0) == 0) {
+                hosts = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--ticks=", 0) == 0) {
+                ticks = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--warmup=", 0) == 0) {
+                warmup = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--bandwidth=", 0) == 0) {
+                links.bandwidth = std::stoi(arg.substr(12));
+            } else if (arg.rfind("--base-latency=", 0) == 0) {
+                links.base_latency = std::stoi(arg.substr(15));
+            } else if (arg.rfind("--overhead=", 0) == 0) {
+                links.overhead = std::stoi(arg.substr(11));
+            } else if (arg.rfind("--queue-limit=", 0) == 0) {
+                links.queue_limit = std::stoi(arg.substr(14));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json_path = arg.substr(7);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+
+    Simulation::FuzzInput input;
+    input.rng_seed = 42;
+    input.max_steps = 50000;
+    input.normalize();
+    if (warmup + ticks > input.max_steps) {
+        std::cerr << "--warmup plus --ticks must not exceed " << input.max_steps << std::endl;
+        return 1;
+    }
+
+    Bench::Runner runner(options);
+    for (int groups : group_counts) {
+        for (bool coalesce : {false, true}) {
+            Simulation::SuppressOutput suppress;
+            Simulation::Topology topology;
+            topology.nr_nodes = groups * group_size;
+            topology.group_size = group_size;
+            topology.hosts = hosts;
+            topology.coalesce_heartbeats = coalesce;
+            topology.links = links;
+            Simulation::SimulationContext ctx(input, nullptr, topology);
+            for (int i = 0; i < warmup; ++i) {
+                ctx.step();
+            }
+            std::string name = std::string("multiraft/") + (coalesce ? "coalesced" : "direct") +
+                               "/groups=" + std::to_string(groups);
+            runner.run_fixed(name, ticks, [&ctx, groups](uint64_t n, Bench::Counters& counters) {
+                size_t messages = ctx.network().messages_sent();
+                size_t tasks = ctx.executor().tasks_run();
+                size_t dropped = ctx.network().messages_dropped();
+                auto links_before = ctx.network().link_stats();
+                for (uint64_t i = 0; i < n; ++i) {
+                    ctx.step();
+                }
+                counters["groups"] = groups;
+                counters["msgs_per_tick"] = static_cast<double>(ctx.network().messages_sent() - messages) / n;
+                counters["tasks_per_tick"] = static_cast<double>(ctx.executor().tasks_run() - tasks) / n;
+                if (!ctx.network().link_model().shaped()) {
+                    return;
+                }
+                // Over the measured ticks only: subtract what the links did before
+                std::map<std::pair<int, int>, IO::LinkStats> before;
+                for (const auto& link : links_before) {
+                    before[{link.from, link.to}] = link;
+                }
+                double busiest = 0, waited = 0;
+                size_t queued = 0;
+                for (const auto& link : ctx.network().link_stats()) {
+                    const auto& old = before[{link.from, link.to}];
+                    busiest = std::max(busiest, (link.busy_ticks - old.busy_ticks) / n);
+                    waited += link.queueing_delay - old.queueing_delay;
+                    queued += link.messages - old.messages;
+                }
+                counters["max_link_util"] = busiest;
+                counters["queue_delay"] = queued > 0 ? waited / queued : 0;
+                counters["drops_per_tick"] = static_cast<double>(ctx.network().messages_dropped() - dropped) / n;
+            });
+        }
+    }
+
+    std::cout << std::endl << "=== Messages and Tasks by Group Count (" << hosts << " hosts) ===" << std::endl;
+    std::cout << std::setw(8) << "groups" << std::setw(11) << "mode" << std::setw(12) << "ticks/s"
+              << std::setw(14) << "msgs/tick" << std::setw(14) << "msgs/s" << std::setw(14) << "tasks/tick";
+    if (links.shaped()) {
+        std::cout << std::setw(14) << "max link util" << std::setw(14) << "queue delay" << std::setw(14) << "drops/tick";
+    }
+    std::cout << std::endl;
+    for (const auto& result : runner.results()) {
+        bool coalesced = result.name.find("/coalesced/") != std::string::npos;
+        double msgs_per_tick = result.counters.at("msgs_per_tick");
+        std::cout << std::setw(8) << static_cast<int>(result.counters.at("groups"))
+                  << std::setw(11) << (coalesced ? "coalesced" : "direct")
+                  << std::setw(12) << std::fixed << std::setprecision(0) << result.ops_per_sec
+                  << std::setw(14) << std::setprecision(1) << msgs_per_tick
+                  << std::setw(14) << std::setprecision(0) << msgs_per_tick * result.ops_per_sec
+                  << std::setw(14) << std::setprecision(1) << result.counters.at("tasks_per_tick");
+        if (links.shaped()) {
+            std::cout << std::setw(14) << std::setprecision(3) << result.counters.at("max_link_util")
+                      << std::setw(14) << std::setprecision(2) << result.counters.at("queue_delay")
+                      << std::setw(14) << std::setprecision(2) << result.counters.at("drops_per_tick");
+        }
+        std::cout << std::endl;
+    }
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
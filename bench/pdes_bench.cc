@@ -0,0 +1,129 @@
+#include "bench/benchmark.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/parallel_harness.h"
+#include "src/simulation/simulation_harness.h"
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> parse_list(const std::string& list) {
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoi(item));
+    }
+    return values;
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--sizes=1000,10000] [--group-size=5] [--threads=1,2,4,8]"
+              << " [--base-latency=0] [--ticks=2000] [--json=<file>]" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// Simulated ticks per second of one large cluster on the static stack (one
+// RNG stream, one thread) against the partitioned context on 1..N threads.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    std::vector<int> sizes = {1000, 10000}, thread_counts = {1, 2, 4, 8};
+    int group_size = 5, ticks = 2000, base_latency = 0;
+    std::string json_path;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+        for (const auto& arg : rest) {
+            if (arg.rfind("--sizes=", 0) == 0) {
+                sizes = parse_list(arg.substr(8));
+            } else if (arg.rfind("--group-size=", 0) == 0) {
+                group_size = std::stoi(arg.substr(13));
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                thread_counts = parse_list(arg.substr(10));
+            } else if (arg.rfind("--base-latency=", 0) == 0) {
+                base_latency = std::stoi(arg.substr(15));
+            } else if (arg.rfind("--ticks=", 0) == 0) {
+                ticks = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json_path = arg.substr(7);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+
+    Simulation::FuzzInput input;
+    input.rng_seed = 42;
+    input.max_steps = 50000;
+    input.normalize();
+
+    Bench::Runner runner(options);
+    // (nodes, threads) -> ticks per second; threads 0 is the static stack
+    std::map<std::pair<int, int>, double> ticks_per_sec;
+    for (int nr_nodes : sizes) {
+        Simulation::Topology topology{nr_nodes, group_size};
+        topology.links.base_latency = base_latency;
+        std::string prefix = "pdes/nodes=" + std::to_string(nr_nodes);
+        if (runner.run_fixed(prefix + "/static", ticks, [&](uint64_t n, Bench::Counters&) {
+                Simulation::SuppressOutput suppress;
+                Simulation::StaticSimulationContext ctx(input, nullptr, topology);
+                for (uint64_t i = 0; i < n && !ctx.done(); ++i) {
+                    ctx.step();
+                }
+            })) {
+            ticks_per_sec[{nr_nodes, 0}] = runner.results().back().ops_per_sec;
+        }
+        for (int threads : thread_counts) {
+            bool ran = runner.run_fixed(prefix + "/threads=" + std::to_string(threads), ticks,
+                [&](uint64_t n, Bench::Counters& counters) {
+                    Simulation::SuppressOutput suppress;
+                    Simulation::ParallelSimulationContext ctx(input, topology, {threads, 0});
+                    while (ctx.steps() < static_cast<int>(n) && !ctx.done()) {
+                        ctx.step();
+                    }
+                    counters["threads"] = ctx.threads();
+                    counters["lookahead"] = ctx.lookahead();
+                    counters["tasks"] = ctx.tasks_run();
+                });
+            if (ran) {
+                ticks_per_sec[{nr_nodes, threads}] = runner.results().back().ops_per_sec;
+            }
+        }
+    }
+
+    std::cout << std::endl << "=== Ticks per Second (speedup over 1 thread) ===" << std::endl;
+    std::cout << std::setw(8) << "nodes" << std::setw(12) << "static";
+    for (int threads : thread_counts) {
+        std::cout << std::setw(20) << ("threads=" + std::to_string(threads));
+    }
+    std::cout << std::endl;
+    for (int nr_nodes : sizes) {
+        std::cout << std::setw(8) << nr_nodes << std::setw(12) << std::fixed << std::setprecision(0)
+                  << ticks_per_sec[{nr_nodes, 0}];
+        double single = ticks_per_sec[{nr_nodes, thread_counts.front()}];
+        for (int threads : thread_counts) {
+            double rate = ticks_per_sec[{nr_nodes, threads}];
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(0) << rate << " (" << std::setprecision(2)
+                 << (single > 0 ? rate / single : 0) << "x)";
+            std::cout << std::setw(20) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
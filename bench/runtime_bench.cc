@@ -0,0 +1,300 @@
+#include "bench/benchmark.h"
+#include "src/log/log.h"
+#include "src/runtime/raft_process.h"
+#include "src/runtime/tcp_network.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int) { stop_requested = 1; }
+
+long long monotonic_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void write_line(int fd, const std::string& line) {
+    std::string text = line + "\n";
+    size_t done = 0;
+    while (done < text.size()) {
+        ssize_t n = ::write(fd, text.data() + done, text.size() - done);
+        if (n <= 0) {
+            return;
+        }
+        done += n;
+    }
+}
+
+// Runs node `id` until SIGTERM, reporting to out: "leader <term> <us>" each
+// time it wins an election (us on the system-wide monotonic clock), then
+// "stats <messages sent> <latency us>..." with every RPC it timed.
+[[noreturn]] void run_child(Runtime::ProcessOptions options, int out) {
+    std::signal(SIGTERM, request_stop);
+    Log::ScopedSink quiet(Log::null_stream());
+    int status = 0;
+    try {
+        Runtime::RaftProcess process(options);
+        size_t elections = 0;
+        while (!stop_requested) {
+            process.poll(5);
+            if (process.elections_won() != elections) {
+                elections = process.elections_won();
+                write_line(out, "leader " + std::to_string(process.node().get_term()) + " " +
+                                std::to_string(monotonic_us()));
+            }
+        }
+        std::ostringstream stats;
+        stats << "stats " << process.network().messages_sent();
+        for (double latency : process.network().rpc_latencies_us()) {
+            stats << " " << latency;
+        }
+        write_line(out, stats.str());
+    } catch (const std::exception& e) {
+        std::cerr << "[Bench] Node " << options.id << ": " << e.what() << std::endl;
+        status = 1;
+    }
+    ::close(out);
+    _exit(status);
+}
+
+struct ClusterRun {
+    // From forking the nodes to the first leader, in milliseconds (-1: none)
+    double election_ms = -1;
+    size_t elections = 0;
+    size_t messages = 0;
+    std::vector<double> latencies_us;
+};
+
+// Starts nodes processes on loopback, lets them run for duration_ms and
+// collects what they report.
+ClusterRun run_cluster(int nodes, const Runtime::ProcessOptions& base, int duration_ms) {
+    std::vector<int> listeners;
+    std::vector<Runtime::Endpoint> peers;
+    for (int i = 0; i < nodes; ++i) {
+        listeners.push_back(Runtime::open_listener({"127.0.0.1", 0}));
+        peers.push_back({"127.0.0.1", Runtime::bound_port(listeners.back())});
+    }
+    std::vector<pid_t> children;
+    std::vector<int> pipes;
+    long long start_us = monotonic_us();
+    for (int i = 0; i < nodes; ++i) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw std::runtime_error("Unable to create pipe");
+        }
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw std::runtime_error("Unable to fork");
+        }
+        if (pid == 0) {
+            ::close(fds[0]);
+            for (int j = 0; j < nodes; ++j) {
+                if (j != i) {
+                    ::close(listeners[j]);
+                }
+            }
+            Runtime::ProcessOptions options = base;
+            options.id = i;
+            options.peers = peers;
+            options.seed = base.seed + i;
+            options.listen_fd = listeners[i];
+            run_child(options, fds[1]);
+        }
+        ::close(fds[1]);
+        children.push_back(pid);
+        pipes.push_back(fds[0]);
+    }
+    for (int fd : listeners) {
+        ::close(fd);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    for (pid_t pid : children) {
+        kill(pid, SIGTERM);
+    }
+
+    ClusterRun run;
+    long long first_leader_us = -1;
+    for (int fd : pipes) {
+        std::string text;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+            text.append(buffer, n);
+        }
+        ::close(fd);
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::istringstream fields(line);
+            std::string kind;
+            fields >> kind;
+            if (kind == "leader") {
+                int term;
+                long long at_us;
+                fields >> term >> at_us;
+                ++run.elections;
+                if (first_leader_us < 0 || at_us < first_leader_us) {
+                    first_leader_us = at_us;
+                }
+            } else if (kind == "stats") {
+                size_t messages;
+                fields >> messages;
+                run.messages += messages;
+                double latency;
+                while (fields >> latency) {
+                    run.latencies_us.push_back(latency);
+                }
+            }
+        }
+    }
+    for (pid_t pid : children) {
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            throw std::runtime_error("A node process failed");
+        }
+    }
+    if (first_leader_us >= 0) {
+        run.election_ms = (first_leader_us - start_us) / 1000.0;
+    }
+    return run;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--nodes=3,5] [--clusters=10] [--duration-ms=1000]"
+              << " [--election-timeout=150-300] [--heartbeat=50] [--json=<file>]" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// Real Raft clusters on localhost: for each cluster size, starts --clusters
+// clusters of node processes in turn (the RaftNode the simulator runs, over
+// TCP with real timers), runs each for --duration-ms and reports how fast a
+// leader is elected from cold start and the latency of the RPCs they make.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    std::vector<int> sizes = {3, 5};
+    int clusters = 10, duration_ms = 1000;
+    Runtime::ProcessOptions base;
+    std::string json_path;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+        for (const auto& arg : rest) {
+            if (arg.rfind("--nodes=", 0) == 0) {
+                sizes.clear();
+                std::stringstream list(arg.substr(8));
+                std::string item;
+                while (std::getline(list, item, ',')) {
+                    sizes.push_back(std::stoi(item));
+                }
+            } else if (arg.rfind("--clusters=", 0) == 0) {
+                clusters = std::stoi(arg.substr(11));
+            } else if (arg.rfind("--duration-ms=", 0) == 0) {
+                duration_ms = std::stoi(arg.substr(14));
+            } else if (arg.rfind("--election-timeout=", 0) == 0) {
+                std::string range = arg.substr(19);
+                size_t dash = range.find('-');
+                if (dash == std::string::npos) {
+                    return usage(argv[0]);
+                }
+                base.election_timeout_min = std::stoi(range.substr(0, dash));
+                base.election_timeout_max = std::stoi(range.substr(dash + 1));
+            } else if (arg.rfind("--heartbeat=", 0) == 0) {
+                base.heartbeat_interval = std::stoi(arg.substr(12));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json_path = arg.substr(7);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+
+    Bench::Runner runner(options);
+    try {
+        for (int nodes : sizes) {
+            // One op = one cluster started, run for --duration-ms and stopped
+            runner.run_fixed("runtime/nodes=" + std::to_string(nodes), clusters,
+                             [&](uint64_t n, Bench::Counters& counters) {
+                std::vector<double> election_ms, latencies;
+                size_t elections = 0, messages = 0, leaderless = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    base.seed = static_cast<uint32_t>(i * 1000);
+                    auto run = run_cluster(nodes, base, duration_ms);
+                    if (run.election_ms < 0) {
+                        ++leaderless;
+                    } else {
+                        election_ms.push_back(run.election_ms);
+                    }
+                    elections += run.elections;
+                    messages += run.messages;
+                    latencies.insert(latencies.end(), run.latencies_us.begin(), run.latencies_us.end());
+                }
+                double total_ms = 0;
+                for (double ms : election_ms) {
+                    total_ms += ms;
+                }
+                counters["nodes"] = nodes;
+                counters["elections_per_sec"] = total_ms > 0 ? election_ms.size() * 1000.0 / total_ms : 0;
+                counters["election_p50_ms"] = percentile(election_ms, 0.5);
+                counters["election_max_ms"] = percentile(election_ms, 1.0);
+                counters["leaderless"] = leaderless;
+                // Beyond the first: a stable cluster never elects again
+                counters["reelections"] = static_cast<double>(elections - election_ms.size()) / n;
+                counters["msgs_per_sec"] = messages * 1000.0 / (static_cast<double>(n) * duration_ms);
+                counters["rpc_p50_us"] = percentile(latencies, 0.5);
+                counters["rpc_p99_us"] = percentile(latencies, 0.99);
+            });
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "[Bench] " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl << "=== Real Clusters on Localhost (" << clusters << " per size, " << duration_ms
+              << " ms each) ===" << std::endl;
+    std::cout << std::setw(6) << "nodes" << std::setw(14) << "elections/s" << std::setw(14) << "p50 elect ms"
+              << std::setw(14) << "max elect ms" << std::setw(13) << "reelections" << std::setw(12) << "msgs/s"
+              << std::setw(14) << "rpc p50 us" << std::setw(14) << "rpc p99 us" << std::endl;
+    for (const auto& result : runner.results()) {
+        const auto& c = result.counters;
+        std::cout << std::setw(6) << static_cast<int>(c.at("nodes")) << std::fixed << std::setprecision(1)
+                  << std::setw(14) << c.at("elections_per_sec") << std::setw(14) << c.at("election_p50_ms")
+                  << std::setw(14) << c.at("election_max_ms") << std::setw(13) << c.at("reelections")
+                  << std::setw(12) << std::setprecision(0) << c.at("msgs_per_sec") << std::setw(14)
+                  << c.at("rpc_p50_us") << std::setw(14) << c.at("rpc_p99_us") << std::endl;
+    }
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "bench/benchmark.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> parse_sizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back(std::stoi(item));
+    }
+    return sizes;
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--sizes=5,1000,2000,5000,10000] [--group-size=5] [--ticks=2000]"
+              << " [--warmup=500] [--json=<file>]" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// Simulated ticks per second against cluster size. Clusters are split into
+// independent Raft groups, as a fleet is; each size first runs through the
+// initial elections, then a fixed number of ticks is timed.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    std::vector<int> sizes = {5, 1000, 2000, 5000, 10000};
+    int group_size = 5, ticks = 2000, warmup = 500;
+    std::string json_path;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+        for (const auto& arg : rest) {
+            if (arg.rfind("--sizes=", 0) == 0) {
+                sizes = parse_sizes(arg.substr(8));
+            } else if (arg.rfind("--group-size=", 0) == 0) {
+                group_size = std::stoi(arg.substr(13));
+            } else if (arg.rfind("--ticks=", 0) == 0) {
+                ticks = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--warmup=", 0) == 0) {
+                warmup = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json_path = arg.substr(7);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+
+    Simulation::FuzzInput input;
+    input.rng_seed = 42;
+    input.max_steps = 50000;
+    input.normalize();
+    if (warmup + ticks > input.max_steps) {
+        std::cerr << "--warmup plus --ticks must not exceed " << input.max_steps << std::endl;
+        return 1;
+    }
+
+    Bench::Runner runner(options);
+    for (int nr_nodes : sizes) {
+        Simulation::SuppressOutput suppress;
+        Simulation::SimulationContext ctx(input, nullptr, Simulation::Topology{nr_nodes, std::min(group_size, nr_nodes)});
+        for (int i = 0; i < warmup; ++i) {
+            ctx.step();
+        }
+        runner.run_fixed("scaling/tick/nodes=" + std::to_string(nr_nodes), ticks,
+            [&ctx, nr_nodes](uint64_t n, Bench::Counters& counters) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ctx.step();
+                }
+                counters["nodes"] = nr_nodes;
+            });
+    }
+
+    std::cout << std::endl << "=== Ticks per Second by Cluster Size ===" << std::endl;
+    std::cout << std::setw(8) << "nodes" << std::setw(16) << "ticks/s" << std::setw(16) << "ns/node-tick" << std::endl;
+    for (const auto& result : runner.results()) {
+        double nodes = result.counters.at("nodes");
+        std::cout << std::setw(8) << static_cast<int>(nodes) << std::setw(16) << std::fixed << std::setprecision(0)
+                  << result.ops_per_sec << std::setw(16) << std::setprecision(1) << result.ns_per_op / nodes
+                  << std::endl;
+    }
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,333 @@
+#include "bench/benchmark.h"
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/io/codec.h"
+#include "src/io/messages.h"
+#include "src/io/network.h"
+#include "src/node/node.h"
+#include "src/node/state.h"
+#include "src/rng/rng.h"
+#include "src/routing/router.h"
+#include "src/scheduler/scheduler.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/system/system.h"
+#include <coroutine>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Component wiring shared by the microbenchmarks, as the harness builds it
+// but with no jitter or network delay, so every task is due immediately.
+struct Components {
+    std::shared_ptr<Clock::DeterministicClock> clock = std::make_shared<Clock::DeterministicClock>();
+    std::shared_ptr<RNG::UniformDistributionRange> rng = std::make_shared<RNG::UniformDistributionRange>(42);
+    std::shared_ptr<Executor::PriorityQueueExecutor> executor = std::make_shared<Executor::PriorityQueueExecutor>(clock);
+    std::shared_ptr<Scheduler::DeterministicScheduler> scheduler =
+        std::make_shared<Scheduler::DeterministicScheduler>(executor, rng, clock, 0);
+    std::shared_ptr<IO::Network> network = std::make_shared<IO::Network>(clock, rng, 0);
+    std::shared_ptr<System::System> system = std::make_shared<System::System>(scheduler, clock, rng, network);
+};
+
+class InboxNode : public Node::Node {
+public:
+    InboxNode(int id, std::shared_ptr<System::System> sys) : Node::Node(id, sys) {}
+    void dispatch() override { inbox.clear(); }
+    ::Node::Task main_loop() override { std::terminate(); }
+};
+
+// Minimal coroutine that issues one RPC and finishes.
+struct RpcCall {
+    struct promise_type {
+        RpcCall get_return_object() { return RpcCall{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> h;
+    explicit RpcCall(std::coroutine_handle<promise_type> handle) : h(handle) {}
+    RpcCall(RpcCall&& other) noexcept : h(other.h) { other.h = nullptr; }
+    ~RpcCall() { if (h) h.destroy(); }
+};
+
+RpcCall ping(std::shared_ptr<System::System> sys) {
+    auto response = co_await sys->rpc(0, 1, IO::PingRequest{});
+    Bench::do_not_optimize(response->message_id);
+}
+
+IO::Envelope ping_envelope(int id, int from, int to) {
+    return IO::Envelope{id, from, to, IO::PingRequest{}};
+}
+
+Simulation::FuzzInput fixed_input(int nr_nodes, int max_steps) {
+    Simulation::FuzzInput input;
+    input.rng_seed = 42;
+    input.nr_nodes = nr_nodes;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+void executor_benchmarks(Bench::Runner& runner) {
+    // One op = one push and one pop, at a queue depth of up to 1024
+    runner.run("executor/push_pop", [](uint64_t n, Bench::Counters&) {
+        Components c;
+        for (int i = 0; i < 1024; ++i) {
+            c.clock->tick();
+        }
+        uint64_t sum = 0;
+        for (uint64_t done = 0; done < n;) {
+            uint64_t batch = std::min<uint64_t>(1024, n - done);
+            for (uint64_t i = 0; i < batch; ++i) {
+                c.executor->push_task([&sum]() { ++sum; }, (i * 7919) % 1024);
+            }
+            c.executor->run_until_blocked();
+            done += batch;
+        }
+        Bench::do_not_optimize(sum);
+    });
+}
+
+void network_benchmarks(Bench::Runner& runner) {
+    // One op = one message pushed and fetched
+    runner.run("network/push_fetch", [](uint64_t n, Bench::Counters&) {
+        Components c;
+        size_t fetched = 0;
+        for (uint64_t done = 0; done < n;) {
+            uint64_t batch = std::min<uint64_t>(256, n - done);
+            for (uint64_t i = 0; i < batch; ++i) {
+                c.network->push_entry(ping_envelope(static_cast<int>(done + i), 0, 1));
+            }
+            fetched += c.network->fetch_ready().size();
+            done += batch;
+        }
+        Bench::do_not_optimize(fetched);
+    });
+}
+
+// One message of each type, with ids and terms as a long run produces them
+std::vector<IO::Envelope> codec_samples() {
+    IO::Envelope append{48213, 1, 3, IO::AppendEntriesRequest{217, 1}};
+    IO::Envelope ack{48213, 3, 1, IO::AppendEntriesResponse{217}};
+    return {
+        {48210, 0, 2, IO::PingRequest{}},
+        {48210, 2, 0, IO::PingResponse{}},
+        append,
+        ack,
+        {48220, 4, 2, IO::RequestVoteRequest{218, 4}},
+        {48220, 2, 4, IO::RequestVoteResponse{218, true}},
+        {-1931, 0, 1, IO::HeartbeatBatch{{append, ack, append, ack}}},
+    };
+}
+
+void codec_benchmarks(Bench::Runner& runner) {
+    for (const auto& sample : codec_samples()) {
+        std::string name = IO::message_name(sample.type());
+        // One op = one message encoded into a reused buffer
+        runner.run("codec/encode/" + name, [&sample](uint64_t n, Bench::Counters& counters) {
+            std::vector<uint8_t> buffer(256);
+            size_t bytes = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                bytes += IO::encode(sample, buffer);
+            }
+            Bench::do_not_optimize(buffer.data());
+            counters["bytes_per_msg"] = static_cast<double>(bytes) / n;
+        });
+        // One op = one frame decoded in place, without copying batch contents
+        runner.run("codec/decode_view/" + name, [&sample](uint64_t n, Bench::Counters&) {
+            auto frame = IO::encode(sample);
+            int sum = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                auto view = IO::EnvelopeView::decode(frame);
+                sum += view.term() + static_cast<int>(view.batch().size());
+            }
+            Bench::do_not_optimize(sum);
+        });
+        // One op = one frame decoded into an owned Envelope
+        runner.run("codec/decode/" + name, [&sample](uint64_t n, Bench::Counters&) {
+            auto frame = IO::encode(sample);
+            int sum = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                sum += IO::decode(frame).message_id;
+            }
+            Bench::do_not_optimize(sum);
+        });
+    }
+}
+
+void router_benchmarks(Bench::Runner& runner) {
+    // One op = one message routed to its node's inbox and dispatched
+    runner.run("router/route", [](uint64_t n, Bench::Counters&) {
+        Components c;
+        std::vector<std::shared_ptr<Node::Node>> nodes;
+        for (int i = 0; i < 5; ++i) {
+            nodes.push_back(std::make_shared<InboxNode>(i, c.system));
+        }
+        Routing::Router router(nodes, c.network, c.system);
+        for (uint64_t done = 0; done < n;) {
+            uint64_t batch = std::min<uint64_t>(64, n - done);
+            for (uint64_t i = 0; i < batch; ++i) {
+                c.network->push_entry(ping_envelope(static_cast<int>(done + i), 0, (done + i) % 5));
+            }
+            router.route();
+            c.executor->run_until_blocked();
+            done += batch;
+        }
+    });
+}
+
+void rng_benchmarks(Bench::Runner& runner) {
+    runner.run("rng/uniform_draw", [](uint64_t n, Bench::Counters&) {
+        RNG::UniformDistributionRange rng(42);
+        long long sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += rng.draw(0, 100);
+        }
+        Bench::do_not_optimize(sum);
+    });
+    runner.run("rng/byte_stream_draw", [](uint64_t n, Bench::Counters&) {
+        std::vector<uint8_t> bytes(1 << 16);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 131);
+        }
+        long long sum = 0;
+        for (uint64_t done = 0; done < n;) {
+            RNG::ByteStreamRNG rng(bytes, 42);
+            uint64_t batch = std::min<uint64_t>(bytes.size(), n - done);
+            for (uint64_t i = 0; i < batch; ++i) {
+                sum += rng.draw(0, 100);
+            }
+            done += batch;
+        }
+        Bench::do_not_optimize(sum);
+    });
+}
+
+void state_benchmarks(Bench::Runner& runner) {
+    for (int nr_nodes : {3, 5, 7}) {
+        Components c;
+        std::vector<std::shared_ptr<Node::RaftNode>> nodes;
+        for (int i = 0; i < nr_nodes; ++i) {
+            nodes.push_back(std::make_shared<Node::RaftNode>(i, c.system, nr_nodes, 150, 300, 50));
+        }
+        std::string suffix = "/nodes=" + std::to_string(nr_nodes);
+        runner.run("state/capture" + suffix, [&nodes](uint64_t n, Bench::Counters&) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto state = State::ClusterState::capture(nodes);
+                Bench::do_not_optimize(state.nodes.data());
+            }
+        });
+        auto state = State::ClusterState::capture(nodes);
+        runner.run("state/hash" + suffix, [&state](uint64_t n, Bench::Counters&) {
+            size_t h = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                h += state.hash();
+                Bench::do_not_optimize(h);
+            }
+        });
+    }
+}
+
+void system_benchmarks(Bench::Runner& runner) {
+    // One op = request sent, delivered, answered and the caller resumed
+    runner.run("system/rpc_round_trip", [](uint64_t n, Bench::Counters&) {
+        Components c;
+        for (uint64_t i = 0; i < n; ++i) {
+            auto call = ping(c.system);
+            for (auto& request : c.network->fetch_ready()) {
+                c.system->register_rpc_completion(request.message_id,
+                    IO::Envelope{request.message_id, 1, 0, IO::PingResponse{}});
+            }
+            c.executor->run_until_blocked();
+        }
+    });
+}
+
+void simulation_benchmarks(Bench::Runner& runner) {
+    for (int nr_nodes : {3, 5, 7}) {
+        std::string suffix = "/nodes=" + std::to_string(nr_nodes);
+        // One op = one simulated tick of a long-running cluster
+        runner.run("sim/tick" + suffix, [nr_nodes](uint64_t n, Bench::Counters&) {
+            auto input = fixed_input(nr_nodes, 50000);
+            auto ctx = std::make_unique<Simulation::SimulationContext>(input);
+            for (uint64_t i = 0; i < n; ++i) {
+                if (ctx->done()) {
+                    ctx = std::make_unique<Simulation::SimulationContext>(input);
+                }
+                try {
+                    ctx->step();
+                } catch (const std::runtime_error&) {
+                    ctx = std::make_unique<Simulation::SimulationContext>(input);
+                }
+            }
+        });
+        // One op = one complete fuzz execution of 1000 steps, coverage included
+        runner.run("fuzz/exec" + suffix, [nr_nodes](uint64_t n, Bench::Counters& counters) {
+            auto bytes = fixed_input(nr_nodes, 1000).to_bytes();
+            uint64_t steps = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                steps += Simulation::run_simulation(bytes).steps;
+            }
+            counters["steps_per_exec"] = static_cast<double>(steps) / n;
+        });
+    }
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--json=<file>] [--baseline=<file>] [--filter=<substring>]"
+              << " [--min-time-ms=<ms>] [--rounds=<n>]" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// Micro- and macrobenchmarks of the simulator. Results are printed and, with
+// --json, written as a machine-readable report; --baseline compares this run
+// with an earlier report.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+    std::string json_path, baseline_path;
+    for (const auto& arg : rest) {
+        if (arg.rfind("--json=", 0) == 0) {
+            json_path = arg.substr(7);
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baseline_path = arg.substr(11);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    Bench::Runner runner(options);
+    {
+        Simulation::SuppressOutput suppress;
+        executor_benchmarks(runner);
+        network_benchmarks(runner);
+        codec_benchmarks(runner);
+        router_benchmarks(runner);
+        rng_benchmarks(runner);
+        state_benchmarks(runner);
+        system_benchmarks(runner);
+        simulation_benchmarks(runner);
+    }
+
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    if (!baseline_path.empty()) {
+        Bench::print_comparison(runner.results(), Bench::read_baseline(baseline_path));
+    }
+    return 0;
+}
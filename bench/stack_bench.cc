@@ -0,0 +1,111 @@
+#include "bench/benchmark.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> parse_sizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back(std::stoi(item));
+    }
+    return sizes;
+}
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--sizes=3,5,7,1000] [--group-size=5] [--ticks=2000] [--json=<file>]"
+              << std::endl;
+    return 1;
+}
+
+// Ticks of fresh clusters of nr_nodes nodes, from the first tick on (elections
+// included), restarting whenever a run ends.
+template<typename Context>
+void tick_benchmark(Bench::Runner& runner, const std::string& stack, const Simulation::FuzzInput& input,
+                    int nr_nodes, int group_size, int ticks) {
+    // Clusters the fuzzer explores are a single group
+    Simulation::Topology topology{nr_nodes, nr_nodes <= Simulation::FuzzInput::MAX_NODES ? nr_nodes : group_size};
+    runner.run_fixed("stack/" + stack + "/nodes=" + std::to_string(nr_nodes), ticks,
+        [&](uint64_t n, Bench::Counters& counters) {
+            Simulation::SuppressOutput suppress;
+            auto ctx = std::make_unique<Context>(input, nullptr, topology);
+            for (uint64_t i = 0; i < n; ++i) {
+                if (ctx->done()) {
+                    ctx = std::make_unique<Context>(input, nullptr, topology);
+                }
+                ctx->step();
+            }
+            counters["nodes"] = nr_nodes;
+        });
+}
+
+} // namespace
+
+// Simulated ticks per second on the virtual stack (every component behind its
+// interface) against the static stack (concrete components chosen at compile
+// time), for the same inputs.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> rest;
+    Bench::Options options;
+    std::vector<int> sizes = {3, 5, 7, 1000};
+    int group_size = 5, ticks = 2000;
+    std::string json_path;
+    try {
+        options = Bench::parse_options(argc, argv, rest);
+        for (const auto& arg : rest) {
+            if (arg.rfind("--sizes=", 0) == 0) {
+                sizes = parse_sizes(arg.substr(8));
+            } else if (arg.rfind("--group-size=", 0) == 0) {
+                group_size = std::stoi(arg.substr(13));
+            } else if (arg.rfind("--ticks=", 0) == 0) {
+                ticks = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--json=", 0) == 0) {
+                json_path = arg.substr(7);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+
+    Simulation::FuzzInput input;
+    input.rng_seed = 42;
+    input.max_steps = 50000;
+    input.normalize();
+
+    Bench::Runner runner(options);
+    for (int nr_nodes : sizes) {
+        tick_benchmark<Simulation::SimulationContext>(runner, "virtual", input, nr_nodes, group_size, ticks);
+        tick_benchmark<Simulation::StaticSimulationContext>(runner, "static", input, nr_nodes, group_size, ticks);
+    }
+
+    std::map<int, std::pair<double, double>> ticks_per_sec;
+    for (const auto& result : runner.results()) {
+        auto& entry = ticks_per_sec[static_cast<int>(result.counters.at("nodes"))];
+        (result.name.find("/static/") != std::string::npos ? entry.second : entry.first) = result.ops_per_sec;
+    }
+    std::cout << std::endl << "=== Ticks per Second by Stack ===" << std::endl;
+    std::cout << std::setw(8) << "nodes" << std::setw(14) << "virtual" << std::setw(14) << "static"
+              << std::setw(10) << "speedup" << std::endl;
+    for (const auto& [nodes, pair] : ticks_per_sec) {
+        std::cout << std::setw(8) << nodes << std::setw(14) << std::fixed << std::setprecision(0) << pair.first
+                  << std::setw(14) << pair.second << std::setw(9) << std::setprecision(2)
+                  << pair.second / pair.first << "x" << std::endl;
+    }
+    if (!json_path.empty()) {
+        Bench::write_json(runner.results(), json_path);
+        std::cout << "[Bench] Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
@@ -1,6 +1,8 @@
 #ifndef _CLOCK_H_
 #define _CLOCK_H_
 
+#include <chrono>
+
 namespace Clock {
 class Clock {
 public:
@@ -8,7 +10,7 @@ public:
     virtual void tick() = 0;
     virtual ~Clock() = default;
 };
-class DeterministicClock : public Clock {
+class DeterministicClock final : public Clock {
 public:
     void tick() override {time_++;}
     long long int now() override {return time_;}
@@ -17,5 +19,16 @@ public:
 private:
     long long int time_ = 0;
 };
+// Real time, in milliseconds since the clock was created. It moves by itself,
+// so tick() does nothing; used where nodes run outside the simulation.
+class MonotonicClock final : public Clock {
+public:
+    void tick() override {}
+    long long int now() override {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+private:
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
 } // namespace Clock
 #endif // _CLOCK_H_
\ No newline at end of file
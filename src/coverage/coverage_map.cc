@@ -0,0 +1,126 @@
+#include "src/coverage/coverage_map.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Coverage {
+
+namespace {
+
+std::array<uint8_t, 256> make_bucket_table() {
+    std::array<uint8_t, 256> table{};
+    for (int hits = 1; hits < 256; ++hits) {
+        if (hits == 1) table[hits] = 1;
+        else if (hits == 2) table[hits] = 2;
+        else if (hits == 3) table[hits] = 4;
+        else if (hits <= 7) table[hits] = 8;
+        else if (hits <= 15) table[hits] = 16;
+        else if (hits <= 31) table[hits] = 32;
+        else if (hits <= 127) table[hits] = 64;
+        else table[hits] = 128;
+    }
+    return table;
+}
+
+const std::array<uint8_t, 256> BUCKETS = make_bucket_table();
+
+// True if block has a bit set that seen lacks.
+inline bool has_new_bits(const uint8_t* block, const uint8_t* seen) {
+#if defined(__SSE2__)
+    __m128i run = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i known = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seen));
+    __m128i fresh = _mm_andnot_si128(known, run);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(fresh, _mm_setzero_si128())) != 0xFFFF;
+#else
+    uint64_t run[2], known[2];
+    std::memcpy(run, block, sizeof(run));
+    std::memcpy(known, seen, sizeof(known));
+    return ((run[0] & ~known[0]) | (run[1] & ~known[1])) != 0;
+#endif
+}
+
+} // namespace
+
+uint32_t slot_of(size_t state_hash) {
+    // State hashes are xor/rotate combinations, so mix before truncating
+    uint64_t mixed = static_cast<uint64_t>(state_hash) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(mixed >> (64 - MAP_SIZE_POW2));
+}
+
+CoverageMap::CoverageMap() : counters_(MAP_SIZE, 0) {}
+
+void CoverageMap::record(size_t state_hash) {
+    uint32_t slot = slot_of(state_hash);
+    uint8_t& counter = counters_[slot];
+    if (counter == 0) {
+        touched_.push_back(slot);
+    }
+    if (counter < 255) {
+        ++counter;
+    }
+}
+
+void CoverageMap::set(uint32_t slot, uint8_t value) {
+    uint8_t& counter = counters_[slot];
+    if (counter == 0 && value != 0) {
+        touched_.push_back(slot);
+    }
+    counter = value;
+}
+
+void CoverageMap::classify() {
+    for (uint32_t slot : touched_) {
+        counters_[slot] = BUCKETS[counters_[slot]];
+    }
+}
+
+void CoverageMap::clear() {
+    for (uint32_t slot : touched_) {
+        counters_[slot] = 0;
+    }
+    touched_.clear();
+}
+
+GlobalCoverage::GlobalCoverage() : seen_(MAP_SIZE, 0) {}
+
+Novelty GlobalCoverage::merge(const CoverageMap& run, size_t begin, size_t end, std::vector<uint64_t>* changed) {
+    constexpr size_t BLOCK = 16;
+    const uint8_t* bits = run.data();
+    Novelty novelty = Novelty::None;
+    for (size_t block = begin; block < end; block += BLOCK) {
+        size_t block_end = std::min(block + BLOCK, end);
+        if (block_end - block == BLOCK && !has_new_bits(bits + block, seen_.data() + block)) {
+            continue;
+        }
+        for (size_t slot = block; slot < block_end; ++slot) {
+            uint8_t fresh = bits[slot] & ~seen_[slot];
+            if (fresh == 0) {
+                continue;
+            }
+            if (seen_[slot] == 0) {
+                covered_.fetch_add(1, std::memory_order_relaxed);
+                novelty = Novelty::NewStates;
+            } else if (novelty == Novelty::None) {
+                novelty = Novelty::NewHitCounts;
+            }
+            seen_[slot] |= fresh;
+            if (changed) {
+                changed->push_back(static_cast<uint64_t>(slot) << 8 | fresh);
+            }
+        }
+    }
+    return novelty;
+}
+
+void GlobalCoverage::restore(uint64_t record) {
+    uint32_t slot = static_cast<uint32_t>(record >> 8) % MAP_SIZE;
+    if (seen_[slot] == 0) {
+        covered_.fetch_add(1, std::memory_order_relaxed);
+    }
+    seen_[slot] |= static_cast<uint8_t>(record & 0xFF);
+}
+
+} // namespace Coverage
@@ -0,0 +1,81 @@
+#ifndef _COVERAGE_MAP_H_
+#define _COVERAGE_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Coverage {
+
+// Cluster states are folded into a fixed number of slots, AFL style: memory
+// and merge cost stay the same however many states a campaign has seen, at
+// the price of the odd collision.
+constexpr size_t MAP_SIZE_POW2 = 20;
+constexpr size_t MAP_SIZE = size_t(1) << MAP_SIZE_POW2;
+
+// Slot a state hash lands in.
+uint32_t slot_of(size_t state_hash);
+
+// States one run visited: a saturating 8-bit hit counter per slot, plus the
+// list of slots touched so that walking and clearing a run is proportional to
+// what it visited rather than to MAP_SIZE.
+class CoverageMap {
+private:
+    std::vector<uint8_t> counters_;
+    std::vector<uint32_t> touched_;
+public:
+    CoverageMap();
+
+    void record(size_t state_hash);
+    // Sets a slot's counter directly (e.g. from a serialized map).
+    void set(uint32_t slot, uint8_t value);
+    // Replaces each hit count with its AFL bucket bit: 1, 2, 3, 4-7, 8-15,
+    // 16-31, 32-127 and 128+ hits map to bits 0 to 7. Done once, before merging.
+    void classify();
+    void clear();
+
+    // Slots with a non-zero counter, in the order they were first hit.
+    const std::vector<uint32_t>& slots() const { return touched_; }
+    size_t count() const { return touched_.size(); }
+    uint8_t at(uint32_t slot) const { return counters_[slot]; }
+    const uint8_t* data() const { return counters_.data(); }
+
+    bool operator==(const CoverageMap& other) const { return counters_ == other.counters_; }
+    bool operator!=(const CoverageMap& other) const { return !(*this == other); }
+};
+
+enum class Novelty {
+    None,
+    // Only known slots, but some with a hit-count bucket not seen before
+    NewHitCounts,
+    NewStates,
+};
+
+// Union of the classified maps of every run so far. Thread safe as long as
+// concurrent merges cover disjoint ranges.
+class GlobalCoverage {
+private:
+    std::vector<uint8_t> seen_;
+    std::atomic<size_t> covered_{0};
+public:
+    GlobalCoverage();
+
+    // ORs the classified run into the union over slots [begin, end), and
+    // reports what it added. Clean 16-byte blocks are skipped with one SIMD
+    // compare, so the cost depends on the range, not on the run. Every slot
+    // that changed is appended to changed (when given) as slot << 8 | new bits.
+    Novelty merge(const CoverageMap& run, size_t begin = 0, size_t end = MAP_SIZE,
+                  std::vector<uint64_t>* changed = nullptr);
+    // Restores a record produced by merge (used when resuming a campaign).
+    void restore(uint64_t record);
+
+    bool covers(size_t state_hash) const { return seen_[slot_of(state_hash)] != 0; }
+    uint8_t at(uint32_t slot) const { return seen_[slot]; }
+    // Slots any run has hit.
+    size_t covered() const { return covered_.load(std::memory_order_relaxed); }
+};
+
+} // namespace Coverage
+
+#endif // _COVERAGE_MAP_H_
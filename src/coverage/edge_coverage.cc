@@ -0,0 +1,218 @@
+#include "src/coverage/edge_coverage.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <memory>
+#include <sstream>
+
+// Provided by the sanitizer runtimes (libFuzzer, ASan...) when one is linked in
+extern "C" void __sanitizer_symbolize_pc(void* pc, const char* fmt, char* out_buf, size_t out_buf_size)
+    __attribute__((weak));
+
+namespace Coverage {
+
+namespace {
+
+// The guards of one instrumented module (the executable, each shared
+// library). Edge ids are global: first + index of the guard in the module.
+struct Module {
+    uint32_t first;
+    uint32_t count;
+    // (pc, flags) per guard, from pc-table; flags bit 0 marks a function entry
+    const uintptr_t* pcs = nullptr;
+};
+
+// Modules are registered from their constructors, possibly before this
+// file's dynamic initializers ran: only constant-initialized globals here.
+std::vector<Module>* modules = nullptr;
+std::atomic<uint8_t>* seen = nullptr;
+uint32_t nr_edges = 0;
+std::atomic<size_t> nr_hit{0};
+
+thread_local CoverageMap* feedback = nullptr;
+
+std::string hex(uintptr_t value) {
+    std::stringstream stream;
+    stream << "0x" << std::hex << value;
+    return stream.str();
+}
+
+std::string symbolize(uintptr_t pc, const char* format) {
+    char buffer[1024] = {0};
+    __sanitizer_symbolize_pc(reinterpret_cast<void*>(pc), format, buffer, sizeof(buffer));
+    return buffer;
+}
+
+std::string function_name(uintptr_t pc) {
+    if (__sanitizer_symbolize_pc) {
+        return symbolize(pc, "%f");
+    }
+    // Executables need -rdynamic for their symbols to be found (--config=edges links with it)
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(pc), &info) && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+    return hex(pc);
+}
+
+std::string edge_location(uintptr_t pc, uintptr_t function_pc) {
+    if (__sanitizer_symbolize_pc) {
+        return symbolize(pc, "%L");
+    }
+    return "+" + hex(pc - function_pc);
+}
+
+} // namespace
+
+size_t edge_count() {
+    return nr_edges;
+}
+
+size_t edges_hit() {
+    return nr_hit.load(std::memory_order_relaxed);
+}
+
+bool edge_hit(size_t edge) {
+    return edge < nr_edges && seen[edge].load(std::memory_order_relaxed) != 0;
+}
+
+size_t edge_hash(size_t edge) {
+    return (edge + 1) * 0xD6E8FEB86659FD93ULL ^ 0x45444745ULL;
+}
+
+ScopedEdgeFeedback::ScopedEdgeFeedback(CoverageMap* map) : previous_(feedback) {
+    feedback = map;
+}
+
+ScopedEdgeFeedback::~ScopedEdgeFeedback() {
+    feedback = previous_;
+}
+
+std::vector<ColdFunction> cold_functions(const std::string& filter) {
+    std::vector<ColdFunction> cold;
+    if (!modules) {
+        return cold;
+    }
+    for (const Module& module : *modules) {
+        if (!module.pcs) {
+            continue;
+        }
+        ColdFunction function;
+        uintptr_t function_pc = 0;
+        auto flush = [&]() {
+            if (function.cold > 0 && function.name.find(filter) != std::string::npos) {
+                cold.push_back(std::move(function));
+            }
+            function = ColdFunction{};
+        };
+        for (uint32_t i = 0; i < module.count; ++i) {
+            uintptr_t pc = module.pcs[2 * i];
+            if (module.pcs[2 * i + 1] & 1) {
+                flush();
+                function_pc = pc;
+                function.name = function_name(pc);
+            }
+            ++function.edges;
+            if (!edge_hit(module.first + i)) {
+                ++function.cold;
+                function.locations.push_back(edge_location(pc, function_pc));
+            }
+        }
+        flush();
+    }
+    std::stable_sort(cold.begin(), cold.end(),
+                     [](const ColdFunction& a, const ColdFunction& b) { return a.cold > b.cold; });
+    return cold;
+}
+
+std::string describe_cold_functions(const std::string& filter, size_t max_locations) {
+    std::stringstream out;
+    if (edge_count() == 0) {
+        out << "No edge coverage in this build (bazel build --config=edges)" << std::endl;
+        return out.str();
+    }
+    bool tables = false;
+    for (const Module& module : *modules) {
+        tables = tables || module.pcs;
+    }
+    out << edges_hit() << " of " << edge_count() << " edges taken" << std::endl;
+    if (!tables) {
+        out << "No PC table to name the cold edges with (build with -fsanitize-coverage=trace-pc-guard,pc-table)"
+            << std::endl;
+        return out.str();
+    }
+    auto cold = cold_functions(filter);
+    out << cold.size() << " functions matching \"" << filter << "\" have cold edges" << std::endl;
+    for (const auto& function : cold) {
+        out << "  " << function.cold << "/" << function.edges << " cold  " << function.name << std::endl;
+        for (size_t i = 0; i < function.locations.size() && i < max_locations; ++i) {
+            out << "      " << function.locations[i] << std::endl;
+        }
+        if (function.locations.size() > max_locations) {
+            out << "      ... " << function.locations.size() - max_locations << " more" << std::endl;
+        }
+    }
+    return out.str();
+}
+
+} // namespace Coverage
+
+// The compiler's hooks. Weak, so that an engine bringing its own (libFuzzer)
+// takes precedence in the binaries that link it.
+extern "C" __attribute__((weak)) void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop) {
+    using namespace Coverage;
+    // Called once per module, possibly more than once for the same guards
+    if (start == stop || *start != 0) {
+        return;
+    }
+    if (!modules) {
+        modules = new std::vector<Module>();
+    }
+    uint32_t first = nr_edges;
+    for (uint32_t* guard = start; guard < stop; ++guard) {
+        *guard = ++nr_edges;
+    }
+    modules->push_back(Module{first, nr_edges - first});
+    auto* grown = new std::atomic<uint8_t>[nr_edges];
+    for (uint32_t edge = 0; edge < nr_edges; ++edge) {
+        grown[edge].store(edge < first ? seen[edge].load() : 0);
+    }
+    delete[] seen;
+    seen = grown;
+}
+
+extern "C" __attribute__((weak)) void __sanitizer_cov_pcs_init(const uintptr_t* pcs_begin, const uintptr_t* pcs_end) {
+    using namespace Coverage;
+    // Each module registers its guards, then its PCs
+    if (!modules) {
+        return;
+    }
+    uint32_t count = static_cast<uint32_t>((pcs_end - pcs_begin) / 2);
+    for (Module& module : *modules) {
+        if (!module.pcs && module.count == count) {
+            module.pcs = pcs_begin;
+            return;
+        }
+    }
+}
+
+extern "C" __attribute__((weak)) void __sanitizer_cov_trace_pc_guard(uint32_t* guard) {
+    using namespace Coverage;
+    uint32_t id = *guard;
+    if (id == 0) {
+        return;
+    }
+    std::atomic<uint8_t>& hit = seen[id - 1];
+    if (hit.load(std::memory_order_relaxed) == 0 && hit.exchange(1, std::memory_order_relaxed) == 0) {
+        nr_hit.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (CoverageMap* map = feedback) {
+        map->record(edge_hash(id - 1));
+    }
+}
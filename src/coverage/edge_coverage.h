@@ -0,0 +1,59 @@
+#ifndef _EDGE_COVERAGE_H_
+#define _EDGE_COVERAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "src/coverage/coverage_map.h"
+
+namespace Coverage {
+
+// Code edges, for binaries built with -fsanitize-coverage=trace-pc-guard,pc-table
+// (bazel build --config=edges). The compiler gives every edge a guard and
+// calls back into this file each time one is taken; each edge is then
+// recorded in the thread's run map as one more "state", so a run that takes
+// a new branch in a handler is new coverage even if it reaches no new
+// cluster state. In a regular build there are no edges and all of this is a
+// no-op.
+
+// Edges instrumented in the binary (0 unless built with edge coverage)
+size_t edge_count();
+// Edges taken by anything in the process so far
+size_t edges_hit();
+bool edge_hit(size_t edge);
+// What an edge is recorded under in a CoverageMap; salted away from the
+// cluster state hashes, up to slot collisions.
+size_t edge_hash(size_t edge);
+
+// Routes the edges this thread takes into map while in scope. Scopes nest;
+// the previous map is restored on exit.
+class ScopedEdgeFeedback {
+private:
+    CoverageMap* previous_;
+public:
+    explicit ScopedEdgeFeedback(CoverageMap* map);
+    ~ScopedEdgeFeedback();
+    ScopedEdgeFeedback(const ScopedEdgeFeedback&) = delete;
+    ScopedEdgeFeedback& operator=(const ScopedEdgeFeedback&) = delete;
+};
+
+// A function with edges never taken.
+struct ColdFunction {
+    std::string name;
+    size_t edges = 0;
+    size_t cold = 0;
+    // Where the cold edges are: file:line when the binary links a sanitizer
+    // symbolizer, the offset into the function otherwise
+    std::vector<std::string> locations;
+};
+
+// Instrumented functions whose name contains filter and that have edges no
+// one took, the coldest first (functions never entered included).
+std::vector<ColdFunction> cold_functions(const std::string& filter);
+// cold_functions as a report, listing at most max_locations edges per function
+std::string describe_cold_functions(const std::string& filter, size_t max_locations = 8);
+
+} // namespace Coverage
+
+#endif // _EDGE_COVERAGE_H_
@@ -2,6 +2,8 @@
 #define _EXECUTOR_H_
 
 #include "src/clock/clock.h"
+#include "src/log/log.h"
+#include "src/trace/event.h"
 #include <functional>
 #include <memory>
 #include <tuple>
@@ -9,9 +11,14 @@
 
 namespace Executor {
 
+// Owner of work no node has claimed
+constexpr int NO_OWNER = -1;
+
 struct PendingTask {
 public:
     long long int time, id;
+    // Node the task runs on behalf of, for tracing only
+    int owner = NO_OWNER;
     std::function<void()> task;
     bool operator<(const PendingTask& other) const {
         return std::make_tuple(time, id) > std::make_tuple(other.time, other.id);
@@ -22,22 +29,76 @@ class Executor {
 public:
     virtual ~Executor() = default;
     virtual void push_task(std::function<void()> task, long long int time) = 0;
+    // Same, for work started on behalf of node `owner`. Executors that track
+    // owners give tasks pushed by a running task that task's owner.
+    virtual void push_task_for(int owner, std::function<void()> task, long long int time) {
+        (void)owner;
+        push_task(std::move(task), time);
+    }
     virtual void run_until_blocked() = 0;
 };
 
-class PriorityQueueExecutor : public Executor {
+// ClockT is the clock type the executor holds: the Clock::Clock interface,
+// or a concrete (final) clock so that now() is resolved at compile time.
+template<typename ClockT>
+class BasicPriorityQueueExecutor final : public Executor {
 public:
-    void push_task(std::function<void()> task, long long int time) override;
+    void push_task(std::function<void()> task, long long int time) override {
+        push_task_for(current_owner_, std::move(task), time);
+    }
+    void push_task_for(int owner, std::function<void()> task, long long int time) override {
+        tasks_.push(PendingTask{
+            .time = time,
+            .id = task_counter_++,
+            .owner = owner,
+            .task = std::move(task)
+        });
+    }
     void run_until_blocked() override;
-    bool has_work();
-    PriorityQueueExecutor(std::shared_ptr<Clock::Clock> clk);
-    ~PriorityQueueExecutor() = default;
+    bool has_work() const { return !tasks_.empty(); }
+    size_t pending() const { return tasks_.size(); }
+    // When the earliest task is due; only meaningful if has_work().
+    long long int next_time() const { return tasks_.top().time; }
+    size_t tasks_run() const { return tasks_run_; }
+    // Reports every task pop to sink (nullptr to stop).
+    void set_event_sink(Trace::EventSink* sink) { sink_ = sink; }
+    BasicPriorityQueueExecutor(std::shared_ptr<ClockT> clk) : clock_(std::move(clk)), task_counter_(0) {}
+    ~BasicPriorityQueueExecutor() = default;
 private:
     std::priority_queue<PendingTask> tasks_;
-    std::shared_ptr<Clock::Clock> clock_;
+    std::shared_ptr<ClockT> clock_;
     long long int task_counter_;
+    // Owner of the task being run
+    int current_owner_ = NO_OWNER;
+    size_t tasks_run_ = 0;
+    Trace::EventSink* sink_ = nullptr;
 };
 
+template<typename ClockT>
+void BasicPriorityQueueExecutor<ClockT>::run_until_blocked() {
+    while(true) {
+        if (tasks_.empty()) {
+            break;
+        }
+        auto front_task = tasks_.top();
+        if (front_task.time > clock_->now()) {
+            break;
+        }
+        Log::out() << "[Executor] Pulled task at instant " << clock_->now() << std::endl;
+        tasks_.pop();
+        if (sink_) {
+            sink_->on_event(Trace::Event{Trace::EventKind::TaskPop, clock_->now(), front_task.id, front_task.time,
+                                         front_task.owner});
+        }
+        current_owner_ = front_task.owner;
+        ++tasks_run_;
+        front_task.task();
+        current_owner_ = NO_OWNER;
+    }
+}
+
+using PriorityQueueExecutor = BasicPriorityQueueExecutor<Clock::Clock>;
+
 } // namespace Executor
 
 #endif // _EXECUTOR_H_
\ No newline at end of file
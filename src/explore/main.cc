@@ -0,0 +1,71 @@
+#include "src/explore/model_checker.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " [--nodes=N] [--depth=N] [--time=T] [--election-timeout=MIN[-MAX]]"
+              << " [--heartbeat=N] [--seed=N] [--max-transitions=N] [--no-reduction] [--no-dedup]" << std::endl;
+    std::cout << "  --nodes             cluster size (default 3)" << std::endl;
+    std::cout << "  --depth             actions along one execution (default 40)" << std::endl;
+    std::cout << "  --time              last tick the clock may reach (default 30)" << std::endl;
+    std::cout << "  --election-timeout  ticks before a follower stands (default 20)" << std::endl;
+    std::cout << "  --heartbeat         leader heartbeat interval (default 10)" << std::endl;
+    std::cout << "  --seed              seed of the nodes' timeout draws when MIN < MAX" << std::endl;
+    std::cout << "  --max-transitions   give up after this many actions (default: never)" << std::endl;
+    std::cout << "  --no-reduction      try every interleaving, not one per partial order" << std::endl;
+    std::cout << "  --no-dedup          expand states even if an equal one was expanded" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Explore::ModelConfig config;
+    Explore::ExploreBounds bounds;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--nodes=", 0) == 0) {
+                config.nr_nodes = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--depth=", 0) == 0) {
+                bounds.max_depth = std::stoi(arg.substr(8));
+            } else if (arg.rfind("--time=", 0) == 0) {
+                bounds.max_time = std::stoll(arg.substr(7));
+            } else if (arg.rfind("--election-timeout=", 0) == 0) {
+                std::string range = arg.substr(19);
+                size_t dash = range.find('-');
+                config.election_timeout_min = std::stoi(range.substr(0, dash));
+                config.election_timeout_max =
+                    dash == std::string::npos ? config.election_timeout_min : std::stoi(range.substr(dash + 1));
+            } else if (arg.rfind("--heartbeat=", 0) == 0) {
+                config.heartbeat_interval = std::stoi(arg.substr(12));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                config.rng_seed = std::stoul(arg.substr(7));
+            } else if (arg.rfind("--max-transitions=", 0) == 0) {
+                bounds.max_transitions = std::stoull(arg.substr(18));
+            } else if (arg == "--no-reduction") {
+                bounds.reduction = false;
+            } else if (arg == "--no-dedup") {
+                bounds.dedup = false;
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+    if (config.nr_nodes < 1 || bounds.max_depth < 1 || config.election_timeout_min > config.election_timeout_max) {
+        return usage(argv[0]);
+    }
+
+    std::cout << "[Explore] " << config.nr_nodes << " nodes, depth " << bounds.max_depth << ", time "
+              << bounds.max_time << (bounds.reduction ? ", DPOR" : "") << (bounds.dedup ? ", dedup" : "")
+              << std::endl;
+    auto result = Explore::explore(config, bounds);
+    std::cout << "[Explore] " << result.describe() << std::endl;
+    return result.violation.empty() ? 0 : 2;
+}
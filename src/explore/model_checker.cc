@@ -0,0 +1,730 @@
+#include "src/explore/model_checker.h"
+#include "src/clock/clock.h"
+#include "src/io/codec.h"
+#include "src/io/messages.h"
+#include "src/log/log.h"
+#include "src/memory/memory.h"
+#include "src/node/node_table.h"
+#include "src/node/raft_node_impl.h"
+#include "src/node/state.h"
+#include "src/oracle/oracle.h"
+#include "src/rng/rng.h"
+#include "src/scheduler/scheduler.h"
+#include "src/system/system.h"
+#include <algorithm>
+#include <chrono>
+#include <compare>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Explore {
+
+namespace {
+
+class World;
+class ChoiceScheduler;
+class ChoiceNetwork;
+
+// The components a node of an explored cluster holds. There is no executor:
+// the World keeps the pending tasks, and the search picks which one runs.
+struct ChoiceStack {
+    using Clock = ::Clock::DeterministicClock;
+    using RNG = ::RNG::SplitMixRNG;
+    using Scheduler = ChoiceScheduler;
+    using Network = ChoiceNetwork;
+};
+
+enum class ActionKind { Task, Delivery, Tick };
+
+// Names an action the same way in every execution that reaches it, whatever
+// ran in between on other nodes: a message by its sender and the order that
+// sender sent it in (only that sender's tasks send), a task by the action
+// that created it and the order it was created in there.
+struct ActionId {
+    ActionKind kind;
+    // The node the action runs on or is delivered to; -1 for a clock advance
+    int node;
+    // Delivery: the sender. Task: digest of the creating action's id, 0 for
+    // the main loops started with the cluster
+    uint64_t origin;
+    uint32_t index;
+
+    auto operator<=>(const ActionId& other) const = default;
+};
+
+// An enabled action and the events (indices along the current execution,
+// -1 for none) it owes its existence to.
+struct Action {
+    ActionId id;
+    int created_by = -1;
+    int enabled_by = -1;
+};
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+uint64_t digest(const ActionId& id) {
+    uint64_t h = mix(static_cast<uint64_t>(id.kind) + 1, static_cast<uint64_t>(id.node));
+    return mix(mix(h, id.origin), id.index);
+}
+
+uint64_t digest(const IO::Envelope& msg) {
+    uint64_t h = 0;
+    for (uint8_t byte : IO::encode(msg)) {
+        h = mix(h, byte);
+    }
+    return h;
+}
+
+// A node's scheduler: tasks go to the World as pending actions of that node.
+class ChoiceScheduler final : public Scheduler::Scheduler {
+private:
+    World* world_;
+    int node_;
+public:
+    ChoiceScheduler(World* world, int node) : world_(world), node_(node) {}
+    void schedule_task(std::function<void()> task) override;
+    void schedule_task_with_delay(std::function<void()> task, int delay) override;
+    void schedule_task_for(int owner, std::function<void()> task) override;
+};
+
+// A node's network endpoint: sends go to the World as messages in flight.
+class ChoiceNetwork {
+private:
+    World* world_;
+    int node_;
+public:
+    ChoiceNetwork(World* world, int node) : world_(world), node_(node) {}
+    void push_entry(IO::Envelope msg);
+};
+
+// One explored cluster, driven an action at a time.
+class World {
+public:
+    using RaftNodeType = Node::BasicRaftNode<ChoiceStack>;
+private:
+    // What a task resumes, for the signature: a main loop starting, a main
+    // loop waking from its sleep (the only tasks a task creates), or, for the
+    // task a delivery creates, the digest of the message: the handler started
+    // on a request, or the RPC a response resumes
+    static constexpr uint64_t START = 0;
+    static constexpr uint64_t TIMER = 1;
+    struct PendingTask {
+        Action action;
+        long long due;
+        std::function<void()> run;
+        uint64_t resumes;
+    };
+    struct InFlight {
+        Action action;
+        IO::Envelope envelope;
+    };
+
+    long long max_time_;
+    bool forge_votes_;
+    bool random_timeouts_;
+    Memory::RunMemory memory_;
+    std::shared_ptr<Clock::DeterministicClock> clock_;
+    std::shared_ptr<Node::NodeTable> table_;
+    std::vector<std::shared_ptr<RNG::SplitMixRNG>> rngs_;
+    std::vector<std::shared_ptr<System::BasicSystem<ChoiceStack>>> systems_;
+    std::vector<std::shared_ptr<RaftNodeType>> nodes_;
+    std::shared_ptr<Oracle::RaftOracle> oracle_;
+    std::vector<PendingTask> tasks_;
+    std::vector<InFlight> in_flight_;
+    std::vector<uint32_t> messages_sent_;
+    // Digest of every request sent, by sender << 32 | message id: what the
+    // frame suspended on that RPC was called with
+    std::unordered_map<uint64_t, uint64_t> requests_;
+    // The event being executed: its index, its action's digest, the tasks
+    // it created so far, and what those resume
+    int event_ = -1;
+    uint64_t origin_ = 0;
+    uint32_t tasks_created_ = 0;
+    uint64_t resumes_ = START;
+
+    // Earliest due time after now, -1 if no task is due later
+    long long next_due() const {
+        long long now = clock_->now();
+        long long next = -1;
+        for (const auto& task : tasks_) {
+            if (task.due > now) {
+                next = next < 0 ? task.due : std::min(next, task.due);
+            }
+        }
+        return next;
+    }
+public:
+    World(const ModelConfig& config, long long max_time)
+        : max_time_(max_time),
+          forge_votes_(config.forge_votes),
+          random_timeouts_(config.election_timeout_min != config.election_timeout_max),
+          clock_(std::make_shared<Clock::DeterministicClock>()),
+          table_(std::make_shared<Node::NodeTable>(config.nr_nodes)),
+          messages_sent_(config.nr_nodes) {
+        Memory::ScopedRun run(&memory_);
+        for (int i = 0; i < config.nr_nodes; ++i) {
+            auto rng = std::make_shared<RNG::SplitMixRNG>(
+                (static_cast<uint64_t>(config.rng_seed) << 32 | static_cast<uint32_t>(i)) * 0x9e3779b97f4a7c15ULL);
+            rngs_.push_back(rng);
+            auto system = std::make_shared<System::BasicSystem<ChoiceStack>>(
+                std::make_shared<ChoiceScheduler>(this, i), clock_, rng, std::make_shared<ChoiceNetwork>(this, i));
+            auto node = std::make_shared<RaftNodeType>(i, system, config.nr_nodes, config.election_timeout_min,
+                                                       config.election_timeout_max, config.heartbeat_interval, table_);
+            systems_.push_back(system);
+            nodes_.push_back(node);
+            auto main_loop = node->main_loop();
+            system->request_work_for(i, [main_loop]() { main_loop.h_.resume(); });
+        }
+        oracle_ = std::make_shared<Oracle::RaftOracle>(nodes_);
+    }
+
+    ~World() {
+        // Nothing may resume the frames once they are gone
+        tasks_.clear();
+        for (auto& system : systems_) {
+            system->suspended_rpcs.clear();
+            system->responses.clear();
+        }
+        memory_.destroy_frames();
+    }
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    void add_task(int node, std::function<void()> run, int delay) {
+        ActionId id{ActionKind::Task, node, origin_, tasks_created_++};
+        tasks_.push_back(PendingTask{Action{id, event_, -1}, clock_->now() + delay, std::move(run), resumes_});
+    }
+
+    void send(int node, IO::Envelope msg) {
+        if (auto* vote = std::get_if<IO::RequestVoteResponse>(&msg.content); vote && forge_votes_) {
+            vote->vote_granted = true;
+        }
+        ActionId id{ActionKind::Delivery, msg.to, static_cast<uint64_t>(node), messages_sent_[node]++};
+        if (IO::is_request(msg.type())) {
+            requests_[static_cast<uint64_t>(node) << 32 | static_cast<uint32_t>(msg.message_id)] = digest(msg);
+        }
+        in_flight_.push_back(InFlight{Action{id, event_, -1}, std::move(msg)});
+    }
+
+    // Sorted by id, so the search tries them in the same order every replay
+    std::vector<Action> enabled() const {
+        std::vector<Action> actions;
+        long long now = clock_->now();
+        for (const auto& task : tasks_) {
+            if (task.due <= now) {
+                actions.push_back(task.action);
+            }
+        }
+        for (const auto& message : in_flight_) {
+            actions.push_back(message.action);
+        }
+        long long next = next_due();
+        if (next >= 0 && next <= max_time_) {
+            actions.push_back(Action{ActionId{ActionKind::Tick, -1, 0, static_cast<uint32_t>(next)}});
+        }
+        std::sort(actions.begin(), actions.end(),
+                  [](const Action& a, const Action& b) { return a.id < b.id; });
+        return actions;
+    }
+
+    // Runs action as event number event. Throws whatever the oracle throws
+    // on the state it leads to.
+    void execute(const ActionId& action, int event) {
+        Memory::ScopedRun run(&memory_);
+        event_ = event;
+        origin_ = digest(action);
+        tasks_created_ = 0;
+        switch (action.kind) {
+            case ActionKind::Task: {
+                auto it = std::find_if(tasks_.begin(), tasks_.end(),
+                                       [&](const PendingTask& task) { return task.action.id == action; });
+                if (it == tasks_.end()) {
+                    throw std::logic_error("Replayed a task that is not pending");
+                }
+                auto task = std::move(it->run);
+                tasks_.erase(it);
+                resumes_ = TIMER;
+                task();
+                break;
+            }
+            case ActionKind::Delivery: {
+                auto it = std::find_if(in_flight_.begin(), in_flight_.end(),
+                                       [&](const InFlight& message) { return message.action.id == action; });
+                if (it == in_flight_.end()) {
+                    throw std::logic_error("Replayed a message that is not in flight");
+                }
+                IO::Envelope msg = std::move(it->envelope);
+                in_flight_.erase(it);
+                resumes_ = digest(msg);
+                auto& node = nodes_[msg.to];
+                node->inbox.push_back(std::move(msg));
+                node->dispatch();
+                break;
+            }
+            case ActionKind::Tick: {
+                long long next = next_due();
+                while (clock_->now() < next) {
+                    clock_->tick();
+                }
+                for (auto& task : tasks_) {
+                    if (task.due == next) {
+                        task.action.enabled_by = event;
+                    }
+                }
+                break;
+            }
+        }
+        event_ = -1;
+        origin_ = 0;
+        tasks_created_ = 0;
+        resumes_ = START;
+        oracle_->enforce_invariants();
+        table_->clear_changed();
+    }
+
+    std::string describe(const ActionId& action) const {
+        std::ostringstream out;
+        out << "t=" << clock_->now() << ": ";
+        switch (action.kind) {
+            case ActionKind::Task:
+                out << "node " << action.node << " runs a task";
+                break;
+            case ActionKind::Delivery: {
+                auto it = std::find_if(in_flight_.begin(), in_flight_.end(),
+                                       [&](const InFlight& message) { return message.action.id == action; });
+                out << "node " << action.node << " receives "
+                    << (it != in_flight_.end() ? IO::message_name(it->envelope.type()) : "a message")
+                    << " #" << action.index << " from node " << action.origin;
+                break;
+            }
+            case ActionKind::Tick:
+                out << "clock advances to " << next_due();
+                break;
+        }
+        return out.str();
+    }
+
+    const std::vector<std::shared_ptr<RaftNodeType>>& nodes() const { return nodes_; }
+
+    // What states are told apart by when deduplicating: everything the
+    // executions going on from a state depend on (see ExploreBounds::dedup)
+    uint64_t signature() const {
+        uint64_t h = State::ClusterState::capture(nodes_).hash();
+        long long now = clock_->now();
+        h = mix(h, now);
+        for (size_t i = 0; i < systems_.size(); ++i) {
+            const auto& system = systems_[i];
+            h = mix(h, system->message_id_);
+            h = mix(h, table_->last_heartbeat(static_cast<int>(i)));
+            // With fixed timeouts every draw is the same, however many were made
+            if (random_timeouts_) {
+                h = mix(h, rngs_[i]->state());
+            }
+            // Each RPC still open: the request its frame waits on, and the
+            // response it is about to resume with, if any
+            std::vector<std::pair<int, uint64_t>> open;
+            for (const auto& [id, handle] : system->suspended_rpcs) {
+                open.emplace_back(id, 0);
+            }
+            for (const auto& [id, response] : system->responses) {
+                open.emplace_back(id, response ? digest(*response) : 1);
+            }
+            std::sort(open.begin(), open.end());
+            for (const auto& [id, response] : open) {
+                uint64_t key = static_cast<uint64_t>(i) << 32 | static_cast<uint32_t>(id);
+                h = mix(mix(mix(h, id), requests_.at(key)), response);
+            }
+        }
+        std::vector<std::pair<long long, int>> leaders(oracle_->leaders().begin(), oracle_->leaders().end());
+        std::sort(leaders.begin(), leaders.end());
+        for (const auto& [term, leader] : leaders) {
+            h = mix(mix(h, term), leader);
+        }
+        std::vector<std::tuple<int, uint64_t, long long>> tasks;
+        for (const auto& task : tasks_) {
+            tasks.emplace_back(task.action.id.node, task.resumes, task.due - now);
+        }
+        std::sort(tasks.begin(), tasks.end());
+        for (const auto& [node, resumes, due] : tasks) {
+            h = mix(mix(mix(h, node), resumes), due);
+        }
+        std::vector<uint64_t> messages;
+        for (const auto& message : in_flight_) {
+            messages.push_back(digest(message.envelope));
+        }
+        std::sort(messages.begin(), messages.end());
+        for (uint64_t m : messages) {
+            h = mix(h, m);
+        }
+        return h;
+    }
+};
+
+void ChoiceScheduler::schedule_task(std::function<void()> task) {
+    world_->add_task(node_, std::move(task), 0);
+}
+
+void ChoiceScheduler::schedule_task_with_delay(std::function<void()> task, int delay) {
+    world_->add_task(node_, std::move(task), delay);
+}
+
+void ChoiceScheduler::schedule_task_for(int owner, std::function<void()> task) {
+    world_->add_task(owner, std::move(task), 0);
+}
+
+void ChoiceNetwork::push_entry(IO::Envelope msg) {
+    world_->send(node_, std::move(msg));
+}
+
+// Events happening before an event, as a bitset over event indices.
+using EventSet = std::vector<uint64_t>;
+
+bool contains(const EventSet& set, int event) {
+    return event >= 0 && (set[event / 64] >> (event % 64)) & 1;
+}
+
+void insert_all(EventSet& set, const EventSet& other) {
+    for (size_t word = 0; word < set.size(); ++word) {
+        set[word] |= other[word];
+    }
+}
+
+// Tasks of the same node do not commute, and a clock advance commutes with
+// nothing. A delivery only queues the task handling it (or resuming the RPC it
+// answers), so it commutes with everything else on its node.
+bool dependent(const ActionId& a, const ActionId& b) {
+    if (a.kind == ActionKind::Tick || b.kind == ActionKind::Tick) {
+        return true;
+    }
+    return a.kind == ActionKind::Task && b.kind == ActionKind::Task && a.node == b.node;
+}
+
+class Explorer {
+private:
+    struct Level {
+        std::vector<Action> enabled;
+        std::set<ActionId> backtrack;
+        std::set<ActionId> done;
+        uint64_t signature = 0;
+        // Kinds of action run below this state (see touch())
+        uint64_t touched = 0;
+
+        bool is_enabled(const ActionId& id) const {
+            return std::any_of(enabled.begin(), enabled.end(), [&](const Action& a) { return a.id == id; });
+        }
+    };
+    struct Event {
+        ActionId id;
+        EventSet before;
+    };
+
+    ModelConfig config_;
+    ExploreBounds bounds_;
+    ExploreResult result_;
+    std::unique_ptr<World> world_;
+    // levels_[i] is the state events_[i] was picked in
+    std::vector<Level> levels_;
+    std::vector<Event> events_;
+    // Signature of every state reached, and what ran below it once expanded
+    std::unordered_map<uint64_t, uint64_t> seen_;
+    std::unordered_set<size_t> node_states_;
+
+    static constexpr uint64_t DELIVERY_BIT = 1ULL << 62;
+    static constexpr uint64_t TICK_BIT = 1ULL << 63;
+    static constexpr int MAX_NODES = 62;
+
+    // Summarizes an action by what it does not commute with: a node's tasks,
+    // deliveries, the clock
+    static uint64_t touch(const ActionId& id) {
+        switch (id.kind) {
+            case ActionKind::Task:
+                return 1ULL << id.node;
+            case ActionKind::Delivery:
+                return DELIVERY_BIT;
+            case ActionKind::Tick:
+                break;
+        }
+        return TICK_BIT;
+    }
+
+    EventSet empty_set() const { return EventSet((bounds_.max_depth + 63) / 64); }
+
+    // Events an enabled action cannot be moved before: those it was created
+    // or made due by. The clock only follows its own last advance.
+    EventSet ancestry(const Action& action) const {
+        EventSet set = empty_set();
+        if (action.id.kind == ActionKind::Tick) {
+            for (int k = static_cast<int>(events_.size()) - 1; k >= 0; --k) {
+                if (events_[k].id.kind == ActionKind::Tick) {
+                    insert_all(set, events_[k].before);
+                    break;
+                }
+            }
+            return set;
+        }
+        if (action.created_by >= 0) {
+            insert_all(set, events_[action.created_by].before);
+        }
+        if (action.enabled_by >= 0) {
+            insert_all(set, events_[action.enabled_by].before);
+        }
+        return set;
+    }
+
+    // Happens-before of an action about to run as the next event: what it is
+    // owed to, and the last event it does not commute with
+    EventSet happens_before(const Action& action) const {
+        EventSet set = ancestry(action);
+        int event = static_cast<int>(events_.size());
+        if (action.id.kind == ActionKind::Tick) {
+            for (int k = 0; k < event; ++k) {
+                set[k / 64] |= 1ULL << (k % 64);
+            }
+        }
+        for (int k = event - 1; k >= 0; --k) {
+            if (dependent(events_[k].id, action.id)) {
+                insert_all(set, events_[k].before);
+                break;
+            }
+        }
+        set[event / 64] |= 1ULL << (event % 64);
+        return set;
+    }
+
+    // For each action enabled now, finds the last event it races with and
+    // makes sure the state that event ran in also tries the action first
+    // (or, if it was not enabled there, whatever leads to it)
+    void add_races(const std::vector<Action>& enabled) {
+        for (const auto& action : enabled) {
+            EventSet before = ancestry(action);
+            for (int j = static_cast<int>(events_.size()) - 1; j >= 0; --j) {
+                if (!dependent(events_[j].id, action.id)) {
+                    continue;
+                }
+                if (contains(before, j)) {
+                    break;
+                }
+                Level& level = levels_[j];
+                if (level.is_enabled(action.id)) {
+                    level.backtrack.insert(action.id);
+                    break;
+                }
+                bool found = false;
+                for (int k = j + 1; k < static_cast<int>(events_.size()) && !found; ++k) {
+                    if (contains(before, k) && level.is_enabled(events_[k].id)) {
+                        level.backtrack.insert(events_[k].id);
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    for (const auto& other : level.enabled) {
+                        level.backtrack.insert(other.id);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // A state already expanded is not expanded again, so the races its
+    // subtree has with the current execution are not seen there. Knowing only
+    // the kinds of action that ran in it, assume each races with the last
+    // event on the path it does not commute with, and try everything there.
+    void add_subtree_races(uint64_t touched) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (!(touched >> bit & 1)) {
+                continue;
+            }
+            for (int j = static_cast<int>(events_.size()) - 1; j >= 0; --j) {
+                const ActionId& id = events_[j].id;
+                bool races = id.kind == ActionKind::Tick || (1ULL << bit) == TICK_BIT ||
+                             (id.kind == ActionKind::Task && id.node == bit);
+                if (races) {
+                    for (const auto& other : levels_[j].enabled) {
+                        levels_[j].backtrack.insert(other.id);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void push_level(std::vector<Action> enabled, uint64_t signature) {
+        Level level;
+        level.signature = signature;
+        if (bounds_.reduction) {
+            level.backtrack.insert(enabled.front().id);
+        } else {
+            for (const auto& action : enabled) {
+                level.backtrack.insert(action.id);
+            }
+        }
+        level.enabled = std::move(enabled);
+        levels_.push_back(std::move(level));
+    }
+
+    void replay() {
+        world_.reset();
+        world_ = std::make_unique<World>(config_, bounds_.max_time);
+        for (size_t i = 0; i < events_.size(); ++i) {
+            world_->execute(events_[i].id, static_cast<int>(i));
+        }
+    }
+
+    void record(const World& world) {
+        for (const auto& node : world.nodes()) {
+            auto state = State::NodeState::of(*node);
+            node_states_.insert(state.hash());
+            result_.highest_term = std::max(result_.highest_term, state.term);
+            result_.leader_elected |= state.state == Node::LEADER;
+        }
+    }
+public:
+    Explorer(const ModelConfig& config, const ExploreBounds& bounds) : config_(config), bounds_(bounds) {}
+
+    ExploreResult run() {
+        if (config_.nr_nodes < 1 || config_.nr_nodes > MAX_NODES || bounds_.max_depth < 1) {
+            throw std::invalid_argument("Cannot explore " + std::to_string(config_.nr_nodes) +
+                                        " nodes to depth " + std::to_string(bounds_.max_depth));
+        }
+        auto start = std::chrono::steady_clock::now();
+        world_ = std::make_unique<World>(config_, bounds_.max_time);
+        uint64_t signature = world_->signature();
+        seen_.emplace(signature, 0);
+        record(*world_);
+        auto initial = world_->enabled();
+        if (!initial.empty()) {
+            push_level(std::move(initial), signature);
+        }
+        bool stale = false;
+        result_.complete = true;
+        while (!levels_.empty()) {
+            size_t depth = levels_.size() - 1;
+            std::optional<ActionId> next;
+            for (const auto& id : levels_[depth].backtrack) {
+                if (!levels_[depth].done.count(id)) {
+                    next = id;
+                    break;
+                }
+            }
+            if (!next) {
+                seen_[levels_[depth].signature] = levels_[depth].touched;
+                if (depth > 0) {
+                    levels_[depth - 1].touched |= levels_[depth].touched;
+                }
+                levels_.pop_back();
+                if (!events_.empty()) {
+                    events_.pop_back();
+                }
+                stale = true;
+                continue;
+            }
+            if (bounds_.max_transitions > 0 && result_.transitions >= bounds_.max_transitions) {
+                result_.complete = false;
+                break;
+            }
+            if (stale) {
+                replay();
+                stale = false;
+            }
+
+            Level& level = levels_[depth];
+            level.done.insert(*next);
+            level.touched |= touch(*next);
+            const Action& action = *std::find_if(level.enabled.begin(), level.enabled.end(),
+                                                 [&](const Action& a) { return a.id == *next; });
+            Event event{*next, happens_before(action)};
+            std::string description = world_->describe(*next);
+            try {
+                world_->execute(*next, static_cast<int>(depth));
+            } catch (const std::logic_error&) {
+                throw;
+            } catch (const std::exception& e) {
+                result_.violation = e.what();
+                World world(config_, bounds_.max_time);
+                for (size_t i = 0; i < events_.size(); ++i) {
+                    result_.trace.push_back(world.describe(events_[i].id));
+                    world.execute(events_[i].id, static_cast<int>(i));
+                }
+                result_.trace.push_back(description);
+                break;
+            }
+            ++result_.transitions;
+            events_.push_back(std::move(event));
+            result_.deepest = std::max(result_.deepest, static_cast<int>(events_.size()));
+
+            uint64_t signature = world_->signature();
+            auto [seen, fresh] = seen_.emplace(signature, 0);
+            record(*world_);
+            auto enabled = world_->enabled();
+            if (bounds_.reduction && !enabled.empty()) {
+                add_races(enabled);
+            }
+            if (bounds_.dedup && !fresh) {
+                levels_[depth].touched |= seen->second;
+                if (bounds_.reduction) {
+                    add_subtree_races(seen->second);
+                }
+            }
+            bool cut = static_cast<int>(events_.size()) >= bounds_.max_depth && !enabled.empty();
+            if (enabled.empty() || cut || (bounds_.dedup && !fresh)) {
+                if (cut) {
+                    // Not expanded: reaching it again with room to go on must not stop there
+                    result_.complete = false;
+                    if (fresh) {
+                        seen_.erase(seen);
+                    }
+                }
+                ++result_.executions;
+                events_.pop_back();
+                stale = true;
+                continue;
+            }
+            push_level(std::move(enabled), signature);
+        }
+        world_.reset();
+        result_.distinct_states = seen_.size();
+        result_.node_states = node_states_.size();
+        result_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result_;
+    }
+};
+
+} // namespace
+
+std::string ExploreResult::describe() const {
+    std::ostringstream out;
+    out << transitions << " transitions over " << executions << " executions, " << distinct_states
+        << " distinct states, " << node_states << " node states, depth " << deepest << ", highest term "
+        << highest_term << (leader_elected ? " (leader elected)" : " (no leader)") << "; "
+        << static_cast<long long>(states_per_second()) << " states/s, " << seconds << " s";
+    if (!violation.empty()) {
+        out << std::endl << violation;
+        for (const auto& step : trace) {
+            out << std::endl << "  " << step;
+        }
+    } else if (proved_election_safety()) {
+        out << std::endl << "Election safety holds in every explored interleaving";
+    } else {
+        out << std::endl << "Stopped before exhausting the bounds";
+    }
+    return out.str();
+}
+
+ExploreResult explore(const ModelConfig& config, const ExploreBounds& bounds) {
+    Log::ScopedSink sink(Log::null_stream());
+    Explorer explorer(config, bounds);
+    return explorer.run();
+}
+
+} // namespace Explore
@@ -0,0 +1,99 @@
+#ifndef _MODEL_CHECKER_H_
+#define _MODEL_CHECKER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Explore {
+
+// The cluster a model checker explores: one Raft group, small enough that
+// every schedule of it can be tried.
+struct ModelConfig {
+    int nr_nodes = 3;
+    // Each node draws its timeouts from its own RNG stream; with min == max
+    // (the default) the draws are not choices at all
+    int election_timeout_min = 20;
+    int election_timeout_max = 20;
+    int heartbeat_interval = 10;
+    uint32_t rng_seed = 0;
+    // Fault injection, to check the checker: every RequestVote response is
+    // rewritten to grant the vote, as if voters ignored the one vote per term
+    // rule. Election safety then no longer holds.
+    bool forge_votes = false;
+};
+
+// How far the search goes, and how it prunes.
+struct ExploreBounds {
+    // Actions along one execution; cutting one short leaves the result incomplete
+    int max_depth = 100;
+    // The clock is never advanced past this tick
+    long long max_time = 30;
+    // Stop after this many transitions (the result is then not complete); 0: no limit
+    size_t max_transitions = 0;
+    // Dynamic partial-order reduction: only reorder actions that touch the same node
+    bool reduction = true;
+    // Do not expand a state whose signature was expanded before. The
+    // signature covers what the rest of an execution depends on: the cluster
+    // state and last heartbeats, the clock, the oracle's leaders so far, each
+    // node's RNG (when timeouts are drawn), the RPCs each node waits on with
+    // the requests their frames were suspended on, what each pending task
+    // resumes, and the messages in flight. With reduction on, what ran below
+    // the state the first time is assumed to race with the current execution.
+    bool dedup = true;
+};
+
+struct ExploreResult {
+    // Actions executed, replays not counted
+    size_t transitions = 0;
+    // Executions that ended: nothing enabled, the depth bound, or a state
+    // already expanded
+    size_t executions = 0;
+    // Distinct state signatures reached (not counting states cut by max_depth)
+    size_t distinct_states = 0;
+    // Distinct State::NodeState values any node went through
+    size_t node_states = 0;
+    int deepest = 0;
+    int highest_term = 0;
+    bool leader_elected = false;
+    double seconds = 0;
+    // Every execution ran to its end within max_time: none was cut by
+    // max_depth, and the search did not stop at max_transitions
+    bool complete = false;
+    // The oracle's message, and the actions that led to it
+    std::string violation;
+    std::vector<std::string> trace;
+
+    double states_per_second() const { return seconds > 0 ? transitions / seconds : 0; }
+    // No two leaders in a term anywhere within the bounds searched
+    bool proved_election_safety() const { return complete && violation.empty(); }
+    std::string describe() const;
+};
+
+// Explores every interleaving of the cluster's ready tasks, message
+// deliveries and clock advances, depth first, checking election safety after
+// each action.
+//
+// The jittered scheduler and the delaying network are gone: scheduling a task
+// makes it pending (due now, or after its delay), sending a message puts it in
+// flight, and each step is a choice between running a task that is due,
+// delivering a message in flight (in any order, after any delay), and moving
+// the clock to the next time a task is due (the tasks already due then run
+// late, as jitter lets them). Every node has its own scheduler, RPC counter
+// and RNG stream, so an action only touches the node it runs on or is
+// delivered to: deliveries to different nodes, and tasks of different nodes,
+// commute (a delivery only queues the task handling it, so it even commutes
+// with the tasks of its own node; only the clock does not). With reduction
+// on, the search starts each state with one action and only adds alternatives
+// where it finds a race (Flanagan and Godefroid's DPOR): an enabled action and
+// the last action it does not commute with that did not happen before it.
+//
+// States are not copied: the search keeps the choices that led to the current
+// state and replays them on a fresh cluster to backtrack. Nodes and time are
+// the bounds election safety is proved within, with or without dedup.
+ExploreResult explore(const ModelConfig& config, const ExploreBounds& bounds);
+
+} // namespace Explore
+
+#endif // _MODEL_CHECKER_H_
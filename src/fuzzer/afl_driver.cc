@@ -0,0 +1,85 @@
+#include "src/fuzzer/state_feedback.h"
+#include "src/simulation/simulation_harness.h"
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <unistd.h>
+#include <vector>
+
+// Persistent-mode driver for afl-clang-fast / afl-clang-lto builds. Built with a
+// plain compiler, the fallbacks below make it run the single input on stdin.
+#ifndef __AFL_FUZZ_TESTCASE_LEN
+ssize_t fuzz_len;
+#define __AFL_FUZZ_TESTCASE_LEN fuzz_len
+unsigned char fuzz_buf[1024000];
+#define __AFL_FUZZ_TESTCASE_BUF fuzz_buf
+#define __AFL_FUZZ_INIT() void sync(void);
+// Reads stdin to its end (a pipe may deliver it in several chunks) as the one
+// input of the first iteration; there is no second.
+int fuzz_read_stdin_once() {
+    static bool done = false;
+    if (done) {
+        return 0;
+    }
+    done = true;
+    fuzz_len = 0;
+    while (fuzz_len < static_cast<ssize_t>(sizeof(fuzz_buf))) {
+        ssize_t n = read(0, fuzz_buf + fuzz_len, sizeof(fuzz_buf) - fuzz_len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        fuzz_len += n;
+    }
+    return fuzz_len > 0 ? 1 : 0;
+}
+#define __AFL_LOOP(x) fuzz_read_stdin_once()
+#define __AFL_INIT() sync()
+#endif
+
+// Provided by the AFL++ runtime; null when running outside of afl-fuzz.
+extern "C" {
+__attribute__((weak)) extern uint8_t* __afl_area_ptr;
+__attribute__((weak)) extern uint32_t __afl_map_size;
+// One past the last counter the edge instrumentation uses
+__attribute__((weak)) extern uint32_t __afl_final_loc;
+}
+
+// The counters past the instrumented edges, where states can go without
+// landing on an edge's counter. There are only some when afl-fuzz was
+// started with an AFL_MAP_SIZE above the edge count; without them, states
+// are not exported at all.
+std::span<uint8_t> state_counters() {
+    if (&__afl_area_ptr == nullptr || &__afl_map_size == nullptr || &__afl_final_loc == nullptr) {
+        return {};
+    }
+    if (__afl_area_ptr == nullptr || __afl_final_loc == 0 || __afl_map_size <= __afl_final_loc) {
+        return {};
+    }
+    return std::span<uint8_t>(__afl_area_ptr + __afl_final_loc, __afl_map_size - __afl_final_loc);
+}
+
+__AFL_FUZZ_INIT();
+
+int main() {
+    __AFL_INIT();
+    unsigned char* buffer = __AFL_FUZZ_TESTCASE_BUF;
+
+    while (__AFL_LOOP(10000)) {
+        size_t len = __AFL_FUZZ_TESTCASE_LEN;
+        std::vector<uint8_t> input(buffer, buffer + len);
+        Simulation::SimulationResult result = Simulation::run_simulation(input);
+
+        auto counters = state_counters();
+        Fuzzer::export_state_feedback(result, counters.data(), counters.size());
+
+        if (result.oracle_violation) {
+            std::cerr << result.error_message << std::endl;
+            std::abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "src/fuzzer/corpus_store.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <queue>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace Fuzzer {
+
+namespace {
+
+const char CORPUS_MAGIC[] = "RCORPUS1";
+const char COVERAGE_MAGIC[] = "RCOVER02";
+const size_t MAGIC_SIZE = 8;
+
+void write_all(int fd, const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0) {
+            throw std::runtime_error("Failed writing to corpus store: " + std::string(strerror(errno)));
+        }
+        bytes += written;
+        size -= written;
+    }
+}
+
+// Opens path for appending, creating it with magic if empty. The valid prefix of
+// the file is handed to parse (through a read-only mapping), which returns how
+// many bytes of it hold complete records; anything after that is cut off.
+template<typename Parser>
+int open_append_only(const std::string& path, const char* magic, Parser parse) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + path + ": " + strerror(errno));
+    }
+    struct stat st;
+    fstat(fd, &st);
+    size_t size = st.st_size;
+    if (size == 0) {
+        write_all(fd, magic, MAGIC_SIZE);
+        return fd;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Unable to mmap " + path + ": " + strerror(errno));
+    }
+    auto data = static_cast<const uint8_t*>(mapped);
+    if (size < MAGIC_SIZE || std::memcmp(data, magic, MAGIC_SIZE) != 0) {
+        munmap(mapped, size);
+        ::close(fd);
+        throw std::runtime_error(path + " is not a corpus store file");
+    }
+    size_t valid = MAGIC_SIZE + parse(data + MAGIC_SIZE, size - MAGIC_SIZE);
+    munmap(mapped, size);
+    if (valid < size && ftruncate(fd, valid) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to drop torn tail of " + path);
+    }
+    return fd;
+}
+
+} // namespace
+
+CorpusStore::CorpusStore(const std::string& dir) : dir_(dir) {
+    std::filesystem::create_directories(dir_);
+
+    corpus_fd_ = open_append_only(dir_ + "/corpus.bin", CORPUS_MAGIC, [this](const uint8_t* data, size_t size) {
+        size_t offset = 0;
+        while (offset + sizeof(uint32_t) <= size) {
+            uint32_t length;
+            std::memcpy(&length, data + offset, sizeof(length));
+            if (offset + sizeof(length) + length > size) {
+                break;
+            }
+            offset += sizeof(length);
+            entries_.emplace_back(data + offset, data + offset + length);
+            offset += length;
+        }
+        return offset;
+    });
+
+    coverage_fd_ = open_append_only(dir_ + "/coverage.bin", COVERAGE_MAGIC, [this](const uint8_t* data, size_t size) {
+        size_t count = size / sizeof(uint64_t);
+        coverage_.resize(count);
+        std::memcpy(coverage_.data(), data, count * sizeof(uint64_t));
+        return count * sizeof(uint64_t);
+    });
+}
+
+CorpusStore::~CorpusStore() {
+    if (corpus_fd_ >= 0) {
+        ::close(corpus_fd_);
+    }
+    if (coverage_fd_ >= 0) {
+        ::close(coverage_fd_);
+    }
+}
+
+void CorpusStore::append_entry(const std::vector<uint8_t>& entry) {
+    std::vector<uint8_t> record(sizeof(uint32_t) + entry.size());
+    uint32_t length = entry.size();
+    std::memcpy(record.data(), &length, sizeof(length));
+    std::memcpy(record.data() + sizeof(length), entry.data(), entry.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    // One write per record, so a crash can only tear the last one
+    write_all(corpus_fd_, record.data(), record.size());
+}
+
+void CorpusStore::append_coverage(const std::vector<uint64_t>& records) {
+    if (records.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_all(coverage_fd_, records.data(), records.size() * sizeof(uint64_t));
+}
+
+void CorpusStore::rewrite(const std::vector<std::vector<uint8_t>>& entries, const std::vector<uint64_t>& coverage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto replace = [this](const std::string& name, const char* magic, const std::vector<uint8_t>& payload, int& fd) {
+        std::string path = dir_ + "/" + name;
+        std::string tmp_path = path + ".tmp";
+        int tmp_fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (tmp_fd < 0) {
+            throw std::runtime_error("Unable to open " + tmp_path + ": " + strerror(errno));
+        }
+        write_all(tmp_fd, magic, MAGIC_SIZE);
+        write_all(tmp_fd, payload.data(), payload.size());
+        fsync(tmp_fd);
+        ::close(tmp_fd);
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Unable to replace " + path + ": " + strerror(errno));
+        }
+        ::close(fd);
+        fd = ::open(path.c_str(), O_RDWR | O_APPEND);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to reopen " + path + ": " + strerror(errno));
+        }
+    };
+
+    std::vector<uint8_t> corpus_payload;
+    for (const auto& entry : entries) {
+        uint32_t length = entry.size();
+        auto length_bytes = reinterpret_cast<const uint8_t*>(&length);
+        corpus_payload.insert(corpus_payload.end(), length_bytes, length_bytes + sizeof(length));
+        corpus_payload.insert(corpus_payload.end(), entry.begin(), entry.end());
+    }
+    auto record_bytes = reinterpret_cast<const uint8_t*>(coverage.data());
+    std::vector<uint8_t> coverage_payload(record_bytes, record_bytes + coverage.size() * sizeof(uint64_t));
+
+    replace("corpus.bin", CORPUS_MAGIC, corpus_payload, corpus_fd_);
+    replace("coverage.bin", COVERAGE_MAGIC, coverage_payload, coverage_fd_);
+    entries_ = entries;
+    coverage_ = coverage;
+}
+
+std::vector<size_t> minimize_corpus(const std::vector<std::vector<uint64_t>>& entry_slots,
+                                    const std::vector<std::vector<uint8_t>>& entries) {
+    std::unordered_set<uint64_t> uncovered;
+    for (const auto& slots : entry_slots) {
+        uncovered.insert(slots.begin(), slots.end());
+    }
+
+    // Lazy greedy: gains only shrink, so a stale gain is an upper bound and an
+    // entry whose refreshed gain still tops the queue is the best pick.
+    // (gain, -size, -index): larger gain first, then smaller input, then older entry
+    using Candidate = std::tuple<size_t, long long, long long>;
+    std::priority_queue<Candidate> candidates;
+    for (size_t i = 0; i < entry_slots.size(); ++i) {
+        candidates.push({entry_slots[i].size(), -static_cast<long long>(entries[i].size()), -static_cast<long long>(i)});
+    }
+
+    std::vector<size_t> kept;
+    while (!uncovered.empty() && !candidates.empty()) {
+        auto [stale_gain, neg_size, neg_idx] = candidates.top();
+        candidates.pop();
+        size_t idx = -neg_idx;
+        size_t gain = 0;
+        for (uint64_t slot : entry_slots[idx]) {
+            gain += uncovered.count(slot);
+        }
+        if (gain == 0) {
+            continue;
+        }
+        if (!candidates.empty() && Candidate{gain, neg_size, neg_idx} < candidates.top()) {
+            candidates.push({gain, neg_size, neg_idx});
+            continue;
+        }
+        kept.push_back(idx);
+        for (uint64_t slot : entry_slots[idx]) {
+            uncovered.erase(slot);
+        }
+    }
+    return kept;
+}
+
+} // namespace Fuzzer
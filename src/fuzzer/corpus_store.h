@@ -0,0 +1,58 @@
+#ifndef _CORPUS_STORE_H_
+#define _CORPUS_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fuzzer {
+
+// On-disk state of a fuzzing campaign. A corpus directory holds two
+// append-only files:
+//
+//   corpus.bin    "RCORPUS1", then one [u32 size][size bytes] record per input
+//   coverage.bin  "RCOVER02", then one u64 per coverage map update, as
+//                 recorded by Coverage::GlobalCoverage::merge (slot << 8 | bits)
+//
+// Both are mmap'ed and parsed in one pass when the store opens, and appended to
+// as the fuzzer finds new inputs and coverage, so a killed campaign loses at most
+// the record being written (a torn tail is dropped on the next open).
+class CorpusStore {
+private:
+    std::string dir_;
+    int corpus_fd_ = -1;
+    int coverage_fd_ = -1;
+    std::vector<std::vector<uint8_t>> entries_;
+    std::vector<uint64_t> coverage_;
+    std::mutex mutex_;
+public:
+    // Opens (creating if needed) the campaign stored in dir.
+    explicit CorpusStore(const std::string& dir);
+    ~CorpusStore();
+    CorpusStore(const CorpusStore&) = delete;
+    CorpusStore& operator=(const CorpusStore&) = delete;
+
+    // What was on disk when the store was opened.
+    const std::vector<std::vector<uint8_t>>& entries() const { return entries_; }
+    const std::vector<uint64_t>& coverage() const { return coverage_; }
+
+    // Thread safe.
+    void append_entry(const std::vector<uint8_t>& entry);
+    void append_coverage(const std::vector<uint64_t>& records);
+
+    // Atomically replaces the on-disk contents (used by minimization and when
+    // a campaign restarts without --resume).
+    void rewrite(const std::vector<std::vector<uint8_t>>& entries, const std::vector<uint64_t>& coverage);
+};
+
+// Greedy set cover over the coverage slots each entry reaches: returns the
+// indices of a small subset of entries that still covers every slot, preferring
+// smaller inputs on ties.
+std::vector<size_t> minimize_corpus(const std::vector<std::vector<uint64_t>>& entry_slots,
+                                    const std::vector<std::vector<uint8_t>>& entries);
+
+} // namespace Fuzzer
+
+#endif // _CORPUS_STORE_H_
@@ -1,102 +1,104 @@
 #include "src/fuzzer/fuzzer.h"
+#include "src/fuzzer/mutator.h"
+#include "src/fuzzer/shrinker.h"
 #include "src/simulation/simulation_harness.h"
+#include "src/log/log.h"
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <chrono>
+#include <iterator>
 
 namespace Fuzzer {
 
-CoverageFuzzer::CoverageFuzzer(uint32_t seed) : rng_(seed) {}
+CoverageFuzzer::CoverageFuzzer(uint32_t seed, PowerSchedule schedule) : rng_(seed), scheduler_(schedule) {}
 
 void CoverageFuzzer::seed_corpus(const std::vector<uint8_t>& initial) {
-    corpus_.push_back(initial);
+    last_run_ = EntryMetadata{};
     execute_and_update(initial);
+    add_to_corpus(initial);
 }
 
-std::vector<uint8_t> CoverageFuzzer::select_from_corpus() {
-    if (corpus_.empty()) {
-std::vector<uint8_t> input(140);
-        std::uniform_int_distribution<int> dist(0, 255);
-        
-        for(auto& b : input) {
-            b = static_cast<uint8_t>(dist(rng_));
-        }
-        return input;
+void CoverageFuzzer::add_to_corpus(const std::vector<uint8_t>& input) {
+    corpus_.push_back(input);
+    scheduler_.add_entry(last_run_);
+    if (store_) {
+        store_->append_entry(input);
     }
-    size_t idx = rng_() % corpus_.size();
-    return corpus_[idx];
 }
 
-std::vector<uint8_t> CoverageFuzzer::mutate(const std::vector<uint8_t>& input) {
-    auto result = input;
-
-    // Ensure minimum size for valid FuzzInput
-    const size_t MIN_SIZE = 15;
-    while (result.size() < MIN_SIZE) {
-        result.push_back(rng_() % 256);
-    }
-
-    // Apply multiple mutations when coverage stalls
-    int num_mutations = 1;
-    if (iterations_since_new_coverage_ > 100) {
-        num_mutations = 2;
+void CoverageFuzzer::attach_store(CorpusStore* store, bool resume) {
+    if (resume) {
+        for (const auto& entry : store->entries()) {
+            corpus_.push_back(entry);
+            scheduler_.add_entry(EntryMetadata{});
+        }
+        for (uint64_t record : store->coverage()) {
+            global_coverage_.restore(record);
+        }
+        store_ = store;
+        Log::out() << "[Fuzzer] Resumed " << store->entries().size() << " inputs and "
+                  << global_coverage_.covered() << " states" << std::endl;
+        return;
     }
-    if (iterations_since_new_coverage_ > 500) {
-        num_mutations = 3;
+    auto seeds = store->entries();
+    store->rewrite({}, {});
+    store_ = store;
+    for (const auto& seed : seeds) {
+        seed_corpus(seed);
     }
+    Log::out() << "[Fuzzer] Re-executed " << seeds.size() << " stored inputs, coverage: "
+              << global_coverage_.covered() << " states" << std::endl;
+}
 
-    for (int m = 0; m < num_mutations; ++m) {
-        int strategy = rng_() % 5;
+std::vector<uint8_t> CoverageFuzzer::select_from_corpus() {
+    if (corpus_.empty()) {
+        return random_input(rng_);
+    }
+    return corpus_[scheduler_.next(rng_)];
+}
 
-        switch (strategy) {
-            case 0: { // Bit flip
-                size_t pos = rng_() % (result.size() * 8);
-                result[pos / 8] ^= (1 << (pos % 8));
-                break;
-            }
-            case 1: { // Byte replace
-                size_t pos = rng_() % result.size();
-                result[pos] = rng_() % 256;
-                break;
-            }
-            case 2: { // Arithmetic
-                size_t pos = rng_() % result.size();
-                int delta = static_cast<int>(rng_() % 35) - 17;  // -17 to +17
-                result[pos] = static_cast<uint8_t>(result[pos] + delta);
-                break;
-            }
-            case 3: { // Splice with another corpus entry
-                if (corpus_.size() > 1) {
-                    const auto& other = corpus_[rng_() % corpus_.size()];
-                    size_t min_size = std::min(result.size(), other.size());
-                    if (min_size > 0) {
-                        size_t split = rng_() % min_size;
-                        std::copy(other.begin(), other.begin() + split, result.begin());
-                    }
-                }
-                break;
-            }
-            case 4: { // Interesting values for specific fields
-                // Target the rng_seed field (first 4 bytes) with interesting values
-                if (result.size() >= 4) {
-                    uint32_t interesting_seeds[] = {0, 1, 0xFFFFFFFF, 0x12345678, 0xDEADBEEF};
-                    uint32_t seed = interesting_seeds[rng_() % 5];
-                    result[0] = (seed >> 0) & 0xFF;
-                    result[1] = (seed >> 8) & 0xFF;
-                    result[2] = (seed >> 16) & 0xFF;
-                    result[3] = (seed >> 24) & 0xFF;
-                }
-                break;
-            }
+std::vector<uint8_t> CoverageFuzzer::mutate(const std::vector<uint8_t>& input) {
+    auto pick_splice = [this]() -> const std::vector<uint8_t>* {
+        if (corpus_.size() > 1) {
+            return &corpus_[rng_() % corpus_.size()];
         }
-    }
+        return nullptr;
+    };
+    return Fuzzer::mutate(input, rng_, mutations_for_stall(iterations_since_new_coverage_), pick_splice,
+                           decision_bytes_);
+}
 
-    return result;
+void CoverageFuzzer::set_fitness(bool guided, Oracle::FitnessWeights weights) {
+    fitness_guided_ = guided;
+    fitness_weights_ = weights;
+}
+
+void CoverageFuzzer::enable_fork_branching(Simulation::CheckpointPolicy policy, int branches) {
+    fork_policy_ = policy;
+    fork_branches_ = branches;
 }
 
 bool CoverageFuzzer::execute_and_update(const std::vector<uint8_t>& input) {
+    auto start = std::chrono::steady_clock::now();
     Simulation::SimulationResult result = Simulation::run_simulation(input);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    bool found_new = update_coverage(result, input);
+    last_run_.exec_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    return found_new;
+}
 
+bool CoverageFuzzer::update_coverage(const Simulation::SimulationResult& result, const std::vector<uint8_t>& input) {
+    ++executions_;
+    int fitness = Oracle::fitness(result.proximity, fitness_weights_);
+    int nr_nodes = Simulation::FuzzInput::from_bytes(input.data(), input.size()).nr_nodes;
+    int& best_of_size = best_fitness_by_size_[std::clamp(nr_nodes, 0, Simulation::FuzzInput::MAX_NODES)];
+    bool fitter = fitness > best_of_size;
+    best_of_size = std::max(best_of_size, fitness);
+    if (fitness > best_fitness_) {
+        best_fitness_ = fitness;
+        fitness_curve_.emplace_back(executions_, fitness);
+    }
     if (result.oracle_violation) {
         found_violation_ = true;
         violation_input_ = input;
@@ -104,24 +106,70 @@ bool CoverageFuzzer::execute_and_update(const std::vector<uint8_t>& input) {
         return false;
     }
 
-    // Check for new coverage
-    bool found_new = false;
-    for (size_t hash : result.visited_state_hashes) {
-        if (global_coverage_.find(hash) == global_coverage_.end()) {
-            global_coverage_.insert(hash);
-            found_new = true;
+    // Check for new coverage: new states, or known states hit a new number of times
+    std::vector<uint64_t> changed;
+    Coverage::Novelty novelty = global_coverage_.merge(result.coverage, 0, Coverage::MAP_SIZE,
+                                                       store_ ? &changed : nullptr);
+    if (store_) {
+        store_->append_coverage(changed);
+    }
+
+    scheduler_.record_hits(result.coverage.slots());
+    last_run_ = EntryMetadata{};
+    last_run_.steps = result.steps;
+    last_run_.slots = result.coverage.slots();
+    if (fitness_guided_) {
+        last_run_.fitness = fitness;
+    }
+    if (novelty == Coverage::Novelty::NewStates) {
+        coverage_curve_.emplace_back(executions_, global_coverage_.covered());
+    }
+
+    return novelty != Coverage::Novelty::None || (fitness_guided_ && fitter);
+}
+
+size_t CoverageFuzzer::executions_to_fitness(int fitness) const {
+    for (const auto& [executions, reached] : fitness_curve_) {
+        if (reached >= fitness) {
+            return executions;
         }
     }
+    return 0;
+}
 
-    return found_new;
+size_t CoverageFuzzer::coverage_at(size_t executions) const {
+    auto it = std::upper_bound(coverage_curve_.begin(), coverage_curve_.end(),
+                               std::make_pair(executions, SIZE_MAX));
+    return it == coverage_curve_.begin() ? 0 : std::prev(it)->second;
+}
+
+void CoverageFuzzer::branch_from(const std::vector<uint8_t>& input) {
+    Simulation::ForkServer server(input, fork_policy_);
+    if (!server.reach_checkpoint(&global_coverage_)) {
+        return;
+    }
+    for (int b = 0; b < fork_branches_ && !found_violation_; ++b) {
+        uint32_t branch_seed = rng_();
+        auto branch_input = server.branch_input(branch_seed);
+        ++forked_executions_;
+        if (update_coverage(server.branch(branch_seed), branch_input)) {
+            add_to_corpus(branch_input);
+        }
+    }
 }
 
 void CoverageFuzzer::print_violation() const {
-    std::cout << violation_message_ << std::endl;
+    Log::out() << violation_message_ << Simulation::to_hex(violation_input_) << "\n" << std::endl;
+    if (shrink_violations_) {
+        Log::out() << "[Fuzzer] Shrinking violating input..." << std::endl;
+        Log::out() << describe(Shrinker().shrink(violation_input_)) << std::endl;
+    }
 }
 
 void CoverageFuzzer::run(size_t iterations) {
-    std::cout << "[Fuzzer] Starting fuzzing run with " << iterations << " iterations" << std::endl;
+    Log::out() << "[Fuzzer] Starting fuzzing run with " << iterations << " iterations"
+              << ", schedule: " << schedule_name(scheduler_.schedule())
+              << (fitness_guided_ ? ", fitness guided" : "") << std::endl;
 
     for (size_t i = 0; i < iterations; ++i) {
         // Select and mutate input
@@ -133,30 +181,44 @@ void CoverageFuzzer::run(size_t iterations) {
 
         // Stop immediately on oracle violation
         if (found_violation_) {
-            std::cout << "\n[Fuzzer] Stopping at iteration " << (i + 1)
+            Log::out() << "\n[Fuzzer] Stopping at iteration " << (i + 1)
                       << " due to oracle violation\n";
             print_violation();
             return;
         }
 
         if (found_new) {
-            corpus_.push_back(mutated_input);
+            add_to_corpus(mutated_input);
             iterations_since_new_coverage_ = 0;
+            if (fork_branches_ > 0) {
+                branch_from(mutated_input);
+                if (found_violation_) {
+                    Log::out() << "\n[Fuzzer] Stopping at iteration " << (i + 1)
+                              << " due to oracle violation in a forked branch\n";
+                    print_violation();
+                    return;
+                }
+            }
         } else {
             ++iterations_since_new_coverage_;
         }
 
         // Progress report
         if ((i + 1) % 1000 == 0 || i == 0) {
-            std::cout << "[Fuzzer] Iteration " << (i + 1)
-                      << ", coverage: " << global_coverage_.size() << " states"
+            Log::out() << "[Fuzzer] Iteration " << (i + 1)
+                      << ", executions: " << executions_
+                      << ", coverage: " << global_coverage_.covered() << " states"
+                      << ", fitness: " << best_fitness_
                       << ", corpus: " << corpus_.size()
-                      << ", stalled: " << iterations_since_new_coverage_
-                      << std::endl;
+                      << ", stalled: " << iterations_since_new_coverage_;
+            if (fork_branches_ > 0) {
+                Log::out() << ", forked: " << forked_executions_;
+            }
+            Log::out() << std::endl;
         }
     }
 
-    std::cout << "[Fuzzer] Fuzzing complete - no violations found" << std::endl;
+    Log::out() << "[Fuzzer] Fuzzing complete - no violations found" << std::endl;
 }
 
 } // namespace Fuzzer
@@ -1,39 +1,105 @@
 #ifndef _FUZZER_H_
 #define _FUZZER_H_
 
+#include <array>
 #include <vector>
-#include <unordered_set>
 #include <random>
 #include <cstdint>
 #include <string>
+#include <utility>
+#include "src/coverage/coverage_map.h"
+#include "src/fuzzer/corpus_store.h"
+#include "src/fuzzer/power_schedule.h"
+#include "src/simulation/fork_server.h"
+#include "src/simulation/simulation_harness.h"
 
 namespace Fuzzer {
 
 class CoverageFuzzer {
 private:
-    std::unordered_set<size_t> global_coverage_;
+    Coverage::GlobalCoverage global_coverage_;
     std::vector<std::vector<uint8_t>> corpus_;
     std::mt19937 rng_;
     size_t iterations_since_new_coverage_ = 0;
+    bool decision_bytes_ = false;
+
+    // Corpus entry selection and the metadata of the last run, kept for the
+    // entry it may become
+    PowerScheduler scheduler_;
+    EntryMetadata last_run_;
+
+    // (executions, coverage) each time coverage grew
+    size_t executions_ = 0;
+    std::vector<std::pair<size_t, size_t>> coverage_curve_;
+
+    // Near misses: the best Oracle::fitness any run reached, and (executions,
+    // fitness) each time it grew. Tracked always; kept and prioritized only
+    // when fitness guided. Larger clusters score higher by their size alone,
+    // so inputs are kept for beating the best run of their cluster size.
+    Oracle::FitnessWeights fitness_weights_;
+    bool fitness_guided_ = false;
+    int best_fitness_ = 0;
+    std::array<int, Simulation::FuzzInput::MAX_NODES + 1> best_fitness_by_size_{};
+    std::vector<std::pair<size_t, int>> fitness_curve_;
 
     // Violation tracking
     bool found_violation_ = false;
     std::vector<uint8_t> violation_input_;
     std::string violation_message_;
+    bool shrink_violations_ = true;
+
+    // Fork-server branching of inputs that found new coverage
+    int fork_branches_ = 0;
+    Simulation::CheckpointPolicy fork_policy_;
+    size_t forked_executions_ = 0;
+
+    // Optional on-disk campaign state
+    CorpusStore* store_ = nullptr;
 
 public:
-    explicit CoverageFuzzer(uint32_t seed = 42);
+    explicit CoverageFuzzer(uint32_t seed = 42, PowerSchedule schedule = PowerSchedule::Uniform);
 
     void seed_corpus(const std::vector<uint8_t>& initial);
     void run(size_t iterations);
+    // Every input that finds new coverage is checkpointed and continued with
+    // `branches` fresh RNG streams through the fork server.
+    void enable_fork_branching(Simulation::CheckpointPolicy policy, int branches);
+    // Persists every new corpus entry and covered state into store. With resume,
+    // the stored corpus and coverage are taken as they are; otherwise the stored
+    // inputs are re-executed as seeds and the store rebuilt from the results.
+    void attach_store(CorpusStore* store, bool resume);
+    // Violating inputs are shrunk to a minimal reproduction before being reported (on by default).
+    void set_shrink_violations(bool enabled) { shrink_violations_ = enabled; }
+    // Whether mutants carry a decision stream for the simulation's RNG, or
+    // leave every decision to rng_seed (the default).
+    void set_decision_bytes(bool enabled) { decision_bytes_ = enabled; }
+    // Every run is scored by how close it came to two leaders in a term
+    // (Oracle::fitness with weights). Guided, inputs that beat the best score
+    // so far are kept even without new coverage, and the scheduler favours
+    // the entries that scored highest. Off by default.
+    void set_fitness(bool guided, Oracle::FitnessWeights weights = {});
 
-    size_t coverage_count() const { return global_coverage_.size(); }
+    // Coverage map slots hit so far (distinct states, up to collisions)
+    size_t coverage_count() const { return global_coverage_.covered(); }
     size_t corpus_size() const { return corpus_.size(); }
     bool has_violation() const { return found_violation_; }
+    size_t forked_executions() const { return forked_executions_; }
+    size_t executions() const { return executions_; }
+    const std::vector<std::pair<size_t, size_t>>& coverage_curve() const { return coverage_curve_; }
+    // Coverage reached within the first `executions` executions.
+    size_t coverage_at(size_t executions) const;
+    int best_fitness() const { return best_fitness_; }
+    const std::vector<std::pair<size_t, int>>& fitness_curve() const { return fitness_curve_; }
+    // Executions until a run first scored at least `fitness`; 0 if none did.
+    size_t executions_to_fitness(int fitness) const;
+    const PowerScheduler& scheduler() const { return scheduler_; }
 
 private:
     std::vector<uint8_t> mutate(const std::vector<uint8_t>& input);
     bool execute_and_update(const std::vector<uint8_t>& input);
+    bool update_coverage(const Simulation::SimulationResult& result, const std::vector<uint8_t>& input);
+    void branch_from(const std::vector<uint8_t>& input);
+    void add_to_corpus(const std::vector<uint8_t>& input);
     std::vector<uint8_t> select_from_corpus();
     void print_violation() const;
 };
@@ -0,0 +1,23 @@
+#include "src/fuzzer/state_feedback.h"
+#include "src/simulation/simulation_harness.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// libFuzzer scans this section and treats every byte as an extra coverage counter.
+__attribute__((section("__libfuzzer_extra_counters")))
+static uint8_t state_counters[1 << 16];
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> input(data, data + size);
+    Simulation::SimulationResult result = Simulation::run_simulation(input);
+
+    Fuzzer::export_state_feedback(result, state_counters, sizeof(state_counters));
+
+    if (result.oracle_violation) {
+        // Crash so the engine saves the input as a reproducer
+        std::cerr << result.error_message << std::endl;
+        std::abort();
+    }
+    return 0;
+}
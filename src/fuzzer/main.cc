@@ -1,23 +1,296 @@
 #include "src/fuzzer/fuzzer.h"
+#include "src/fuzzer/parallel_fuzzer.h"
+#include "src/fuzzer/corpus_store.h"
+#include "src/coverage/edge_coverage.h"
+#include "src/log/log.h"
+#include "src/simulation/simulation_harness.h"
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Keeps the smallest set of stored inputs that still reaches every state any of them reaches.
+int minimize_store(Fuzzer::CorpusStore& store) {
+    const auto& entries = store.entries();
+    std::vector<std::vector<uint64_t>> entry_slots;
+    Coverage::GlobalCoverage all;
+    std::vector<uint64_t> records;
+    for (const auto& entry : entries) {
+        auto result = Simulation::run_simulation(entry);
+        entry_slots.emplace_back(result.coverage.slots().begin(), result.coverage.slots().end());
+        all.merge(result.coverage, 0, Coverage::MAP_SIZE, &records);
+    }
+
+    std::vector<std::vector<uint8_t>> kept;
+    for (size_t idx : Fuzzer::minimize_corpus(entry_slots, entries)) {
+        kept.push_back(entries[idx]);
+    }
+    size_t before = entries.size();
+    store.rewrite(kept, records);
+
+    std::cout << "[Fuzzer] Corpus minimized from " << before << " to " << kept.size()
+              << " inputs covering " << all.covered() << " states" << std::endl;
+    return 0;
+}
+
+// Edges taken, in builds with edge coverage, and with a filter the functions
+// matching it that still have cold edges.
+void report_edges(const std::string& cold_filter) {
+    if (Coverage::edge_count() > 0) {
+        std::cout << "Edges: " << Coverage::edges_hit() << " of " << Coverage::edge_count() << std::endl;
+    }
+    if (!cold_filter.empty()) {
+        std::cout << std::endl << "=== Cold Paths ===" << std::endl;
+        std::cout << Coverage::describe_cold_functions(cold_filter);
+    }
+}
+
+// A configured fuzzer to run in a side-by-side comparison.
+struct Contender {
+    std::string name;
+    std::unique_ptr<Fuzzer::CoverageFuzzer> fuzzer;
+};
+
+// Runs every contender for the same number of iterations and prints the
+// coverage each one had reached after the same number of executions, and the
+// best fitness each reached.
+int compare_campaigns(size_t iterations, std::vector<Contender> contenders) {
+    for (auto& contender : contenders) {
+        std::cout << "[Fuzzer] Running " << contender.name << "..." << std::endl;
+        contender.fuzzer->set_shrink_violations(false);
+        // Keep the per-run progress out of the report
+        Log::ScopedSink quiet(Log::null_stream());
+        contender.fuzzer->run(iterations);
+    }
+
+    size_t max_executions = 0;
+    for (const auto& contender : contenders) {
+        max_executions = std::max(max_executions, contender.fuzzer->executions());
+    }
+
+    std::cout << std::endl << "=== Coverage vs Executions ===" << std::endl;
+    std::cout << std::setw(12) << "executions";
+    for (const auto& contender : contenders) {
+        std::cout << std::setw(10) << contender.name;
+    }
+    std::cout << std::endl;
+    const int NR_ROWS = 10;
+    for (int row = 1; row <= NR_ROWS; ++row) {
+        size_t executions = max_executions * row / NR_ROWS;
+        std::cout << std::setw(12) << executions;
+        for (const auto& contender : contenders) {
+            std::cout << std::setw(10) << contender.fuzzer->coverage_at(executions);
+        }
+        std::cout << std::endl;
+    }
+
+    // Executions each contender needed to reach the coverage the weakest one ended with
+    size_t target = SIZE_MAX;
+    for (const auto& contender : contenders) {
+        target = std::min(target, contender.fuzzer->coverage_count());
+    }
+    std::cout << std::setw(12) << ("to " + std::to_string(target));
+    for (const auto& contender : contenders) {
+        size_t needed = 0;
+        for (const auto& [executions, coverage] : contender.fuzzer->coverage_curve()) {
+            if (coverage >= target) {
+                needed = executions;
+                break;
+            }
+        }
+        std::cout << std::setw(10) << needed;
+    }
+    std::cout << std::endl;
+
+    // Near misses: the best fitness each contender reached, and the executions
+    // each needed to reach the best the weakest one reached
+    int fitness_target = INT32_MAX;
+    std::cout << std::setw(12) << "fitness";
+    for (const auto& contender : contenders) {
+        fitness_target = std::min(fitness_target, contender.fuzzer->best_fitness());
+        std::cout << std::setw(10) << contender.fuzzer->best_fitness();
+    }
+    std::cout << std::endl << std::setw(12) << ("to " + std::to_string(fitness_target));
+    for (const auto& contender : contenders) {
+        std::cout << std::setw(10) << contender.fuzzer->executions_to_fitness(fitness_target);
+    }
+    std::cout << std::endl;
+    for (const auto& contender : contenders) {
+        if (contender.fuzzer->has_violation()) {
+            std::cout << contender.name << " stopped early on an oracle violation" << std::endl;
+        }
+    }
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
     size_t iterations = 10000;
     uint32_t fuzzer_seed = 42;
+    int threads = 1;
+    int fork_branches = 0;
+    Simulation::CheckpointPolicy fork_policy;
+    std::string corpus_dir;
+    bool resume = false;
+    bool cmin = false;
+    bool shrink = true;
+    Fuzzer::PowerSchedule schedule = Fuzzer::PowerSchedule::Uniform;
+    bool decision_bytes = false;
+    bool compare_schedules = false;
+    bool compare_rng = false;
+    bool fitness = false;
+    Oracle::FitnessWeights fitness_weights;
+    bool compare_fitness = false;
+    // Empty: no cold path report
+    std::string cold_filter;
+
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            threads = std::stoi(arg.substr(arg.find('=') + 1));
+        } else if (arg.rfind("--fork-branches=", 0) == 0) {
+            fork_branches = std::stoi(arg.substr(arg.find('=') + 1));
+        } else if (arg.rfind("--fork-checkpoint=", 0) == 0) {
+            fork_policy.step = std::stoi(arg.substr(arg.find('=') + 1));
+        } else if (arg == "--fork-on-new-state") {
+            fork_policy.on_new_state = true;
+        } else if (arg.rfind("--corpus=", 0) == 0) {
+            corpus_dir = arg.substr(arg.find('=') + 1);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--cmin") {
+            cmin = true;
+        } else if (arg == "--no-shrink") {
+            shrink = false;
+        } else if (arg.rfind("--schedule=", 0) == 0) {
+            schedule = Fuzzer::parse_power_schedule(arg.substr(arg.find('=') + 1));
+        } else if (arg == "--compare-schedules") {
+            compare_schedules = true;
+        } else if (arg.rfind("--rng=", 0) == 0) {
+            std::string mode = arg.substr(arg.find('=') + 1);
+            if (mode != "seed" && mode != "bytes") {
+                throw std::runtime_error("--rng must be seed or bytes, got " + mode);
+            }
+            decision_bytes = mode == "bytes";
+        } else if (arg == "--compare-rng") {
+            compare_rng = true;
+        } else if (arg == "--fitness") {
+            fitness = true;
+        } else if (arg.rfind("--fitness=", 0) == 0) {
+            fitness = true;
+            fitness_weights = Oracle::parse_fitness_weights(arg.substr(arg.find('=') + 1));
+        } else if (arg == "--compare-fitness") {
+            compare_fitness = true;
+        } else if (arg == "--cold-paths") {
+            cold_filter = "Raft";
+        } else if (arg.rfind("--cold-paths=", 0) == 0) {
+            cold_filter = arg.substr(arg.find('=') + 1);
+        } else if (arg.rfind("--memory-budget-mb=", 0) == 0) {
+            Simulation::set_run_memory_budget(std::stoull(arg.substr(arg.find('=') + 1)) << 20);
+        } else {
+            positional.push_back(arg);
+        }
+    }
 
-    if (argc > 1) {
-        iterations = std::stoull(argv[1]);
+    if (positional.size() > 0) {
+        iterations = std::stoull(positional[0]);
     }
-    if (argc > 2) {
-        fuzzer_seed = std::stoul(argv[2]);
+    if (positional.size() > 1) {
+        fuzzer_seed = std::stoul(positional[1]);
+    }
+
+    if ((resume || cmin) && corpus_dir.empty()) {
+        std::cout << "--resume and --cmin need --corpus=<dir>" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<Fuzzer::CorpusStore> store;
+    if (!corpus_dir.empty()) {
+        store = std::make_unique<Fuzzer::CorpusStore>(corpus_dir);
+    }
+    if (cmin) {
+        return minimize_store(*store);
+    }
+
+    if (compare_schedules) {
+        std::vector<Contender> contenders;
+        for (auto each : {Fuzzer::PowerSchedule::Uniform, Fuzzer::PowerSchedule::Explore,
+                          Fuzzer::PowerSchedule::Fast, Fuzzer::PowerSchedule::Rare}) {
+            auto fuzzer = std::make_unique<Fuzzer::CoverageFuzzer>(fuzzer_seed, each);
+            fuzzer->set_decision_bytes(decision_bytes);
+            fuzzer->set_fitness(fitness, fitness_weights);
+            contenders.push_back({Fuzzer::schedule_name(each), std::move(fuzzer)});
+        }
+        return compare_campaigns(iterations, std::move(contenders));
+    }
+    if (compare_rng) {
+        std::vector<Contender> contenders;
+        for (bool bytes : {false, true}) {
+            auto fuzzer = std::make_unique<Fuzzer::CoverageFuzzer>(fuzzer_seed, schedule);
+            fuzzer->set_decision_bytes(bytes);
+            fuzzer->set_fitness(fitness, fitness_weights);
+            contenders.push_back({bytes ? "bytes" : "seed", std::move(fuzzer)});
+        }
+        return compare_campaigns(iterations, std::move(contenders));
+    }
+    if (compare_fitness) {
+        std::vector<Contender> contenders;
+        for (bool guided : {false, true}) {
+            auto fuzzer = std::make_unique<Fuzzer::CoverageFuzzer>(fuzzer_seed, schedule);
+            fuzzer->set_decision_bytes(decision_bytes);
+            fuzzer->set_fitness(guided, fitness_weights);
+            contenders.push_back({guided ? "fitness" : "coverage", std::move(fuzzer)});
+        }
+        return compare_campaigns(iterations, std::move(contenders));
     }
 
     std::cout << "Raft Fuzzer - Coverage-guided state space exploration" << std::endl;
     std::cout << "Iterations: " << iterations << ", Fuzzer seed: " << fuzzer_seed << std::endl;
     std::cout << std::endl;
 
-    Fuzzer::CoverageFuzzer fuzzer(fuzzer_seed);
+    if (threads > 1) {
+        if (fork_branches > 0) {
+            std::cout << "--fork-branches cannot be combined with --threads" << std::endl;
+            return 1;
+        }
+        if (schedule != Fuzzer::PowerSchedule::Uniform) {
+            std::cout << "--schedule cannot be combined with --threads" << std::endl;
+            return 1;
+        }
+        if (fitness) {
+            std::cout << "--fitness cannot be combined with --threads" << std::endl;
+            return 1;
+        }
+        Fuzzer::ParallelCoverageFuzzer fuzzer(fuzzer_seed, threads);
+        fuzzer.set_shrink_violations(shrink);
+        fuzzer.set_decision_bytes(decision_bytes);
+        if (store) {
+            fuzzer.attach_store(store.get(), resume);
+        }
+        fuzzer.run(iterations);
+
+        std::cout << std::endl;
+        std::cout << "=== Final Results ===" << std::endl;
+        std::cout << "Coverage: " << fuzzer.coverage_count() << " unique states" << std::endl;
+        std::cout << "Corpus: " << fuzzer.corpus_size() << " interesting inputs" << std::endl;
+        report_edges(cold_filter);
+        return 0;
+    }
+
+    Fuzzer::CoverageFuzzer fuzzer(fuzzer_seed, schedule);
+    fuzzer.set_shrink_violations(shrink);
+    fuzzer.set_decision_bytes(decision_bytes);
+    fuzzer.set_fitness(fitness, fitness_weights);
+    if (fork_branches > 0) {
+        fuzzer.enable_fork_branching(fork_policy, fork_branches);
+    }
+    if (store) {
+        fuzzer.attach_store(store.get(), resume);
+    }
     // Run fuzzer
     fuzzer.run(iterations);
 
@@ -25,6 +298,12 @@ int main(int argc, char* argv[]) {
     std::cout << "=== Final Results ===" << std::endl;
     std::cout << "Coverage: " << fuzzer.coverage_count() << " unique states" << std::endl;
     std::cout << "Corpus: " << fuzzer.corpus_size() << " interesting inputs" << std::endl;
+    std::cout << "Executions: " << fuzzer.executions() << std::endl;
+    std::cout << "Fitness: " << fuzzer.best_fitness() << " (closest run to a violation)" << std::endl;
+    if (fork_branches > 0) {
+        std::cout << "Forked: " << fuzzer.forked_executions() << " branch executions" << std::endl;
+    }
+    report_edges(cold_filter);
 
     return 0;
 }
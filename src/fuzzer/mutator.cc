@@ -0,0 +1,113 @@
+#include "src/fuzzer/mutator.h"
+#include "src/simulation/fuzz_input.h"
+#include <algorithm>
+
+namespace Fuzzer {
+
+int mutations_for_stall(size_t iterations_since_new_coverage) {
+    // Apply multiple mutations when coverage stalls
+    int num_mutations = 1;
+    if (iterations_since_new_coverage > 100) {
+        num_mutations = 2;
+    }
+    if (iterations_since_new_coverage > 500) {
+        num_mutations = 3;
+    }
+    return num_mutations;
+}
+
+std::vector<uint8_t> random_input(std::mt19937& rng) {
+    std::vector<uint8_t> input(140);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    for(auto& b : input) {
+        b = static_cast<uint8_t>(dist(rng));
+    }
+    return input;
+}
+
+std::vector<uint8_t> mutate(const std::vector<uint8_t>& input, std::mt19937& rng, int num_mutations,
+                            const SplicePicker& pick_splice, bool decision_bytes) {
+    auto result = input;
+
+    // Ensure minimum size for valid FuzzInput
+    const size_t MIN_SIZE = Simulation::FuzzInput::HEADER_SIZE;
+    while (result.size() < MIN_SIZE) {
+        result.push_back(rng() % 256);
+    }
+    if (!decision_bytes) {
+        result.resize(MIN_SIZE);
+    }
+
+    for (int m = 0; m < num_mutations; ++m) {
+        int strategy = rng() % (decision_bytes ? 8 : 5);
+
+        switch (strategy) {
+            case 0: { // Bit flip
+                size_t pos = rng() % (result.size() * 8);
+                result[pos / 8] ^= (1 << (pos % 8));
+                break;
+            }
+            case 1: { // Byte replace
+                size_t pos = rng() % result.size();
+                result[pos] = rng() % 256;
+                break;
+            }
+            case 2: { // Arithmetic
+                size_t pos = rng() % result.size();
+                int delta = static_cast<int>(rng() % 35) - 17;  // -17 to +17
+                result[pos] = static_cast<uint8_t>(result[pos] + delta);
+                break;
+            }
+            case 3: { // Splice with another corpus entry
+                if (const std::vector<uint8_t>* splice = pick_splice()) {
+                    const auto& other = *splice;
+                    size_t min_size = std::min(result.size(), other.size());
+                    if (min_size > 0) {
+                        size_t split = rng() % min_size;
+                        std::copy(other.begin(), other.begin() + split, result.begin());
+                    }
+                }
+                break;
+            }
+            case 4: { // Interesting values for specific fields
+                // Target the rngseed field (first 4 bytes) with interesting values
+                if (result.size() >= 4) {
+                    uint32_t interesting_seeds[] = {0, 1, 0xFFFFFFFF, 0x12345678, 0xDEADBEEF};
+                    uint32_t seed = interesting_seeds[rng() % 5];
+                    result[0] = (seed >> 0) & 0xFF;
+                    result[1] = (seed >> 8) & 0xFF;
+                    result[2] = (seed >> 16) & 0xFF;
+                    result[3] = (seed >> 24) & 0xFF;
+                }
+                break;
+            }
+            case 5: { // Insert a decision, shifting the later ones by one
+                if (result.size() - MIN_SIZE < MAX_MUTATED_DECISIONS) {
+                    size_t pos = MIN_SIZE + rng() % (result.size() - MIN_SIZE + 1);
+                    result.insert(result.begin() + pos, static_cast<uint8_t>(rng() % 256));
+                }
+                break;
+            }
+            case 6: { // Remove a decision
+                if (result.size() > MIN_SIZE) {
+                    size_t pos = MIN_SIZE + rng() % (result.size() - MIN_SIZE);
+                    result.erase(result.begin() + pos);
+                }
+                break;
+            }
+            case 7: { // Append fresh decisions
+                size_t room = MAX_MUTATED_DECISIONS - std::min(result.size() - MIN_SIZE, MAX_MUTATED_DECISIONS);
+                size_t count = std::min<size_t>(1 + rng() % 64, room);
+                for (size_t i = 0; i < count; ++i) {
+                    result.push_back(rng() % 256);
+                }
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace Fuzzer
@@ -0,0 +1,34 @@
+#ifndef _MUTATOR_H_
+#define _MUTATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace Fuzzer {
+
+// Hands out another corpus entry to splice from, or nullptr if there is none.
+using SplicePicker = std::function<const std::vector<uint8_t>*()>;
+
+// How many mutations to stack given how long coverage has been stalled.
+int mutations_for_stall(size_t iterations_since_new_coverage);
+
+// Seed used while the corpus is still empty.
+std::vector<uint8_t> random_input(std::mt19937& rng);
+
+// Applies num_mutations random byte-level mutations to input. Everything is
+// drawn from rng, so fuzzers running on different threads only need their own.
+// With decision_bytes the tail after the parameters is mutated as the
+// simulation's decision stream (bytes inserted, removed, appended); without it
+// the tail is dropped and every decision comes from rng_seed.
+std::vector<uint8_t> mutate(const std::vector<uint8_t>& input, std::mt19937& rng, int num_mutations,
+                            const SplicePicker& pick_splice, bool decision_bytes);
+
+// Longest decision stream mutate() grows an input to.
+constexpr size_t MAX_MUTATED_DECISIONS = 4096;
+
+} // namespace Fuzzer
+
+#endif // _MUTATOR_H_
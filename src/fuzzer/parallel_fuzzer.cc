@@ -0,0 +1,244 @@
+#include "src/fuzzer/parallel_fuzzer.h"
+#include "src/fuzzer/mutator.h"
+#include "src/fuzzer/shrinker.h"
+#include "src/simulation/simulation_harness.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace Fuzzer {
+
+Coverage::Novelty ShardedCoverage::merge(const Coverage::CoverageMap& run, std::vector<uint64_t>* changed) {
+    Coverage::Novelty novelty = Coverage::Novelty::None;
+    for (size_t shard = 0; shard < NR_SHARDS; ++shard) {
+        std::lock_guard<std::mutex> lock(locks_[shard]);
+        novelty = std::max(novelty, coverage_.merge(run, shard * SHARD_SIZE, (shard + 1) * SHARD_SIZE, changed));
+    }
+    return novelty;
+}
+
+void ShardedCoverage::restore(uint64_t record) {
+    std::lock_guard<std::mutex> lock(locks_[((record >> 8) % Coverage::MAP_SIZE) / SHARD_SIZE]);
+    coverage_.restore(record);
+}
+
+ConcurrentCorpus::ConcurrentCorpus(size_t capacity)
+    : slots_(new std::atomic<const std::vector<uint8_t>*>[capacity]), capacity_(capacity) {
+    for (size_t i = 0; i < capacity_; ++i) {
+        slots_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ConcurrentCorpus::~ConcurrentCorpus() {
+    for (size_t i = 0; i < size(); ++i) {
+        delete slots_[i].load(std::memory_order_relaxed);
+    }
+}
+
+bool ConcurrentCorpus::publish(std::vector<uint8_t> entry) {
+    size_t idx = reserved_.fetch_add(1, std::memory_order_relaxed);
+    if (idx >= capacity_) {
+        return false;
+    }
+    slots_[idx].store(new std::vector<uint8_t>(std::move(entry)), std::memory_order_release);
+    return true;
+}
+
+size_t ConcurrentCorpus::size() const {
+    return std::min(reserved_.load(std::memory_order_acquire), capacity_);
+}
+
+const std::vector<uint8_t>* ConcurrentCorpus::get(size_t idx) const {
+    return slots_[idx].load(std::memory_order_acquire);
+}
+
+void WorkStealingDeque::push(FuzzJob job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+}
+
+std::optional<FuzzJob> WorkStealingDeque::pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (jobs_.empty()) {
+        return std::nullopt;
+    }
+    FuzzJob job = jobs_.back();
+    jobs_.pop_back();
+    return job;
+}
+
+std::optional<FuzzJob> WorkStealingDeque::steal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (jobs_.empty()) {
+        return std::nullopt;
+    }
+    FuzzJob job = jobs_.front();
+    jobs_.pop_front();
+    return job;
+}
+
+ParallelCoverageFuzzer::ParallelCoverageFuzzer(uint32_t seed, int nr_threads)
+    : seed_(seed), nr_threads_(std::max(1, nr_threads)), corpus_(1 << 20) {
+    for (int i = 0; i < nr_threads_; ++i) {
+        deques_.push_back(std::make_unique<WorkStealingDeque>());
+    }
+}
+
+void ParallelCoverageFuzzer::seed_corpus(const std::vector<uint8_t>& initial) {
+    add_to_corpus(initial);
+    execute_and_update(initial);
+}
+
+void ParallelCoverageFuzzer::add_to_corpus(const std::vector<uint8_t>& input) {
+    if (corpus_.publish(input) && store_) {
+        store_->append_entry(input);
+    }
+}
+
+void ParallelCoverageFuzzer::attach_store(CorpusStore* store, bool resume) {
+    if (resume) {
+        for (const auto& entry : store->entries()) {
+            corpus_.publish(entry);
+        }
+        for (uint64_t record : store->coverage()) {
+            coverage_.restore(record);
+        }
+        store_ = store;
+        std::cout << "[Fuzzer] Resumed " << store->entries().size() << " inputs and "
+                  << coverage_.size() << " states" << std::endl;
+        return;
+    }
+    auto seeds = store->entries();
+    store->rewrite({}, {});
+    store_ = store;
+    for (const auto& seed : seeds) {
+        seed_corpus(seed);
+    }
+    std::cout << "[Fuzzer] Re-executed " << seeds.size() << " stored inputs, coverage: "
+              << coverage_.size() << " states" << std::endl;
+}
+
+bool ParallelCoverageFuzzer::execute_and_update(const std::vector<uint8_t>& input) {
+    Simulation::SimulationResult result = Simulation::run_simulation(input);
+    executions_.fetch_add(1, std::memory_order_relaxed);
+
+    if (result.oracle_violation) {
+        std::lock_guard<std::mutex> lock(violation_mutex_);
+        if (!found_violation_.exchange(true)) {
+            violation_input_ = input;
+            violation_message_ = result.error_message;
+        }
+        return false;
+    }
+
+    std::vector<uint64_t> changed;
+    Coverage::Novelty novelty = coverage_.merge(result.coverage, store_ ? &changed : nullptr);
+    if (store_) {
+        store_->append_coverage(changed);
+    }
+    return novelty != Coverage::Novelty::None;
+}
+
+std::optional<FuzzJob> ParallelCoverageFuzzer::next_job(int worker_id) {
+    if (auto job = deques_[worker_id]->pop()) {
+        return job;
+    }
+    for (int i = 1; i < nr_threads_; ++i) {
+        if (auto job = deques_[(worker_id + i) % nr_threads_]->steal()) {
+            stolen_jobs_.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+void ParallelCoverageFuzzer::worker(int worker_id) {
+    std::mt19937 rng(seed_ + worker_id * 0x9E3779B9u);
+    size_t iterations_since_new_coverage = 0;
+
+    auto pick_splice = [&]() -> const std::vector<uint8_t>* {
+        size_t size = corpus_.size();
+        if (size > 1) {
+            return corpus_.get(rng() % size);
+        }
+        return nullptr;
+    };
+
+    while (!found_violation_.load(std::memory_order_relaxed)) {
+        auto job = next_job(worker_id);
+        if (!job) {
+            break;
+        }
+        for (size_t i = 0; i < job->iterations && !found_violation_.load(std::memory_order_relaxed); ++i) {
+            size_t size = corpus_.size();
+            const std::vector<uint8_t>* base = size > 0 ? corpus_.get(rng() % size) : nullptr;
+            auto base_input = base ? *base : random_input(rng);
+            auto mutated_input = mutate(base_input, rng, mutations_for_stall(iterations_since_new_coverage), pick_splice,
+                                         decision_bytes_);
+
+            if (execute_and_update(mutated_input)) {
+                add_to_corpus(mutated_input);
+                iterations_since_new_coverage = 0;
+            } else {
+                ++iterations_since_new_coverage;
+            }
+        }
+    }
+    running_workers_.fetch_sub(1);
+}
+
+void ParallelCoverageFuzzer::run(size_t iterations) {
+    std::cout << "[Fuzzer] Starting parallel fuzzing run with " << iterations
+              << " iterations on " << nr_threads_ << " threads" << std::endl;
+
+    const size_t JOB_SIZE = 64;
+    for (size_t queued = 0, i = 0; queued < iterations; queued += JOB_SIZE, ++i) {
+        deques_[i % nr_threads_]->push(FuzzJob{std::min(JOB_SIZE, iterations - queued)});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    running_workers_.store(nr_threads_);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nr_threads_; ++i) {
+        workers.emplace_back(&ParallelCoverageFuzzer::worker, this, i);
+    }
+
+    // Progress report
+    auto last_report = start;
+    while (running_workers_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report < std::chrono::seconds(1)) {
+            continue;
+        }
+        last_report = now;
+        std::chrono::duration<double> elapsed = now - start;
+        std::cout << "[Fuzzer] Executions " << executions_.load()
+                  << ", coverage: " << coverage_.size() << " states"
+                  << ", corpus: " << corpus_.size()
+                  << ", exec/s: " << static_cast<size_t>(executions_.load() / elapsed.count())
+                  << std::endl;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (found_violation_) {
+        std::cout << "\n[Fuzzer] Stopping after " << executions_.load()
+                  << " executions due to oracle violation\n";
+        std::cout << violation_message_ << Simulation::to_hex(violation_input_) << "\n" << std::endl;
+        if (shrink_violations_) {
+            std::cout << "[Fuzzer] Shrinking violating input..." << std::endl;
+            std::cout << describe(Shrinker().shrink(violation_input_)) << std::endl;
+        }
+        return;
+    }
+    std::cout << "[Fuzzer] Fuzzing complete - no violations found ("
+              << static_cast<size_t>(executions_.load() / elapsed.count()) << " exec/s, "
+              << stolen_jobs_.load() << " jobs stolen)" << std::endl;
+}
+
+} // namespace Fuzzer
@@ -0,0 +1,112 @@
+#ifndef _PARALLEL_FUZZER_H_
+#define _PARALLEL_FUZZER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "src/coverage/coverage_map.h"
+#include "src/fuzzer/corpus_store.h"
+
+namespace Fuzzer {
+
+// Global coverage map split into independently locked ranges, so workers
+// merging their runs rarely wait on each other for long.
+class ShardedCoverage {
+private:
+    static constexpr size_t NR_SHARDS = 64;
+    static constexpr size_t SHARD_SIZE = Coverage::MAP_SIZE / NR_SHARDS;
+    Coverage::GlobalCoverage coverage_;
+    std::array<std::mutex, NR_SHARDS> locks_;
+public:
+    // Merges a classified run shard by shard; changed as in GlobalCoverage::merge.
+    Coverage::Novelty merge(const Coverage::CoverageMap& run, std::vector<uint64_t>* changed = nullptr);
+    void restore(uint64_t record);
+    size_t size() const { return coverage_.covered(); }
+};
+
+// Append-only corpus. Entries are published with a single atomic store into a
+// preallocated slot, so readers never lock and never see a half-written entry.
+class ConcurrentCorpus {
+private:
+    std::unique_ptr<std::atomic<const std::vector<uint8_t>*>[]> slots_;
+    size_t capacity_;
+    std::atomic<size_t> reserved_{0};
+public:
+    explicit ConcurrentCorpus(size_t capacity);
+    ~ConcurrentCorpus();
+    // Returns false when the corpus is full.
+    bool publish(std::vector<uint8_t> entry);
+    size_t size() const;
+    // nullptr if the slot is reserved but not yet published.
+    const std::vector<uint8_t>* get(size_t idx) const;
+};
+
+// A batch of fuzzing iterations.
+struct FuzzJob {
+    size_t iterations;
+};
+
+// Per-worker job deque: the owner works from the back, thieves take from the front.
+class WorkStealingDeque {
+private:
+    std::mutex mutex_;
+    std::deque<FuzzJob> jobs_;
+public:
+    void push(FuzzJob job);
+    std::optional<FuzzJob> pop();
+    std::optional<FuzzJob> steal();
+};
+
+// Runs CoverageFuzzer's mutate/execute loop on several threads. Each worker owns
+// its RNG and runs its own simulations; they only share the coverage shards and
+// the corpus.
+class ParallelCoverageFuzzer {
+private:
+    uint32_t seed_;
+    int nr_threads_;
+    ShardedCoverage coverage_;
+    ConcurrentCorpus corpus_;
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques_;
+    std::atomic<size_t> executions_{0};
+    std::atomic<size_t> stolen_jobs_{0};
+    std::atomic<int> running_workers_{0};
+
+    std::atomic<bool> found_violation_{false};
+    std::mutex violation_mutex_;
+    std::vector<uint8_t> violation_input_;
+    std::string violation_message_;
+    bool shrink_violations_ = true;
+    bool decision_bytes_ = false;
+
+    CorpusStore* store_ = nullptr;
+
+    void worker(int worker_id);
+    void add_to_corpus(const std::vector<uint8_t>& input);
+    std::optional<FuzzJob> next_job(int worker_id);
+    bool execute_and_update(const std::vector<uint8_t>& input);
+public:
+    ParallelCoverageFuzzer(uint32_t seed, int nr_threads);
+
+    void seed_corpus(const std::vector<uint8_t>& initial);
+    // Same contract as CoverageFuzzer::attach_store; the store is shared by all workers.
+    void attach_store(CorpusStore* store, bool resume);
+    void set_shrink_violations(bool enabled) { shrink_violations_ = enabled; }
+    void set_decision_bytes(bool enabled) { decision_bytes_ = enabled; }
+    void run(size_t iterations);
+
+    size_t coverage_count() const { return coverage_.size(); }
+    size_t corpus_size() const { return corpus_.size(); }
+    size_t executions() const { return executions_.load(); }
+    size_t stolen_jobs() const { return stolen_jobs_.load(); }
+    bool has_violation() const { return found_violation_.load(); }
+};
+
+} // namespace Fuzzer
+
+#endif // _PARALLEL_FUZZER_H_
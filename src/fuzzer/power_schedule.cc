@@ -0,0 +1,142 @@
+#include "src/fuzzer/power_schedule.h"
+#include "src/coverage/coverage_map.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Fuzzer {
+
+PowerSchedule parse_power_schedule(const std::string& name) {
+    if (name == "uniform") {
+        return PowerSchedule::Uniform;
+    }
+    if (name == "explore") {
+        return PowerSchedule::Explore;
+    }
+    if (name == "fast") {
+        return PowerSchedule::Fast;
+    }
+    if (name == "rare") {
+        return PowerSchedule::Rare;
+    }
+    throw std::runtime_error("Unknown power schedule: " + name);
+}
+
+const char* schedule_name(PowerSchedule schedule) {
+    switch (schedule) {
+        case PowerSchedule::Uniform: return "uniform";
+        case PowerSchedule::Explore: return "explore";
+        case PowerSchedule::Fast: return "fast";
+        case PowerSchedule::Rare: return "rare";
+    }
+    return "unknown";
+}
+
+PowerScheduler::PowerScheduler(PowerSchedule schedule)
+    : schedule_(schedule), slot_hits_(Coverage::MAP_SIZE, 0) {}
+
+void PowerScheduler::add_entry(EntryMetadata entry) {
+    total_steps_ += entry.steps;
+    total_states_ += entry.slots.size();
+    max_fitness_ = std::max(max_fitness_, entry.fitness);
+    total_fitness_ += entry.fitness;
+    entries_.push_back(std::move(entry));
+}
+
+void PowerScheduler::record_hits(const std::vector<uint32_t>& slots) {
+    for (uint32_t slot : slots) {
+        if (slot_hits_[slot]++ == 0) {
+            ++hit_slots_;
+        }
+    }
+    total_hits_ += slots.size();
+}
+
+uint32_t PowerScheduler::rarest_hits(const EntryMetadata& entry) const {
+    uint32_t rarest = UINT32_MAX;
+    for (uint32_t slot : entry.slots) {
+        rarest = std::min(rarest, hits(slot));
+    }
+    return std::max<uint32_t>(rarest, 1);
+}
+
+uint32_t PowerScheduler::energy(size_t idx) const {
+    const EntryMetadata& entry = entries_[idx];
+    double score = 100.0;
+
+    if (schedule_ != PowerSchedule::Rare) {
+        // AFL's calculate_score, with steps standing in for exec time and
+        // states for bitmap size
+        double avg_steps = static_cast<double>(total_steps_) / entries_.size();
+        double avg_states = static_cast<double>(total_states_) / entries_.size();
+        double steps = entry.steps;
+        if (steps * 0.1 > avg_steps) score = 10;
+        else if (steps * 0.25 > avg_steps) score = 25;
+        else if (steps * 0.5 > avg_steps) score = 50;
+        else if (steps * 0.75 > avg_steps) score = 75;
+        else if (steps * 4 < avg_steps) score = 300;
+        else if (steps * 3 < avg_steps) score = 200;
+        else if (steps * 2 < avg_steps) score = 150;
+
+        double states = entry.slots.size();
+        if (states * 0.3 > avg_states) score *= 3;
+        else if (states * 0.5 > avg_states) score *= 2;
+        else if (states * 0.75 > avg_states) score *= 1.5;
+        else if (states * 3 < avg_states) score *= 0.25;
+        else if (states * 2 < avg_states) score *= 0.5;
+        else if (states * 1.5 < avg_states) score *= 0.75;
+    }
+
+    // Entries without metadata (resumed from disk) count as average
+    double factor = 1.0;
+    if (!entry.slots.empty() && hit_slots_ > 0) {
+        double mean_hits = static_cast<double>(total_hits_) / hit_slots_;
+        double relative = rarest_hits(entry) / mean_hits;
+        if (schedule_ == PowerSchedule::Fast) {
+            factor = std::pow(2.0, std::min<uint32_t>(entry.times_picked, 16)) / relative;
+        } else if (schedule_ == PowerSchedule::Rare) {
+            factor = 1.0 / relative;
+        }
+    }
+    factor = std::clamp(factor, 1.0 / 16, 16.0);
+
+    double mutants = std::round(BASE_ENERGY * score / 100.0 * factor * fitness_boost(idx));
+    return static_cast<uint32_t>(std::clamp(mutants, 1.0, static_cast<double>(MAX_ENERGY)));
+}
+
+double PowerScheduler::fitness_boost(size_t idx) const {
+    if (max_fitness_ == 0) {
+        return 1.0;
+    }
+    return 1.0 + 3.0 * entries_[idx].fitness / max_fitness_;
+}
+
+size_t PowerScheduler::pick_by_fitness(std::mt19937& rng) const {
+    // Weights scaled by max_fitness_ to stay integral: max + 3 * fitness
+    uint64_t total = entries_.size() * static_cast<uint64_t>(max_fitness_) + 3 * total_fitness_;
+    uint64_t point = std::uniform_int_distribution<uint64_t>(0, total - 1)(rng);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        uint64_t weight = max_fitness_ + 3 * static_cast<uint64_t>(entries_[i].fitness);
+        if (point < weight) {
+            return i;
+        }
+        point -= weight;
+    }
+    return entries_.size() - 1;
+}
+
+size_t PowerScheduler::next(std::mt19937& rng) {
+    if (schedule_ == PowerSchedule::Uniform) {
+        return max_fitness_ == 0 ? rng() % entries_.size() : pick_by_fitness(rng);
+    }
+    if (remaining_ == 0) {
+        current_ = cursor_ % entries_.size();
+        cursor_ = current_ + 1;
+        remaining_ = energy(current_);
+        ++entries_[current_].times_picked;
+    }
+    --remaining_;
+    return current_;
+}
+
+} // namespace Fuzzer
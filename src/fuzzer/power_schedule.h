@@ -0,0 +1,92 @@
+#ifndef _POWER_SCHEDULE_H_
+#define _POWER_SCHEDULE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Fuzzer {
+
+// How much effort each corpus entry gets:
+//   uniform  entries picked uniformly at random, one mutant each
+//   explore  AFL's baseline score: cheap runs and entries reaching many states
+//            get more mutants
+//   fast     explore, scaled by 2^(times picked) / (how often the entry's
+//            rarest state has been hit), as in AFLFast
+//   rare     ignores cost and size, scales only by how rare the entry's rarest
+//            state is across the campaign
+enum class PowerSchedule { Uniform, Explore, Fast, Rare };
+
+// Throws std::runtime_error on an unknown name.
+PowerSchedule parse_power_schedule(const std::string& name);
+const char* schedule_name(PowerSchedule schedule);
+
+struct EntryMetadata {
+    // Wall time of the run that added the entry (0 if unknown, e.g. forked or resumed)
+    uint64_t exec_us = 0;
+    // Simulation steps of that run; the scheduler's cost measure, since unlike
+    // wall time it keeps a campaign reproducible from its seed
+    int steps = 0;
+    // Coverage map slots (see Coverage::CoverageMap) the run hit
+    std::vector<uint32_t> slots;
+    // Times the entry was picked as the base of a round of mutants
+    uint32_t times_picked = 0;
+    // How close the run came to a violation (Oracle::fitness), when the
+    // campaign is fitness guided; 0 otherwise
+    int fitness = 0;
+};
+
+// Keeps per-entry metadata and campaign-wide slot hit counts, and decides
+// which corpus entry to mutate next. Non-uniform schedules go through the
+// corpus in order, giving each entry a round of energy() mutants. Once some
+// entry has a fitness, entries are favoured by up to 4x in proportion to
+// theirs: picked more often under uniform, given more energy otherwise.
+class PowerScheduler {
+private:
+    PowerSchedule schedule_;
+    std::vector<EntryMetadata> entries_;
+    // Executions that hit each coverage slot, and how many slots were ever hit
+    std::vector<uint32_t> slot_hits_;
+    size_t hit_slots_ = 0;
+    uint64_t total_hits_ = 0;
+    uint64_t total_steps_ = 0;
+    uint64_t total_states_ = 0;
+    int max_fitness_ = 0;
+    uint64_t total_fitness_ = 0;
+    // Next entry to get a round, the entry whose round is running, and the mutants left in it
+    size_t cursor_ = 0;
+    size_t current_ = 0;
+    uint32_t remaining_ = 0;
+
+    // Executions that hit the rarest slot entry reaches (at least 1).
+    uint32_t rarest_hits(const EntryMetadata& entry) const;
+    // Uniform pick weighted by fitness_boost()
+    size_t pick_by_fitness(std::mt19937& rng) const;
+public:
+    // Mutants per round for an average entry under explore.
+    static constexpr uint32_t BASE_ENERGY = 4;
+    static constexpr uint32_t MAX_ENERGY = 64;
+
+    explicit PowerScheduler(PowerSchedule schedule = PowerSchedule::Uniform);
+
+    PowerSchedule schedule() const { return schedule_; }
+    void add_entry(EntryMetadata entry);
+    // Counts one execution reaching each of slots.
+    void record_hits(const std::vector<uint32_t>& slots);
+    // Index of the corpus entry to mutate next. The corpus must not be empty.
+    size_t next(std::mt19937& rng);
+
+    // Mutants the entry gets in its next round.
+    uint32_t energy(size_t idx) const;
+    // 1, up to 4 for the fittest entry; 1 for all while none has a fitness
+    double fitness_boost(size_t idx) const;
+    uint32_t hits(uint32_t slot) const { return slot_hits_[slot]; }
+    size_t size() const { return entries_.size(); }
+    const EntryMetadata& entry(size_t idx) const { return entries_[idx]; }
+};
+
+} // namespace Fuzzer
+
+#endif // _POWER_SCHEDULE_H_
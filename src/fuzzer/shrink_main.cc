@@ -0,0 +1,24 @@
+#include "src/fuzzer/shrinker.h"
+#include "src/simulation/fuzz_input.h"
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <violating input as hex> [max executions]" << std::endl;
+        return 1;
+    }
+    int max_executions = 2000;
+    if (argc > 2) {
+        max_executions = std::stoi(argv[2]);
+    }
+
+    Fuzzer::Shrinker shrinker(Simulation::run_simulation, max_executions);
+    try {
+        std::cout << Fuzzer::describe(shrinker.shrink(Simulation::from_hex(argv[1])));
+    } catch (const std::invalid_argument& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "src/fuzzer/shrinker.h"
+#include <stdexcept>
+#include <string>
+
+namespace Fuzzer {
+
+Shrinker::Shrinker(Runner runner, int max_executions)
+    : runner_(std::move(runner)), max_executions_(max_executions) {}
+
+bool Shrinker::reproduces(const Simulation::FuzzInput& candidate) {
+    if (executions_ >= max_executions_) {
+        return false;
+    }
+    ++executions_;
+    auto result = runner_(candidate.to_bytes());
+    if (!result.oracle_violation || result.violated_invariant != invariant_) {
+        return false;
+    }
+    violation_step_ = result.steps;
+    return true;
+}
+
+bool Shrinker::shrink_steps(Simulation::FuzzInput& input) {
+    // Nothing after the violating step matters, so that step is the natural bound.
+    Simulation::FuzzInput candidate = input;
+    candidate.max_steps = violation_step_;
+    candidate.normalize();
+    if (candidate.max_steps >= input.max_steps) {
+        return false;
+    }
+    if (reproduces(candidate)) {
+        input = candidate;
+        return true;
+    }
+    // Only reachable if the run is sensitive to its step budget; fall back to
+    // binary search for the smallest budget that still reproduces.
+    int lo = candidate.max_steps + 1, hi = input.max_steps;
+    bool progressed = false;
+    while (lo < hi) {
+        candidate = input;
+        candidate.max_steps = lo + (hi - lo) / 2;
+        candidate.normalize();
+        if (reproduces(candidate)) {
+            input = candidate;
+            hi = candidate.max_steps;
+            progressed = true;
+        } else {
+            lo = candidate.max_steps + 1;
+        }
+    }
+    return progressed;
+}
+
+bool Shrinker::shrink_field(Simulation::FuzzInput& input, int Simulation::FuzzInput::* field, int lower_bound) {
+    bool progressed = false;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        int current = input.*field;
+        // Try the boldest reduction first, then back off by halves
+        for (int delta = current - lower_bound; delta >= 1; delta /= 2) {
+            Simulation::FuzzInput candidate = input;
+            candidate.*field = current - delta;
+            candidate.normalize();
+            if (candidate.*field >= current) {
+                continue;
+            }
+            if (reproduces(candidate)) {
+                input = candidate;
+                improved = progressed = true;
+                break;
+            }
+        }
+    }
+    return progressed;
+}
+
+bool Shrinker::drop_branch(Simulation::FuzzInput& input) {
+    if (input.branch_step == 0) {
+        return false;
+    }
+    Simulation::FuzzInput candidate = input;
+    candidate.branch_step = 0;
+    candidate.branch_seed = 0;
+    if (reproduces(candidate)) {
+        input = candidate;
+        return true;
+    }
+    return false;
+}
+
+bool Shrinker::shrink_decisions(Simulation::FuzzInput& input) {
+    bool progressed = false;
+    bool improved = true;
+    while (improved && !input.decisions.empty()) {
+        improved = false;
+        size_t current = input.decisions.size();
+        // Same back-off as shrink_field, over the number of decisions kept
+        for (size_t drop = current; drop >= 1; drop /= 2) {
+            Simulation::FuzzInput candidate = input;
+            candidate.decisions.resize(current - drop);
+            if (reproduces(candidate)) {
+                input = candidate;
+                improved = progressed = true;
+                break;
+            }
+        }
+    }
+    return progressed;
+}
+
+ShrinkResult Shrinker::shrink(const std::vector<uint8_t>& input) {
+    executions_ = 1;
+    auto original = runner_(input);
+    if (!original.oracle_violation) {
+        throw std::invalid_argument("Input to shrink does not violate any invariant");
+    }
+    invariant_ = original.violated_invariant;
+    violation_step_ = original.steps;
+
+    Simulation::FuzzInput current = Simulation::FuzzInput::from_bytes(input.data(), input.size());
+    if (!reproduces(current)) {
+        // Normalizing the parameters changed the run: nothing here can shrink it safely
+        return ShrinkResult{input, current, invariant_, violation_step_, executions_};
+    }
+
+    bool progressed = true;
+    while (progressed && executions_ < max_executions_) {
+        progressed = false;
+        progressed |= shrink_steps(current);
+        progressed |= shrink_field(current, &Simulation::FuzzInput::nr_nodes, 3);
+        progressed |= shrink_field(current, &Simulation::FuzzInput::max_network_delay, 1);
+        progressed |= shrink_field(current, &Simulation::FuzzInput::election_timeout_min, 50);
+        progressed |= shrink_field(current, &Simulation::FuzzInput::election_timeout_max, 0);
+        progressed |= shrink_field(current, &Simulation::FuzzInput::heartbeat_interval, 10);
+        progressed |= drop_branch(current);
+        progressed |= shrink_decisions(current);
+    }
+    shrink_steps(current);
+
+    return ShrinkResult{current.to_bytes(), current, invariant_, violation_step_, executions_};
+}
+
+std::string describe(const ShrinkResult& result) {
+    const auto& p = result.parameters;
+    std::string msg = "";
+    msg+= "=== Minimal Reproduction ===\n";
+    msg+= "invariant:            " + result.invariant + "\n";
+    msg+= "violation_step:       " + std::to_string(result.violation_step) + "\n";
+    msg+= "rng_seed:             " + std::to_string(p.rng_seed) + "\n";
+    msg+= "nr_nodes:             " + std::to_string(p.nr_nodes) + "\n";
+    msg+= "election_timeout_min: " + std::to_string(p.election_timeout_min) + "\n";
+    msg+= "election_timeout_max: " + std::to_string(p.election_timeout_max) + "\n";
+    msg+= "heartbeat_interval:   " + std::to_string(p.heartbeat_interval) + "\n";
+    msg+= "max_network_delay:    " + std::to_string(p.max_network_delay) + "\n";
+    msg+= "max_steps:            " + std::to_string(p.max_steps) + "\n";
+    msg+= "branch_step:          " + std::to_string(p.branch_step) + "\n";
+    msg+= "branch_seed:          " + std::to_string(p.branch_seed) + "\n";
+    msg+= "decision_bytes:       " + std::to_string(p.decisions.size()) + "\n";
+    msg+= "input (hex):          " + Simulation::to_hex(result.input) + "\n";
+    msg+= "shrinking executions: " + std::to_string(result.executions) + "\n";
+    return msg;
+}
+
+} // namespace Fuzzer
@@ -0,0 +1,58 @@
+#ifndef _SHRINKER_H_
+#define _SHRINKER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+
+namespace Fuzzer {
+
+struct ShrinkResult {
+    std::vector<uint8_t> input;
+    Simulation::FuzzInput parameters;
+    std::string invariant;
+    // Step at which the shrunk input violates the invariant
+    int violation_step = 0;
+    // Simulations run while shrinking, the initial reproduction included
+    int executions = 0;
+};
+
+// Reduces a violating input to a smaller reproduction of the same violation.
+// Each candidate is re-run in-process and only kept if it still violates the
+// same invariant. Passes, repeated until none of them makes progress:
+//   - max_steps down to the violation step (binary search if that misses)
+//   - nr_nodes, network delay, election timeouts and heartbeat interval down
+//     towards their lower bounds
+//   - dropping the branch point
+//   - cutting the decision stream short (the seeded RNG takes over earlier)
+class Shrinker {
+public:
+    using Runner = std::function<Simulation::SimulationResult(const std::vector<uint8_t>&)>;
+private:
+    Runner runner_;
+    int max_executions_;
+    int executions_ = 0;
+    std::string invariant_;
+    int violation_step_ = 0;
+
+    // Runs candidate; true if it reproduces the violation.
+    bool reproduces(const Simulation::FuzzInput& candidate);
+    bool shrink_steps(Simulation::FuzzInput& input);
+    bool shrink_field(Simulation::FuzzInput& input, int Simulation::FuzzInput::* field, int lower_bound);
+    bool drop_branch(Simulation::FuzzInput& input);
+    bool shrink_decisions(Simulation::FuzzInput& input);
+public:
+    explicit Shrinker(Runner runner = Simulation::run_simulation, int max_executions = 2000);
+
+    // Throws std::invalid_argument if input does not violate anything.
+    ShrinkResult shrink(const std::vector<uint8_t>& input);
+};
+
+std::string describe(const ShrinkResult& result);
+
+} // namespace Fuzzer
+
+#endif // _SHRINKER_H_
@@ -0,0 +1,17 @@
+#include "src/fuzzer/state_feedback.h"
+
+namespace Fuzzer {
+
+void export_state_feedback(const Simulation::SimulationResult& result, uint8_t* counters, size_t size) {
+    if (counters == nullptr || size == 0) {
+        return;
+    }
+    for (uint32_t slot : result.coverage.slots()) {
+        uint8_t& counter = counters[slot % size];
+        if (counter < 255) {
+            counter++;
+        }
+    }
+}
+
+} // namespace Fuzzer
@@ -0,0 +1,18 @@
+#ifndef _STATE_FEEDBACK_H_
+#define _STATE_FEEDBACK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "src/simulation/simulation_harness.h"
+
+namespace Fuzzer {
+
+// Folds the cluster states a run visited into an 8-bit counter map, so external
+// engines (libFuzzer extra counters, the AFL++ shared map) see a new Raft state
+// as new coverage even when no new code edge was taken. counters must be
+// reserved for states: anything else counting there would alias them.
+void export_state_feedback(const Simulation::SimulationResult& result, uint8_t* counters, size_t size);
+
+} // namespace Fuzzer
+
+#endif // _STATE_FEEDBACK_H_
@@ -0,0 +1,108 @@
+#ifndef _COALESCER_H_
+#define _COALESCER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/io/messages.h"
+#include "src/io/network.h"
+
+namespace IO {
+
+// Coalesces heartbeats between hosts, the way multi-Raft systems such as
+// CockroachDB do: AppendEntries requests and responses (which only carry
+// heartbeats in this model) going from one host to another are held back and
+// sent as a single HEARTBEAT_BATCH message at the end of each window. Each
+// host has one flush timer, shared by every Raft group it hosts and armed
+// only while it has something to send. Everything else, and traffic between
+// replicas on the same host, goes out unchanged.
+template<typename NetworkT>
+class BasicHeartbeatCoalescer : public Outbox {
+private:
+    std::shared_ptr<NetworkT> network_;
+    std::shared_ptr<Clock::Clock> clock_;
+    std::shared_ptr<Executor::Executor> executor_;
+    std::vector<int> host_of_;
+    int window_;
+    // (from host, to host) -> heartbeats waiting for the next flush
+    std::map<std::pair<int, int>, std::vector<Envelope>> pending_;
+    std::vector<uint8_t> flush_armed_;
+    // Batches get negative ids, so they never clash with RPC ids
+    int next_batch_id_ = -1;
+    size_t batches_sent_ = 0;
+    size_t heartbeats_batched_ = 0;
+public:
+    // host_of maps node ids to hosts 0 .. max(host_of); flushes happen every
+    // window ticks.
+    BasicHeartbeatCoalescer(std::shared_ptr<NetworkT> network, std::shared_ptr<Clock::Clock> clock,
+                            std::shared_ptr<Executor::Executor> executor, std::vector<int> host_of, int window);
+
+    bool hold(const Envelope& msg) override;
+    // Sends one batch per destination for everything host has held back.
+    void flush(int host);
+
+    size_t batches_sent() const { return batches_sent_; }
+    size_t heartbeats_batched() const { return heartbeats_batched_; }
+};
+
+template<typename NetworkT>
+BasicHeartbeatCoalescer<NetworkT>::BasicHeartbeatCoalescer(std::shared_ptr<NetworkT> network,
+                                                           std::shared_ptr<Clock::Clock> clock,
+                                                           std::shared_ptr<Executor::Executor> executor,
+                                                           std::vector<int> host_of, int window)
+    : network_(std::move(network)),
+      clock_(std::move(clock)),
+      executor_(std::move(executor)),
+      host_of_(std::move(host_of)),
+      window_(window) {
+    if (window_ <= 0 || host_of_.empty()) {
+        throw std::invalid_argument("Heartbeat coalescing needs hosts and a positive window");
+    }
+    flush_armed_.assign(*std::max_element(host_of_.begin(), host_of_.end()) + 1, 0);
+}
+
+template<typename NetworkT>
+bool BasicHeartbeatCoalescer<NetworkT>::hold(const Envelope& msg) {
+    if (!std::holds_alternative<AppendEntriesRequest>(msg.content) &&
+        !std::holds_alternative<AppendEntriesResponse>(msg.content)) {
+        return false;
+    }
+    int from = host_of_[msg.from];
+    int to = host_of_[msg.to];
+    if (from == to) {
+        return false;
+    }
+    pending_[{from, to}].push_back(msg);
+    if (!flush_armed_[from]) {
+        flush_armed_[from] = 1;
+        // Aligned to the window, so every host flushes on the same ticks
+        long long next = (clock_->now() / window_ + 1) * window_;
+        executor_->push_task_for(Executor::NO_OWNER, [this, from]() { flush(from); }, next);
+    }
+    return true;
+}
+
+template<typename NetworkT>
+void BasicHeartbeatCoalescer<NetworkT>::flush(int host) {
+    flush_armed_[host] = 0;
+    auto it = pending_.lower_bound({host, 0});
+    while (it != pending_.end() && it->first.first == host) {
+        heartbeats_batched_ += it->second.size();
+        ++batches_sent_;
+        network_->transmit(Envelope{next_batch_id_--, host, it->first.second,
+                                    HeartbeatBatch{std::move(it->second)}});
+        it = pending_.erase(it);
+    }
+}
+
+using HeartbeatCoalescer = BasicHeartbeatCoalescer<Network>;
+
+} // namespace IO
+
+#endif // _COALESCER_H_
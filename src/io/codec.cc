@@ -0,0 +1,257 @@
+#include "src/io/codec.h"
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+namespace IO {
+
+namespace {
+
+// Largest varint: 32 bits in 7-bit groups
+const size_t MAX_VARINT_BYTES = 5;
+
+uint32_t zigzag(int value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int unzigzag(uint32_t value) {
+    return static_cast<int>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Counts the bytes an encoding takes
+class SizeCounter {
+public:
+    size_t size = 0;
+    void byte(uint8_t) { ++size; }
+};
+
+class BufferWriter {
+private:
+    std::span<uint8_t> out_;
+public:
+    size_t size = 0;
+    explicit BufferWriter(std::span<uint8_t> out) : out_(out) {}
+    void byte(uint8_t value) {
+        if (size == out_.size()) {
+            throw CodecError("Buffer too small to encode message");
+        }
+        out_[size++] = value;
+    }
+};
+
+template<typename Out>
+void put_varint(Out& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.byte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.byte(static_cast<uint8_t>(value));
+}
+
+template<typename Out>
+void put_envelope(Out& out, const Envelope& msg) {
+    out.byte(WIRE_VERSION);
+    put_varint(out, static_cast<uint32_t>(msg.type()));
+    put_varint(out, zigzag(msg.message_id));
+    put_varint(out, zigzag(msg.from));
+    put_varint(out, zigzag(msg.to));
+    std::visit([&](const auto& content) {
+        using T = std::decay_t<decltype(content)>;
+        if constexpr (std::is_same_v<T, AppendEntriesRequest>) {
+            put_varint(out, zigzag(content.term));
+            put_varint(out, zigzag(content.leader_id));
+        } else if constexpr (std::is_same_v<T, AppendEntriesResponse>) {
+            put_varint(out, zigzag(content.term));
+        } else if constexpr (std::is_same_v<T, RequestVoteRequest>) {
+            put_varint(out, zigzag(content.term));
+            put_varint(out, zigzag(content.candidate_id));
+        } else if constexpr (std::is_same_v<T, RequestVoteResponse>) {
+            put_varint(out, zigzag(content.term));
+            out.byte(content.vote_granted ? 1 : 0);
+        } else if constexpr (std::is_same_v<T, HeartbeatBatch>) {
+            put_varint(out, static_cast<uint32_t>(content.messages().size()));
+            for (const auto& inner : content.messages()) {
+                put_varint(out, static_cast<uint32_t>(encoded_size(inner)));
+                put_envelope(out, inner);
+            }
+        }
+    }, msg.content);
+}
+
+void check_encodable(const Envelope& msg) {
+    if (auto batch = std::get_if<HeartbeatBatch>(&msg.content)) {
+        for (const auto& inner : batch->messages()) {
+            if (std::holds_alternative<HeartbeatBatch>(inner.content)) {
+                throw CodecError("Heartbeat batches do not nest");
+            }
+            check_encodable(inner);
+        }
+    }
+}
+
+class Reader {
+private:
+    std::span<const uint8_t> data_;
+    size_t pos_ = 0;
+public:
+    explicit Reader(std::span<const uint8_t> data) : data_(data) {}
+    size_t remaining() const { return data_.size() - pos_; }
+    uint8_t byte() {
+        if (pos_ == data_.size()) {
+            throw CodecError("Truncated message");
+        }
+        return data_[pos_++];
+    }
+    uint32_t varint() {
+        uint64_t value = 0;
+        for (size_t i = 0; i < MAX_VARINT_BYTES; ++i) {
+            uint8_t b = byte();
+            value |= static_cast<uint64_t>(b & 0x7f) << (7 * i);
+            if (!(b & 0x80)) {
+                if (i > 0 && b == 0) {
+                    throw CodecError("Overlong varint");
+                }
+                if (value > std::numeric_limits<uint32_t>::max()) {
+                    throw CodecError("Varint out of range");
+                }
+                return static_cast<uint32_t>(value);
+            }
+        }
+        throw CodecError("Varint too long");
+    }
+    int svarint() { return unzigzag(varint()); }
+    std::span<const uint8_t> bytes(size_t size) {
+        if (size > remaining()) {
+            throw CodecError("Truncated message");
+        }
+        auto result = data_.subspan(pos_, size);
+        pos_ += size;
+        return result;
+    }
+};
+
+} // namespace
+
+size_t encoded_size(const Envelope& msg) {
+    SizeCounter counter;
+    put_envelope(counter, msg);
+    return counter.size;
+}
+
+size_t encode(const Envelope& msg, std::span<uint8_t> out) {
+    check_encodable(msg);
+    BufferWriter writer(out);
+    put_envelope(writer, msg);
+    return writer.size;
+}
+
+std::vector<uint8_t> encode(const Envelope& msg) {
+    std::vector<uint8_t> out(encoded_size(msg));
+    encode(msg, out);
+    return out;
+}
+
+EnvelopeView EnvelopeView::decode(std::span<const uint8_t> frame) {
+    Reader in(frame);
+    EnvelopeView view;
+    uint8_t version = in.byte();
+    if (version != WIRE_VERSION) {
+        throw CodecError("Unsupported wire version " + std::to_string(version));
+    }
+    uint32_t type = in.varint();
+    if (type >= NR_MESSAGE_TYPES) {
+        throw CodecError("Unknown message type " + std::to_string(type));
+    }
+    view.type_ = type;
+    view.message_id_ = in.svarint();
+    view.from_ = in.svarint();
+    view.to_ = in.svarint();
+    switch (view.type_) {
+        case message_type<PingRequest>:
+        case message_type<PingResponse>:
+            break;
+        case message_type<AppendEntriesRequest>:
+        case message_type<RequestVoteRequest>:
+            view.term_ = in.svarint();
+            view.peer_ = in.svarint();
+            break;
+        case message_type<AppendEntriesResponse>:
+            view.term_ = in.svarint();
+            break;
+        case message_type<RequestVoteResponse>: {
+            view.term_ = in.svarint();
+            uint8_t granted = in.byte();
+            if (granted > 1) {
+                throw CodecError("Invalid vote_granted byte");
+            }
+            view.vote_granted_ = granted == 1;
+            break;
+        }
+        case message_type<HeartbeatBatch>: {
+            uint32_t count = in.varint();
+            size_t start = frame.size() - in.remaining();
+            // Validate every entry now, so iterating the view cannot fail
+            for (uint32_t i = 0; i < count; ++i) {
+                auto entry = in.bytes(in.varint());
+                if (EnvelopeView::decode(entry).type() == message_type<HeartbeatBatch>) {
+                    throw CodecError("Heartbeat batches do not nest");
+                }
+            }
+            view.batch_ = BatchView(frame.subspan(start, frame.size() - in.remaining() - start), count);
+            break;
+        }
+    }
+    if (in.remaining() != 0) {
+        throw CodecError("Trailing bytes after message");
+    }
+    return view;
+}
+
+Envelope EnvelopeView::to_envelope() const {
+    Envelope msg{message_id_, from_, to_, PingRequest{}};
+    switch (type_) {
+        case message_type<PingRequest>:
+            break;
+        case message_type<PingResponse>:
+            msg.content = PingResponse{};
+            break;
+        case message_type<AppendEntriesRequest>:
+            msg.content = AppendEntriesRequest{term_, peer_};
+            break;
+        case message_type<AppendEntriesResponse>:
+            msg.content = AppendEntriesResponse{term_};
+            break;
+        case message_type<RequestVoteRequest>:
+            msg.content = RequestVoteRequest{term_, peer_};
+            break;
+        case message_type<RequestVoteResponse>:
+            msg.content = RequestVoteResponse{term_, vote_granted_};
+            break;
+        case message_type<HeartbeatBatch>: {
+            std::vector<Envelope> messages;
+            messages.reserve(batch_.size());
+            for (auto inner : batch_) {
+                messages.push_back(inner.to_envelope());
+            }
+            msg.content = HeartbeatBatch{std::move(messages)};
+            break;
+        }
+    }
+    return msg;
+}
+
+EnvelopeView BatchView::Iterator::operator*() const {
+    Reader in(rest_);
+    return EnvelopeView::decode(in.bytes(in.varint()));
+}
+
+BatchView::Iterator& BatchView::Iterator::operator++() {
+    Reader in(rest_);
+    size_t size = in.varint();
+    in.bytes(size);
+    rest_ = rest_.subspan(rest_.size() - in.remaining());
+    --left_;
+    return *this;
+}
+
+} // namespace IO
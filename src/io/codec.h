@@ -0,0 +1,113 @@
+#ifndef _CODEC_H_
+#define _CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "src/io/messages.h"
+
+namespace IO {
+
+// Binary wire format of an Envelope:
+//
+//   [u8 version][varint type][svarint message_id][svarint from][svarint to][body]
+//
+// varints are LEB128 (7 bits per byte, low bits first) and must be minimal;
+// svarints are zigzag-encoded varints. The type is the content's index in
+// MessageTypes (see messages.h), and the body depends on it:
+//
+//   PING_REQUEST, PING_RESPONSE   (empty)
+//   APPEND_ENTRIES_REQUEST        [svarint term][svarint leader_id]
+//   APPEND_ENTRIES_RESPONSE       [svarint term]
+//   REQUEST_VOTE_REQUEST          [svarint term][svarint candidate_id]
+//   REQUEST_VOTE_RESPONSE         [svarint term][u8 vote_granted]
+//   HEARTBEAT_BATCH               [varint count] count x [varint size][size bytes: an encoded Envelope]
+//
+// A frame is exactly one encoded Envelope: decoding rejects trailing bytes,
+// so the encoding of a message is unique and decode(encode(m)) == m.
+constexpr uint8_t WIRE_VERSION = 1;
+
+class CodecError : public std::runtime_error {
+public:
+    explicit CodecError(const std::string& message) : std::runtime_error(message) {}
+};
+
+// Exact number of bytes encode() writes for msg.
+size_t encoded_size(const Envelope& msg);
+// Encodes msg into out; returns the bytes written. Throws CodecError if out
+// is too small (nothing useful is left in it then).
+size_t encode(const Envelope& msg, std::span<uint8_t> out);
+std::vector<uint8_t> encode(const Envelope& msg);
+
+class EnvelopeView;
+
+// The messages of an encoded HEARTBEAT_BATCH, decoded one at a time from the
+// frame they sit in.
+class BatchView {
+private:
+    std::span<const uint8_t> entries_;
+    size_t count_ = 0;
+public:
+    class Iterator {
+    private:
+        std::span<const uint8_t> rest_;
+        size_t left_;
+    public:
+        Iterator(std::span<const uint8_t> rest, size_t left) : rest_(rest), left_(left) {}
+        EnvelopeView operator*() const;
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return left_ == other.left_; }
+    };
+    BatchView() = default;
+    BatchView(std::span<const uint8_t> entries, size_t count) : entries_(entries), count_(count) {}
+    size_t size() const { return count_; }
+    Iterator begin() const { return Iterator(entries_, count_); }
+    Iterator end() const { return Iterator({}, 0); }
+};
+
+// A decoded frame that does not own or copy it: the header and fixed body
+// fields are read out as plain values, batch contents are left in place
+// (see batch()). The frame must outlive the view.
+class EnvelopeView {
+private:
+    int message_id_ = 0;
+    size_t type_ = 0;
+    int from_ = 0;
+    int to_ = 0;
+    // Fixed fields of the body; unused ones are 0
+    int term_ = 0;
+    int peer_ = 0;
+    bool vote_granted_ = false;
+    BatchView batch_;
+public:
+    // Validates the whole frame, nested batch entries included. Throws
+    // CodecError if it is not exactly one well-formed envelope.
+    static EnvelopeView decode(std::span<const uint8_t> frame);
+
+    int message_id() const { return message_id_; }
+    // Index in MessageTypes, as Envelope::type()
+    size_t type() const { return type_; }
+    int from() const { return from_; }
+    int to() const { return to_; }
+    // Only meaningful for the message types that carry them
+    int term() const { return term_; }
+    // leader_id or candidate_id
+    int peer() const { return peer_; }
+    bool vote_granted() const { return vote_granted_; }
+    // Empty unless type() is message_type<HeartbeatBatch>
+    const BatchView& batch() const { return batch_; }
+
+    // Copies the message out, batch contents included.
+    Envelope to_envelope() const;
+};
+
+inline Envelope decode(std::span<const uint8_t> frame) {
+    return EnvelopeView::decode(frame).to_envelope();
+}
+
+} // namespace IO
+
+#endif // _CODEC_H_
@@ -1,28 +1,40 @@
 #ifndef _MESSAGE_H_
 #define _MESSAGE_H_
 
-#include <variant>
+#include <array>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace IO {
 
-enum MessageName {
-    PING_REQUEST,
-    PING_RESPONSE,
-    APPEND_ENTRIES_REQUEST,
-    APPEND_ENTRIES_RESPONSE,
-    REQUEST_VOTE_REQUEST,
-    REQUEST_VOTE_RESPONSE,
+// What a message does in an RPC: requests are dispatched to a handler of the
+// node they are sent to, responses complete the RPC that sent the request.
+enum class MessageKind {
+    Request,
+    Response,
+    Other,
 };
 
+// Every message type declares its printable name and kind; the rest is
+// generated from MessageTypes below.
 struct PingRequest {
+    static constexpr const char* NAME = "PING_REQUEST";
+    static constexpr MessageKind KIND = MessageKind::Request;
     bool operator==(const PingRequest&) const {return true;};
 };
 struct PingResponse {
+    static constexpr const char* NAME = "PING_RESPONSE";
+    static constexpr MessageKind KIND = MessageKind::Response;
     bool operator==(const PingResponse&) const {return true;};
 };
 
 struct AppendEntriesRequest {
+    static constexpr const char* NAME = "APPEND_ENTRIES_REQUEST";
+    static constexpr MessageKind KIND = MessageKind::Request;
     int term, leader_id;
     bool operator==(const AppendEntriesRequest& other) const {
         return 
@@ -32,11 +44,15 @@ struct AppendEntriesRequest {
 };
 
 struct AppendEntriesResponse {
+    static constexpr const char* NAME = "APPEND_ENTRIES_RESPONSE";
+    static constexpr MessageKind KIND = MessageKind::Response;
     int term;
     bool operator==(const AppendEntriesResponse& other) const {return term==other.term;};
 };
 
 struct RequestVoteRequest {
+    static constexpr const char* NAME = "REQUEST_VOTE_REQUEST";
+    static constexpr MessageKind KIND = MessageKind::Request;
     int term, candidate_id;
     bool operator==(const RequestVoteRequest& other) const {
         return 
@@ -46,6 +62,8 @@ struct RequestVoteRequest {
 };
 
 struct RequestVoteResponse {
+    static constexpr const char* NAME = "REQUEST_VOTE_RESPONSE";
+    static constexpr MessageKind KIND = MessageKind::Response;
     int term;
     bool vote_granted;
     bool operator==(const RequestVoteResponse& other) const {
@@ -55,30 +73,104 @@ struct RequestVoteResponse {
     }
 };
 
-typedef std::variant<
+struct Envelope;
+
+// Heartbeats (AppendEntries requests and responses) between two hosts,
+// coalesced into one message; see HeartbeatCoalescer. The entries live out of
+// line, shared and immutable, so Message is no larger and no costlier to copy
+// for holding a batch.
+struct HeartbeatBatch {
+    static constexpr const char* NAME = "HEARTBEAT_BATCH";
+    static constexpr MessageKind KIND = MessageKind::Other;
+    std::shared_ptr<const std::vector<Envelope>> entries;
+
+    HeartbeatBatch() = default;
+    explicit HeartbeatBatch(std::vector<Envelope> messages);
+    // The batched messages (none for a default-constructed batch)
+    const std::vector<Envelope>& messages() const;
+    bool operator==(const HeartbeatBatch& other) const;
+};
+
+template<typename... Ts>
+struct TypeList {};
+
+// Every message type, once. The position of a type in the list is its index
+// in Message, its tag on the wire (see codec.h) and its entry in the dispatch
+// tables built from the list; new types go at the end.
+using MessageTypes = TypeList<
     PingRequest,
     PingResponse,
     AppendEntriesRequest,
     AppendEntriesResponse,
     RequestVoteRequest,
-    RequestVoteResponse
-> Message;
+    RequestVoteResponse,
+    HeartbeatBatch
+>;
+
+template<typename... Ts>
+std::variant<Ts...> variant_of(TypeList<Ts...>);
+using Message = decltype(variant_of(MessageTypes{}));
+
+constexpr size_t NR_MESSAGE_TYPES = std::variant_size_v<Message>;
 
+template<typename T, typename... Ts>
+constexpr size_t index_in(TypeList<Ts...>) {
+    size_t index = 0;
+    ((std::is_same_v<T, Ts> ? false : (++index, true)) && ...);
+    return index;
+}
+
+// Type index of T: what Message::index() returns for it
+template<typename T>
+constexpr size_t message_type = index_in<T>(MessageTypes{});
+
+template<typename... Ts>
+constexpr std::array<const char*, sizeof...(Ts)> names_of(TypeList<Ts...>) { return {Ts::NAME...}; }
+template<typename... Ts>
+constexpr std::array<MessageKind, sizeof...(Ts)> kinds_of(TypeList<Ts...>) { return {Ts::KIND...}; }
+
+constexpr auto MESSAGE_NAMES = names_of(MessageTypes{});
+constexpr auto MESSAGE_KINDS = kinds_of(MessageTypes{});
+
+// Printable name of a message type (e.g. "APPEND_ENTRIES_REQUEST").
+constexpr const char* message_name(size_t type) {
+    return type < NR_MESSAGE_TYPES ? MESSAGE_NAMES[type] : "UNKNOWN";
+}
+constexpr bool is_request(size_t type) {
+    return type < NR_MESSAGE_TYPES && MESSAGE_KINDS[type] == MessageKind::Request;
+}
+constexpr bool is_response(size_t type) {
+    return type < NR_MESSAGE_TYPES && MESSAGE_KINDS[type] == MessageKind::Response;
+}
+
+// The content says what type of message an envelope holds: type() is its index.
 struct Envelope {
     int message_id;
-    MessageName name;
     int from;
     int to;
     Message content;
+    size_t type() const { return content.index(); }
     bool operator==(const Envelope& other) const {
         return 
             message_id == other.message_id &&
-            name == other.name &&
             from == other.from &&
             to == other.to &&
             content == other.content;
     }
 };
+
+inline HeartbeatBatch::HeartbeatBatch(std::vector<Envelope> messages)
+    : entries(std::make_shared<const std::vector<Envelope>>(std::move(messages))) {}
+
+inline const std::vector<Envelope>& HeartbeatBatch::messages() const {
+    static const std::vector<Envelope> none;
+    return entries ? *entries : none;
+}
+
+inline bool HeartbeatBatch::operator==(const HeartbeatBatch& other) const {
+    return messages() == other.messages();
+}
+
 } // namespace IO
 
 #endif // _NETWORH_H_
\ No newline at end of file
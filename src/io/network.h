@@ -5,52 +5,281 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include "src/io/codec.h"
 #include "src/io/messages.h"
 #include "src/clock/clock.h"
 #include "src/rng/rng.h"
+#include "src/trace/event.h"
 #include <memory>
+#include <stdexcept>
 
 namespace IO {
 
+// A message on the wire, as the network's arrival heap orders it. The
+// envelope itself waits in a slot of its own, so reordering the heap only
+// moves these few bytes.
 struct NetworkItem {
-    IO::Envelope envelope;
     long long int arrival_time;
+    int message_id;
+    uint32_t slot;
     bool operator>(const NetworkItem& other) const {
         if (arrival_time != other.arrival_time) {
             return arrival_time > other.arrival_time;
         }
-        return envelope.message_id > other.envelope.message_id;
+        return message_id > other.message_id;
     }
 };
 
-class Network {
+// An RPC whose request or response the network lost: its caller will not
+// hear back.
+struct LostRpc {
+    int message_id;
+    int caller;
+};
+
+// Capacity of the links messages cross. Every ordered (from, to) pair is a
+// link that serializes one message at a time at bandwidth bytes per tick, in
+// the order they were sent; a message arrives base_latency plus the network's
+// random delay after its last byte left. The default model has infinite
+// bandwidth and no base latency: every message just gets the random delay.
+struct LinkModel {
+    // Bytes per tick; 0: unlimited (no serialization delay, no queueing)
+    int bandwidth = 0;
+    // Ticks added to every message's delay
+    int base_latency = 0;
+    // Bytes of framing charged per message on top of its encoded size
+    int overhead = 0;
+    // Messages a link holds (queued or being serialized) before it drops new
+    // ones; 0: unbounded. Only applies with a bandwidth.
+    int queue_limit = 0;
+
+    bool shaped() const { return bandwidth > 0; }
+};
+
+// Traffic of one link since the network was built.
+struct LinkStats {
+    int from = 0, to = 0;
+    size_t messages = 0;
+    size_t bytes = 0;
+    size_t dropped = 0;
+    // Ticks the link spent serializing messages
+    double busy_ticks = 0;
+    // Ticks messages waited for the messages ahead of them, summed and at most
+    double queueing_delay = 0;
+    double max_queueing_delay = 0;
+
+    double mean_queueing_delay() const { return messages > 0 ? queueing_delay / messages : 0; }
+    // Share of the elapsed ticks the link was busy
+    double utilization(long long elapsed) const { return elapsed > 0 ? busy_ticks / elapsed : 0; }
+};
+
+// Gets first pick of every message pushed to a Network, and may keep some
+// to put on the wire later (through Network::transmit).
+class Outbox {
+public:
+    virtual ~Outbox() = default;
+    // True if the outbox took msg.
+    virtual bool hold(const IO::Envelope& msg) = 0;
+};
+
+// ClockT and RNGT are the clock and RNG types held: the interfaces, or
+// concrete final classes to have delays drawn without virtual calls.
+template<typename ClockT, typename RNGT>
+class BasicNetwork {
 private:
-    std::shared_ptr<Clock::Clock> clock_;
-    std::shared_ptr<RNG::RNG> rng_;
+    std::shared_ptr<ClockT> clock_;
+    std::shared_ptr<RNGT> rng_;
     std::priority_queue<NetworkItem, std::vector<NetworkItem>, std::greater<NetworkItem>> wire_;
+    // Envelopes on the wire, by NetworkItem::slot; free slots are reused
+    std::vector<IO::Envelope> slots_;
+    std::vector<uint32_t> free_slots_;
     int max_delay_;
+    Trace::EventSink* sink_ = nullptr;
+    Outbox* outbox_ = nullptr;
+    size_t messages_sent_ = 0;
+
+    struct Link {
+        LinkStats stats;
+        // Times are kept in bytes (ticks * bandwidth), so serialization of
+        // messages smaller than a tick's worth adds up exactly.
+        long long busy_until = 0;
+        // When each message on the link finishes serializing, oldest first
+        std::deque<long long> in_flight;
+    };
+    LinkModel model_;
+    std::vector<int> host_of_;
+    std::unordered_map<uint64_t, Link> links_;
+    size_t dropped_ = 0;
+    std::vector<LostRpc> lost_;
+
+    // Records the RPCs msg was part of (a batch carries several) as lost.
+    void lose(const IO::Envelope& msg) {
+        if (auto* batch = std::get_if<HeartbeatBatch>(&msg.content)) {
+            for (const auto& inner : batch->messages()) {
+                lose(inner);
+            }
+        } else if (is_request(msg.type())) {
+            lost_.push_back(LostRpc{msg.message_id, msg.from});
+        } else if (is_response(msg.type())) {
+            lost_.push_back(LostRpc{msg.message_id, msg.to});
+        }
+    }
+
+    // Link msg crosses: between the hosts of its ends when nodes are placed
+    // on hosts (heartbeat batches are already addressed host to host).
+    Link& link_of(const IO::Envelope& msg) {
+        int from = msg.from, to = msg.to;
+        if (!host_of_.empty() && !std::holds_alternative<HeartbeatBatch>(msg.content)) {
+            from = host_of_[from];
+            to = host_of_[to];
+        }
+        uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(from)) << 32 | static_cast<uint32_t>(to);
+        auto [it, inserted] = links_.try_emplace(key);
+        if (inserted) {
+            it->second.stats.from = from;
+            it->second.stats.to = to;
+        }
+        return it->second;
+    }
+
+    // Queues msg on its link; returns the tick its last byte leaves, or -1 if
+    // the link is full.
+    long long serialize(const IO::Envelope& msg, long long now) {
+        Link& link = link_of(msg);
+        long long bandwidth = model_.bandwidth;
+        long long start = std::max(now * bandwidth, link.busy_until);
+        while (!link.in_flight.empty() && link.in_flight.front() <= now * bandwidth) {
+            link.in_flight.pop_front();
+        }
+        if (model_.queue_limit > 0 && link.in_flight.size() >= static_cast<size_t>(model_.queue_limit)) {
+            ++link.stats.dropped;
+            return -1;
+        }
+        long long size = static_cast<long long>(encoded_size(msg)) + model_.overhead;
+        link.busy_until = start + size;
+        link.in_flight.push_back(link.busy_until);
+
+        double waited = static_cast<double>(start - now * bandwidth) / bandwidth;
+        ++link.stats.messages;
+        link.stats.bytes += size;
+        link.stats.busy_ticks += static_cast<double>(size) / bandwidth;
+        link.stats.queueing_delay += waited;
+        link.stats.max_queueing_delay = std::max(link.stats.max_queueing_delay, waited);
+        return (link.busy_until + bandwidth - 1) / bandwidth;
+    }
 public:
-    Network(std::shared_ptr<Clock::Clock> clock, std::shared_ptr<RNG::RNG> rng, int max_delay)
+    BasicNetwork(std::shared_ptr<ClockT> clock, std::shared_ptr<RNGT> rng, int max_delay)
         : clock_(clock),
           rng_(rng),
           max_delay_(max_delay) {}
     void push_entry(IO::Envelope msg) {
+        if (outbox_ && outbox_->hold(msg)) {
+            return;
+        }
+        transmit(std::move(msg));
+    }
+    // Puts msg on the wire, bypassing the outbox.
+    void transmit(IO::Envelope msg) {
         int delay = rng_->draw(0, max_delay_);
-        NetworkItem entry = NetworkItem{msg, clock_->now() + delay};
-        wire_.push(entry);
+        long long sent = clock_->now();
+        if (model_.shaped()) {
+            sent = serialize(msg, clock_->now());
+            if (sent < 0) {
+                ++dropped_;
+                lose(msg);
+                if (sink_) {
+                    sink_->on_event(Trace::Event{Trace::EventKind::Drop, clock_->now(), msg.message_id, msg.from, msg.to});
+                }
+                return;
+            }
+        }
+        if (sink_) {
+            sink_->on_event(Trace::Event{Trace::EventKind::Send, clock_->now(), msg.message_id, msg.from, msg.to});
+        }
+        uint32_t slot;
+        if (free_slots_.empty()) {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(std::move(msg));
+        } else {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+            slots_[slot] = std::move(msg);
+        }
+        wire_.push(NetworkItem{sent + model_.base_latency + delay, slots_[slot].message_id, slot});
+        ++messages_sent_;
+    }
+    // Applies to messages transmitted from now on. With host_of (node id to
+    // host), links join hosts rather than nodes, so the replicas on a host
+    // share its links. Throws std::invalid_argument on negative parameters.
+    void set_link_model(LinkModel model, std::vector<int> host_of = {}) {
+        if (model.bandwidth < 0 || model.base_latency < 0 || model.overhead < 0 || model.queue_limit < 0) {
+            throw std::invalid_argument("Link model parameters must not be negative");
+        }
+        model_ = model;
+        host_of_ = std::move(host_of);
     }
+    const LinkModel& link_model() const { return model_; }
+    // Messages a full link refused; they never reach the wire.
+    size_t messages_dropped() const { return dropped_; }
+    // RPCs lost to dropped messages since the last call, for their callers
+    // to stop waiting on.
+    std::vector<LostRpc> fetch_lost() {
+        std::vector<LostRpc> lost;
+        lost.swap(lost_);
+        return lost;
+    }
+    // Stats of every link used so far, in no particular order. Only shaped
+    // links (those with a bandwidth) keep stats.
+    std::vector<LinkStats> link_stats() const {
+        std::vector<LinkStats> stats;
+        stats.reserve(links_.size());
+        for (const auto& [key, link] : links_) {
+            stats.push_back(link.stats);
+        }
+        return stats;
+    }
+    // Messages queued or being serialized on the link from -> to (hosts, if
+    // the model places nodes on hosts). Senders that want backpressure
+    // rather than drops can hold back while this is at the queue limit.
+    size_t link_backlog(int from, int to) const {
+        auto it = links_.find(static_cast<uint64_t>(static_cast<uint32_t>(from)) << 32 | static_cast<uint32_t>(to));
+        if (it == links_.end()) {
+            return 0;
+        }
+        long long now = clock_->now() * static_cast<long long>(model_.bandwidth);
+        const auto& in_flight = it->second.in_flight;
+        return in_flight.end() - std::upper_bound(in_flight.begin(), in_flight.end(), now);
+    }
+    // nullptr to send everything straight away.
+    void set_outbox(Outbox* outbox) { outbox_ = outbox; }
+    // Messages put on the wire so far (a batch counts once).
+    size_t messages_sent() const { return messages_sent_; }
     bool has_messages() {return !wire_.empty();}
+    // Messages on the wire, not yet delivered.
+    size_t in_flight() const { return wire_.size(); }
+    // Reports every send and delivery to sink (nullptr to stop).
+    void set_event_sink(Trace::EventSink* sink) { sink_ = sink; }
     std::vector<IO::Envelope> fetch_ready() {
         std::vector<IO::Envelope> results;
         while(!wire_.empty() && wire_.top().arrival_time <= clock_->now() ) {
-            results.push_back(wire_.top().envelope);
+            uint32_t slot = wire_.top().slot;
             wire_.pop();
+            results.push_back(std::move(slots_[slot]));
+            free_slots_.push_back(slot);
+            if (sink_) {
+                const auto& msg = results.back();
+                sink_->on_event(Trace::Event{Trace::EventKind::Delivery, clock_->now(), msg.message_id, msg.from, msg.to});
+            }
         }
         return results;
     }
     
 };
 
+using Network = BasicNetwork<Clock::Clock, RNG::RNG>;
+
 } // namespace IO
 
 #endif // _NETWORK_H_
\ No newline at end of file
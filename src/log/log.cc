@@ -0,0 +1,42 @@
+#include "src/log/log.h"
+#include <iostream>
+#include <streambuf>
+
+namespace Log {
+
+namespace {
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class NullStream : public std::ostream {
+private:
+    NullBuffer buffer_;
+public:
+    NullStream() : std::ostream(&buffer_) { setstate(std::ios_base::badbit); }
+};
+
+thread_local std::ostream* current_sink = nullptr;
+
+} // namespace
+
+std::ostream& out() {
+    return current_sink ? *current_sink : std::cout;
+}
+
+std::ostream& null_stream() {
+    thread_local NullStream stream;
+    return stream;
+}
+
+ScopedSink::ScopedSink(std::ostream& sink) : previous_(current_sink) {
+    current_sink = &sink;
+}
+
+ScopedSink::~ScopedSink() {
+    current_sink = previous_;
+}
+
+} // namespace Log
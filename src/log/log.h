@@ -0,0 +1,30 @@
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <ostream>
+
+namespace Log {
+
+// Stream the simulation components log to. It is per thread and defaults to
+// std::cout, so concurrent simulations can each be silenced or captured
+// without redirecting the process-wide std::cout.
+std::ostream& out();
+
+// A stream that drops everything. It stays in a failed state, so the
+// operator<< chains writing to it skip the formatting work too.
+std::ostream& null_stream();
+
+// Routes out() to another stream on this thread while in scope.
+class ScopedSink {
+private:
+    std::ostream* previous_;
+public:
+    explicit ScopedSink(std::ostream& sink);
+    ~ScopedSink();
+    ScopedSink(const ScopedSink&) = delete;
+    ScopedSink& operator=(const ScopedSink&) = delete;
+};
+
+} // namespace Log
+
+#endif // _LOG_H_
@@ -0,0 +1,154 @@
+#include "src/memory/memory.h"
+#include <algorithm>
+#include <new>
+
+namespace Memory {
+
+namespace {
+
+thread_local RunMemory* current_run = nullptr;
+
+// Ahead of each frame: the run it is charged to. Kept at max_align_t so the
+// frame itself stays suitably aligned.
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+} // namespace
+
+const char* frame_kind_name(FrameKind kind) {
+    switch (kind) {
+        case FrameKind::MainLoop: return "main_loop";
+        case FrameKind::Heartbeat: return "heartbeat";
+        case FrameKind::AppendEntriesHandler: return "append_entries_handler";
+        case FrameKind::RequestVoteHandler: return "request_vote_handler";
+        case FrameKind::Other: return "other";
+        case FrameKind::COUNT: break;
+    }
+    return "unknown";
+}
+
+size_t Report::live_frames() const {
+    size_t total = 0;
+    for (size_t count : frames_by_kind) {
+        total += count;
+    }
+    return total;
+}
+
+size_t Report::leaks() const {
+    return live_frames() - frames_by_kind[static_cast<size_t>(FrameKind::MainLoop)] + pending_rpcs +
+           unclaimed_responses;
+}
+
+std::string Report::describe() const {
+    std::string msg = "=== Memory Report ===\n";
+    msg += "bytes held:           " + std::to_string(usage.total()) + " (frames " + std::to_string(usage.frames) +
+           ", executor " + std::to_string(usage.executor) + ", network " + std::to_string(usage.network) +
+           ", rpc " + std::to_string(usage.rpc) + ")\n";
+    msg += "peak bytes:           " + std::to_string(peak) + "\n";
+    msg += "live frames:          " + std::to_string(live_frames()) + "\n";
+    for (size_t kind = 0; kind < NR_FRAME_KINDS; ++kind) {
+        if (frames_by_kind[kind] > 0) {
+            msg += "  " + std::string(frame_kind_name(static_cast<FrameKind>(kind))) + ": " +
+                   std::to_string(frames_by_kind[kind]) + "\n";
+        }
+    }
+    msg += "pending rpcs:         " + std::to_string(pending_rpcs) + "\n";
+    msg += "unclaimed responses:  " + std::to_string(unclaimed_responses) + "\n";
+    msg += "leaks:                " + std::to_string(leaks()) + "\n";
+    return msg;
+}
+
+RunMemory::~RunMemory() {
+    destroy_frames();
+}
+
+RunMemory* RunMemory::current() {
+    return current_run;
+}
+
+void RunMemory::frame_started(FrameRecord& frame) {
+    frame.run = this;
+    frame.prev = nullptr;
+    frame.next = frames_;
+    if (frames_) {
+        frames_->prev = &frame;
+    }
+    frames_ = &frame;
+    ++live_by_kind_[static_cast<size_t>(frame.kind)];
+}
+
+void RunMemory::frame_finished(FrameRecord& frame) {
+    if (frame.prev) {
+        frame.prev->next = frame.next;
+    } else {
+        frames_ = frame.next;
+    }
+    if (frame.next) {
+        frame.next->prev = frame.prev;
+    }
+    --live_by_kind_[static_cast<size_t>(frame.kind)];
+    frame.run = nullptr;
+}
+
+void RunMemory::charge(size_t bytes) {
+    frame_bytes_ += bytes;
+    peak_frame_bytes_ = std::max(peak_frame_bytes_, frame_bytes_);
+}
+
+void RunMemory::release(size_t bytes) {
+    frame_bytes_ -= bytes;
+}
+
+void RunMemory::count_frames(Report& report) const {
+    auto& by_node = report.frames_by_node;
+    for (const FrameRecord* frame = frames_; frame; frame = frame->next) {
+        ++report.frames_by_kind[static_cast<size_t>(frame->kind)];
+        by_node.push_back({frame->node, 1});
+    }
+    std::sort(by_node.begin(), by_node.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t kept = 0;
+    for (const auto& entry : by_node) {
+        if (kept > 0 && by_node[kept - 1].first == entry.first) {
+            by_node[kept - 1].second += entry.second;
+        } else {
+            by_node[kept++] = entry;
+        }
+    }
+    by_node.resize(kept);
+}
+
+void RunMemory::destroy_frames() {
+    // Destroying a frame unlinks it (its promise's destructor calls frame_finished)
+    while (frames_) {
+        frames_->handle.destroy();
+    }
+}
+
+ScopedRun::ScopedRun(RunMemory* run) : previous_(current_run) {
+    current_run = run;
+}
+
+ScopedRun::~ScopedRun() {
+    current_run = previous_;
+}
+
+void* allocate_frame(size_t size) {
+    auto* block = static_cast<unsigned char*>(::operator new(HEADER_SIZE + size));
+    RunMemory* run = current_run;
+    *reinterpret_cast<RunMemory**>(block) = run;
+    if (run) {
+        run->charge(size);
+    }
+    return block + HEADER_SIZE;
+}
+
+void free_frame(void* frame, size_t size) {
+    auto* block = static_cast<unsigned char*>(frame) - HEADER_SIZE;
+    RunMemory* run = *reinterpret_cast<RunMemory**>(block);
+    if (run) {
+        run->release(size);
+    }
+    ::operator delete(block);
+}
+
+} // namespace Memory
@@ -0,0 +1,133 @@
+#ifndef _MEMORY_H_
+#define _MEMORY_H_
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Memory {
+
+// What a coroutine frame is for, told apart by the coroutine's signature
+// (see Node::Task::promise_type).
+enum class FrameKind : uint8_t {
+    MainLoop,
+    // Member coroutines taking an int: BasicRaftNode::send_heartbeat, request_vote
+    Heartbeat,
+    AppendEntriesHandler,
+    RequestVoteHandler,
+    Other,
+    COUNT,
+};
+
+constexpr size_t NR_FRAME_KINDS = static_cast<size_t>(FrameKind::COUNT);
+constexpr int NO_NODE = -1;
+
+const char* frame_kind_name(FrameKind kind);
+
+class RunMemory;
+
+// Bookkeeping every tracked coroutine frame carries (in its promise): which
+// run it belongs to and its place in that run's list of live frames.
+struct FrameRecord {
+    RunMemory* run = nullptr;
+    FrameRecord* prev = nullptr;
+    FrameRecord* next = nullptr;
+    std::coroutine_handle<> handle;
+    int node = NO_NODE;
+    FrameKind kind = FrameKind::Other;
+};
+
+// Bytes one simulation holds, by subsystem. Frames are counted exactly (as
+// allocated); the rest are the sizes of the queued entries, not counting
+// what they point to.
+struct Usage {
+    size_t frames = 0;
+    size_t executor = 0;
+    size_t network = 0;
+    size_t rpc = 0;
+
+    size_t total() const { return frames + executor + network + rpc; }
+};
+
+// What a run still holds at its end. Frames left are coroutines that never
+// finished: a node's main loop is expected, anything else is waiting on
+// something that will not come.
+struct Report {
+    Usage usage;
+    // Highest usage.total() seen while the run was being checked against a
+    // budget, or the highest frame bytes otherwise
+    size_t peak = 0;
+    std::array<size_t, NR_FRAME_KINDS> frames_by_kind{};
+    // (node, live frames), nodes with none left out
+    std::vector<std::pair<int, size_t>> frames_by_node;
+    // RPCs whose caller still waits for a response
+    size_t pending_rpcs = 0;
+    // Responses delivered that no caller has picked up
+    size_t unclaimed_responses = 0;
+
+    size_t live_frames() const;
+    // Frames other than main loops, plus RPC entries left behind. After a
+    // run that went quiet these are leaks; after one cut short by its step
+    // budget some are just work still in flight.
+    size_t leaks() const;
+    std::string describe() const;
+};
+
+// Memory accounting of one simulation run: the coroutine frames allocated
+// while it is the thread's current run (see ScopedRun), and the list of
+// those still alive, so they can be reported and reclaimed when the run is
+// torn down.
+class RunMemory {
+private:
+    FrameRecord* frames_ = nullptr;
+    size_t frame_bytes_ = 0;
+    size_t peak_frame_bytes_ = 0;
+    std::array<size_t, NR_FRAME_KINDS> live_by_kind_{};
+public:
+    RunMemory() = default;
+    // Destroys the frames still alive
+    ~RunMemory();
+    RunMemory(const RunMemory&) = delete;
+    RunMemory& operator=(const RunMemory&) = delete;
+
+    // The run frames allocated on this thread are charged to; nullptr if none.
+    static RunMemory* current();
+
+    void frame_started(FrameRecord& frame);
+    void frame_finished(FrameRecord& frame);
+    void charge(size_t bytes);
+    void release(size_t bytes);
+
+    size_t frame_bytes() const { return frame_bytes_; }
+    size_t peak_frame_bytes() const { return peak_frame_bytes_; }
+    size_t live_frames(FrameKind kind) const { return live_by_kind_[static_cast<size_t>(kind)]; }
+    // Adds the live frames to the report's counts, by kind and by node.
+    void count_frames(Report& report) const;
+    // Destroys every frame still alive, suspended or not. Whatever resumes
+    // them (executor tasks, pending RPCs) must be dropped with them.
+    void destroy_frames();
+};
+
+// Makes run the current one on this thread while in scope.
+class ScopedRun {
+private:
+    RunMemory* previous_;
+public:
+    explicit ScopedRun(RunMemory* run);
+    ~ScopedRun();
+    ScopedRun(const ScopedRun&) = delete;
+    ScopedRun& operator=(const ScopedRun&) = delete;
+};
+
+// Frame allocation for coroutine promises: charges the current run, if any,
+// and remembers which run it was so the frame is released to the same one.
+void* allocate_frame(size_t size);
+void free_frame(void* frame, size_t size);
+
+} // namespace Memory
+
+#endif // _MEMORY_H_
@@ -1,10 +1,14 @@
 #ifndef _NODE_H_
 #define _NODE_H_
 
+#include <concepts>
 #include <functional>
+#include <type_traits>
 #include <coroutine>
 #include <exception>
 #include <memory>
+#include "src/memory/memory.h"
+#include "src/node/node_table.h"
 #include "src/system/system.h"
 #include <iostream>
 #include <thread>
@@ -14,31 +18,75 @@ namespace Node {
 
 class Task;
 
-class Node {
+// A simulated process running on the stack Stack (see System::BasicSystem).
+template<typename Stack>
+class BasicNode {
 public:
+    using SystemType = System::BasicSystem<Stack>;
+
     int id_;
-    std::shared_ptr<System::System> system_;
+    std::shared_ptr<SystemType> system_;
     std::vector<IO::Envelope> inbox;
     virtual void dispatch() = 0;
-    Node(int id, std::shared_ptr<System::System> system): id_(id), system_(system) {}
+    BasicNode(int id, std::shared_ptr<SystemType> system): id_(id), system_(system) {}
+    virtual ~BasicNode() = default;
     virtual Task main_loop() = 0;
 };
 
+using Node = BasicNode<System::VirtualStack>;
+
 // todo: get rid of suspendtoscheduler awaitable, make it suspend_always and give the system a
 // enqueue_work method, so we push to the executor a lambda to resume the coroutine
 class Task {
 public:
+    // Frames are charged to the thread's current Memory::RunMemory, if any,
+    // and listed there by node and kind until they finish. The kind comes
+    // from the coroutine's parameters: a node's member taking nothing is its
+    // main loop, one taking a peer id an RPC to it (heartbeat or vote request,
+    // both counted as Heartbeat), one taking a message and
+    // its request that request's handler.
     struct promise_type {
-        std::shared_ptr<System::System> sys_;
-        Task get_return_object() {return Task{std::coroutine_handle<promise_type>::from_promise(*this)};}
-        // this intercepts the same arguments with which the coro is called
-        // Since I am returning the coro from within the node, the compiler automagically
-        // passes a Node& reference to the promise_type constructor.
-        promise_type(Node& node) : sys_(node.system_) {}
+        Memory::FrameRecord frame_;
 
-        template<typename... Args>
-        promise_type(Node& node, Args&&...) : sys_(node.system_) {}
+        promise_type() { track(Memory::NO_NODE, Memory::FrameKind::Other); }
+        template<typename Self>
+            requires requires(Self& self) { { self.id_ } -> std::convertible_to<int>; }
+        explicit promise_type(Self& self) {
+            track(self.id_, Memory::FrameKind::MainLoop);
+        }
+        template<typename Self>
+            requires requires(Self& self) { { self.id_ } -> std::convertible_to<int>; }
+        promise_type(Self& self, int) {
+            track(self.id_, Memory::FrameKind::Heartbeat);
+        }
+        template<typename Self, typename Request>
+            requires requires(Self& self) { { self.id_ } -> std::convertible_to<int>; }
+        promise_type(Self& self, const IO::Envelope&, const Request&) {
+            track(self.id_, std::is_same_v<Request, IO::RequestVoteRequest>
+                                ? Memory::FrameKind::RequestVoteHandler
+                                : Memory::FrameKind::AppendEntriesHandler);
+        }
+        ~promise_type() {
+            if (frame_.run) {
+                frame_.run->frame_finished(frame_);
+            }
+        }
+        void track(int node, Memory::FrameKind kind) {
+            frame_.node = node;
+            frame_.kind = kind;
+            if (auto* run = Memory::RunMemory::current()) {
+                run->frame_started(frame_);
+            }
+        }
 
+        static void* operator new(size_t size) { return Memory::allocate_frame(size); }
+        static void operator delete(void* frame, size_t size) { Memory::free_frame(frame, size); }
+
+        Task get_return_object() {
+            auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+            frame_.handle = handle;
+            return Task{handle};
+        }
         std::suspend_always initial_suspend() {return {};}
         std::suspend_never final_suspend() noexcept {return {};}
         void return_void() {}
@@ -51,42 +99,89 @@ public:
 
 };
 
-enum RaftState {
-    LEADER,
-    FOLLOWER,
-    CANDIDATE,
+// The Raft state of a member of one Raft group: nodes group_first ..
+// group_first + nr_nodes - 1. It lives in row `id` of a NodeTable shared with
+// the rest of the cluster, or in a table of its own when none is given. This
+// is what the oracle and state capture look at, whatever stack the node runs on.
+class RaftReplica {
+private:
+    int replica_id_;
+    int row_;
+    std::shared_ptr<NodeTable> table_;
+protected:
+    int nr_nodes_;
+    int group_first_;
+
+    void set_state(RaftState state) { table_->set_role(row_, state); }
+    void set_term(int term) { table_->set_term(row_, term); }
+    void set_voted_for(std::optional<int> voted_for) { table_->set_voted_for(row_, voted_for); }
+    void set_votes_received(int votes) { table_->set_votes_received(row_, votes); }
+    long long last_heartbeat_time() const { return table_->last_heartbeat(row_); }
+    void set_last_heartbeat_time(long long time) { table_->set_last_heartbeat(row_, time); }
+public:
+    RaftReplica(int id, int nr_nodes, std::shared_ptr<NodeTable> table, int group_first)
+        : replica_id_(id),
+          row_(table ? id : 0),
+          table_(table ? std::move(table) : std::make_shared<NodeTable>(1)),
+          nr_nodes_(nr_nodes),
+          group_first_(group_first) {}
+    virtual ~RaftReplica() = default;
+
+    // Getters for oracle/fuzzer to inspect state
+    int replica_id() const { return replica_id_; }
+    RaftState get_state() const { return table_->role(row_); }
+    int get_term() const { return table_->term(row_); }
+    std::optional<int> get_voted_for() const { return table_->voted_for(row_); }
+    int get_votes_received() const { return table_->votes_received(row_); }
+    const std::shared_ptr<NodeTable>& table() const { return table_; }
+    int group_first() const { return group_first_; }
 };
 
-class RaftNode : public Node {
+template<typename Stack>
+class BasicRaftNode : public BasicNode<Stack>, public RaftReplica {
+public:
+    using BasicNode<Stack>::id_;
+    using BasicNode<Stack>::system_;
+    using BasicNode<Stack>::inbox;
 private:
-    RaftState state_ = FOLLOWER;
-    int term_ = 0;
-    int nr_nodes_;
-    std::optional<int> voted_for_;
-    int votes_received_ = 0;
-    long long last_heartbeat_time_ = 0;
     int election_timeout_min_;
     int election_timeout_max_;
     int heartbeat_interval_;
 public:
-    RaftNode(int id, std::shared_ptr<System::System> sys, int nr_nodes,
-             int election_timeout_min, int election_timeout_max, int heartbeat_interval)
-        : Node(id, sys), nr_nodes_(nr_nodes),
+    BasicRaftNode(int id, std::shared_ptr<typename BasicNode<Stack>::SystemType> sys, int nr_nodes,
+                  int election_timeout_min, int election_timeout_max, int heartbeat_interval,
+                  std::shared_ptr<NodeTable> table = nullptr, int group_first = 0)
+        : BasicNode<Stack>(id, std::move(sys)),
+          RaftReplica(id, nr_nodes, std::move(table), group_first),
           election_timeout_min_(election_timeout_min),
           election_timeout_max_(election_timeout_max),
           heartbeat_interval_(heartbeat_interval) {}
+    // Hands each message in the inbox to its entry in a table generated from
+    // IO::MessageTypes: requests to the handle() overload taking them,
+    // responses to the RPC waiting for them.
     void dispatch() override;
     Task main_loop() override;
-    Task handle_append_entries(IO::Envelope msg);
-    Task handle_request_vote(IO::Envelope msg);
-
-    // Getters for oracle/fuzzer to inspect state
-    RaftState get_state() const { return state_; }
-    int get_term() const { return term_; }
-    std::optional<int> get_voted_for() const { return voted_for_; }
-    int get_votes_received() const { return votes_received_; }
+    // Request handlers; a request type without one is refused by dispatch()
+    Task handle(IO::Envelope msg, IO::AppendEntriesRequest request);
+    Task handle(IO::Envelope msg, IO::RequestVoteRequest request);
+    // One heartbeat RPC to peer, stepping down if it reports a higher term.
+    // A leader heartbeats all its peers at once, each on its own RPC (which
+    // also lets a host batching heartbeats merge those in flight together).
+    Task send_heartbeat(int peer);
+    // One RequestVote RPC to peer for the current election, counting the
+    // vote if it is granted while the election is still on. A candidate asks
+    // all its peers at once, so its main loop never waits on a vote, and a
+    // request the network loses only loses that vote.
+    Task request_vote(int peer);
 };
 
+// Defined in raft_node.cc for the two simulation stacks; other stacks
+// instantiate it from raft_node_impl.h
+extern template class BasicRaftNode<System::VirtualStack>;
+extern template class BasicRaftNode<System::StaticStack>;
+
+using RaftNode = BasicRaftNode<System::VirtualStack>;
+
 } // namespace Node
 
 
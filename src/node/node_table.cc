@@ -0,0 +1,123 @@
+#include "src/node/node_table.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace Node {
+
+namespace {
+
+uint64_t mix(uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+NodeTable::NodeTable(int nr_nodes)
+    : role_(nr_nodes, FOLLOWER),
+      term_(nr_nodes, 0),
+      voted_for_(nr_nodes, -1),
+      votes_received_(nr_nodes, 0),
+      last_heartbeat_(nr_nodes, 0),
+      row_hash_(nr_nodes, 0),
+      is_changed_(nr_nodes, 0) {
+    changed_.reserve(nr_nodes);
+    for (int row = 0; row < nr_nodes; ++row) {
+        touch(row);
+    }
+}
+
+uint64_t NodeTable::hash_row(int row) const {
+    uint64_t h = mix(static_cast<uint64_t>(row));
+    h = mix(h ^ role_[row]);
+    h = mix(h ^ static_cast<uint32_t>(term_[row]));
+    h = mix(h ^ static_cast<uint32_t>(voted_for_[row]));
+    return mix(h ^ static_cast<uint32_t>(votes_received_[row]));
+}
+
+void NodeTable::touch(int row) {
+    // A sum of row hashes does not depend on row order, so one row can be
+    // swapped out without looking at the others
+    uint64_t previous = row_hash_[row];
+    row_hash_[row] = hash_row(row);
+    if (!ranges_.empty()) {
+        Range& range = ranges_[range_of_[row]];
+        range.digest_delta += row_hash_[row] - previous;
+        if (!is_changed_[row]) {
+            is_changed_[row] = 1;
+            range.changed.push_back(row);
+        }
+        return;
+    }
+    digest_ += row_hash_[row] - previous;
+    if (!is_changed_[row]) {
+        is_changed_[row] = 1;
+        changed_.push_back(row);
+    }
+}
+
+void NodeTable::set_role(int row, RaftState role) {
+    if (role_[row] != role) {
+        role_[row] = static_cast<uint8_t>(role);
+        touch(row);
+    }
+}
+
+void NodeTable::set_term(int row, int term) {
+    if (term_[row] != term) {
+        term_[row] = term;
+        touch(row);
+    }
+}
+
+void NodeTable::set_voted_for(int row, std::optional<int> voted_for) {
+    int value = voted_for.value_or(-1);
+    if (voted_for_[row] != value) {
+        voted_for_[row] = value;
+        touch(row);
+    }
+}
+
+void NodeTable::set_votes_received(int row, int votes) {
+    if (votes_received_[row] != votes) {
+        votes_received_[row] = votes;
+        touch(row);
+    }
+}
+
+void NodeTable::partition(const std::vector<int>& bounds) {
+    if (bounds.size() < 2 || bounds.front() != 0 || bounds.back() != size() ||
+        !std::is_sorted(bounds.begin(), bounds.end(), std::less_equal<int>())) {
+        throw std::invalid_argument("Row ranges must split 0.." + std::to_string(size()) + " in increasing order");
+    }
+    merge_partitions();
+    ranges_ = std::vector<Range>(bounds.size() - 1);
+    range_of_.assign(size(), 0);
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        std::fill(range_of_.begin() + bounds[i], range_of_.begin() + bounds[i + 1], static_cast<int>(i));
+    }
+}
+
+void NodeTable::merge_partitions() {
+    for (auto& range : ranges_) {
+        digest_ += range.digest_delta;
+        range.digest_delta = 0;
+        std::sort(range.changed.begin(), range.changed.end());
+        changed_.insert(changed_.end(), range.changed.begin(), range.changed.end());
+        range.changed.clear();
+    }
+}
+
+void NodeTable::clear_changed() {
+    for (int row : changed_) {
+        is_changed_[row] = 0;
+    }
+    changed_.clear();
+}
+
+} // namespace Node
@@ -0,0 +1,88 @@
+#ifndef _NODE_TABLE_H_
+#define _NODE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Node {
+
+enum RaftState {
+    LEADER,
+    FOLLOWER,
+    CANDIDATE,
+};
+
+// Raft state of every node of a cluster, one column per field, so scans over
+// thousands of nodes touch only the fields they read. Rows whose role, term,
+// vote or tally change are remembered until clear_changed(), and an
+// order-independent digest of all rows is kept up to date as they change, so
+// per-step bookkeeping costs O(changed nodes) rather than O(nodes).
+class NodeTable {
+private:
+    std::vector<uint8_t> role_;
+    std::vector<int> term_;
+    // -1: no vote this term
+    std::vector<int> voted_for_;
+    std::vector<int> votes_received_;
+    std::vector<long long> last_heartbeat_;
+    std::vector<uint64_t> row_hash_;
+    std::vector<uint8_t> is_changed_;
+    std::vector<int> changed_;
+    uint64_t digest_ = 0;
+    // Set by partition(): what each range of rows changed since the last
+    // merge_partitions(), kept apart so ranges can be written concurrently
+    struct alignas(64) Range {
+        uint64_t digest_delta = 0;
+        std::vector<int> changed;
+    };
+    std::vector<Range> ranges_;
+    std::vector<int> range_of_;
+
+    uint64_t hash_row(int row) const;
+    void touch(int row);
+public:
+    // Every row starts as a follower in term 0 that has not voted, and counts
+    // as changed.
+    explicit NodeTable(int nr_nodes);
+
+    int size() const { return static_cast<int>(role_.size()); }
+
+    RaftState role(int row) const { return static_cast<RaftState>(role_[row]); }
+    int term(int row) const { return term_[row]; }
+    std::optional<int> voted_for(int row) const {
+        return voted_for_[row] < 0 ? std::nullopt : std::optional<int>(voted_for_[row]);
+    }
+    int votes_received(int row) const { return votes_received_[row]; }
+    long long last_heartbeat(int row) const { return last_heartbeat_[row]; }
+
+    void set_role(int row, RaftState role);
+    void set_term(int row, int term);
+    void set_voted_for(int row, std::optional<int> voted_for);
+    void set_votes_received(int row, int votes);
+    // Not part of the observed state: neither marks the row nor changes the digest.
+    void set_last_heartbeat(int row, long long time) { last_heartbeat_[row] = time; }
+
+    // Rows changed since the last clear_changed(), each once, in the order
+    // they first changed.
+    const std::vector<int>& changed() const { return changed_; }
+    void clear_changed();
+
+    uint64_t digest() const { return digest_; }
+
+    // Cuts the rows into the ranges [bounds[i], bounds[i + 1]), each of
+    // which may then be written by its own thread (one writer per range,
+    // nobody reading). Their changes reach changed() and digest() on
+    // merge_partitions(). Throws std::invalid_argument unless bounds go
+    // from 0 to size() in increasing order.
+    void partition(const std::vector<int>& bounds);
+    // Folds the ranges' changes in, once the writers are done. Rows changed
+    // meanwhile are appended to changed() in row order, so the result does
+    // not depend on how the rows were cut.
+    void merge_partitions();
+};
+
+} // namespace Node
+
+#endif // _NODE_TABLE_H_
@@ -0,0 +1,251 @@
+#ifndef _RAFT_NODE_IMPL_H_
+#define _RAFT_NODE_IMPL_H_
+
+// Definitions of BasicRaftNode's members. raft_node.cc instantiates them for
+// the simulation stacks; include this to instantiate them for another one.
+
+#include "src/node/node.h"
+#include "src/log/log.h"
+#include "src/system/system.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <iostream>
+#include <string>
+
+namespace Node {
+
+template<typename Stack>
+Task BasicRaftNode<Stack>::main_loop() {
+    Log::out() << "[Node " << id_ << "] Starting main raft loop as FOLLOWER" << std::endl;
+    set_last_heartbeat_time(system_->get_time());
+
+    while (true) {
+        if (get_state() == LEADER) {
+            // Each peer on its own RPC: a slow or lost heartbeat holds up no
+            // one else. Each runs right away, up to sending its request.
+            for (int i = group_first_; i < group_first_ + nr_nodes_; i++) {
+                if (i == id_) continue;
+                send_heartbeat(i).h_.resume();
+            }
+            co_await system_->sleep(heartbeat_interval_);
+        } else {
+            // FOLLOWER or CANDIDATE
+            int election_timeout = system_->random_range(election_timeout_min_, election_timeout_max_);
+            long long current_time = system_->get_time();
+            long long elapsed = current_time - last_heartbeat_time();
+
+            if (elapsed >= election_timeout) {
+                // Start election
+                set_state(CANDIDATE);
+                set_term(get_term() + 1);
+                set_voted_for(id_);
+                set_votes_received(1);  // Vote for self
+                set_last_heartbeat_time(system_->get_time());
+
+                Log::out() << "[Node " << id_ << "] Election timeout, becoming CANDIDATE for term " << get_term() << std::endl;
+
+                // Votes are counted as they come in; the main loop never
+                // waits on one, so a lost request only loses its vote
+                for (int i = group_first_; i < group_first_ + nr_nodes_; i++) {
+                    if (i == id_) continue;
+                    request_vote(i).h_.resume();
+                }
+            } else {
+                // Sleep until the timeout, then check again. A candidate checks
+                // at least every heartbeat interval, so an election it wins
+                // meanwhile is followed by heartbeats before its voters time out.
+                int remaining = static_cast<int>(election_timeout - elapsed);
+                co_await system_->sleep(get_state() == CANDIDATE ? std::min(remaining, heartbeat_interval_) : remaining);
+            }
+        }
+    }
+}
+
+
+template<typename Stack>
+Task BasicRaftNode<Stack>::send_heartbeat(int peer) {
+    Log::out() << "[Node " << id_ << "] Sending heartbeat to node " << peer << std::endl;
+    auto append_entries_req = IO::AppendEntriesRequest{
+        .term = get_term(),
+        .leader_id = id_,
+    };
+    auto resp = co_await system_->rpc(id_, peer, append_entries_req);
+    if (!resp) {
+        co_return;
+    }
+    auto content = std::get<IO::AppendEntriesResponse>(resp->content);
+
+    if (content.term > get_term()) {
+        Log::out() << "[Node " << id_ << "] Received higher term " << content.term
+                  << " from node " << resp->from << ", stepping down" << std::endl;
+        set_term(content.term);
+        set_state(FOLLOWER);
+        set_voted_for(std::nullopt);
+        set_last_heartbeat_time(system_->get_time());
+    }
+    co_return;
+}
+
+template<typename Stack>
+Task BasicRaftNode<Stack>::request_vote(int peer) {
+    if (get_state() != CANDIDATE) {
+        co_return;
+    }
+    int term = get_term();
+    Log::out() << "[Node " << id_ << "] Requesting vote from node " << peer << std::endl;
+    auto vote_request = IO::RequestVoteRequest{
+        .term = term,
+        .candidate_id = id_,
+    };
+    auto vote_resp = co_await system_->rpc(id_, peer, vote_request);
+    if (!vote_resp) {
+        Log::out() << "[Node " << id_ << "] Lost the vote request to node " << peer << std::endl;
+        co_return;
+    }
+    auto vote_content = std::get<IO::RequestVoteResponse>(vote_resp->content);
+
+    Log::out() << "[Node " << id_ << "] Received vote response from node " << vote_resp->from
+              << ": term=" << vote_content.term << ", granted=" << vote_content.vote_granted << std::endl;
+
+    if (vote_content.term > get_term()) {
+        Log::out() << "[Node " << id_ << "] Received higher term " << vote_content.term
+                  << ", stepping down to FOLLOWER" << std::endl;
+        set_term(vote_content.term);
+        set_state(FOLLOWER);
+        set_voted_for(std::nullopt);
+        set_last_heartbeat_time(system_->get_time());
+        co_return;
+    }
+    // The election this vote was for is over: won, lost, or timed out into the next
+    if (get_state() != CANDIDATE || get_term() != term) {
+        co_return;
+    }
+    if (vote_content.term == term && vote_content.vote_granted) {
+        set_votes_received(get_votes_received() + 1);
+        Log::out() << "[Node " << id_ << "] Got vote, now have " << get_votes_received() << " votes" << std::endl;
+        if (get_votes_received() > nr_nodes_ / 2) {
+            Log::out() << "[Node " << id_ << "] Won election with " << get_votes_received()
+                      << " votes, becoming LEADER for term " << get_term() << std::endl;
+            set_state(LEADER);
+        }
+    }
+    co_return;
+}
+
+template<typename Stack>
+Task BasicRaftNode<Stack>::handle(IO::Envelope msg, IO::AppendEntriesRequest request) {
+    if (msg.to != id_) {
+        throw std::runtime_error("Message got to the wrong node: was meant for " + std::to_string(msg.to) + ", but arrived to " + std::to_string(id_));
+    }
+
+    // If the leader's term is higher, update our term and reset vote
+    if (request.term > get_term()) {
+        set_term(request.term);
+        set_state(FOLLOWER);
+        set_voted_for(std::nullopt);
+        set_last_heartbeat_time(system_->get_time());
+        Log::out() << "[Node " << id_ << "] Received AppendEntries from leader " << request.leader_id
+                  << " for higher term " << request.term << ", stepping down" << std::endl;
+    } else if (request.term == get_term()) {
+        // Same term - recognize the leader but DON'T reset voted_for
+        set_state(FOLLOWER);
+        set_last_heartbeat_time(system_->get_time());
+        Log::out() << "[Node " << id_ << "] Received AppendEntries from leader " << request.leader_id
+                  << " for term " << request.term << ", resetting heartbeat" << std::endl;
+    }
+
+    auto response = IO::Envelope {
+        .message_id = msg.message_id,
+        .from = id_,
+        .to = msg.from,
+        .content = IO::AppendEntriesResponse{
+            .term = get_term(),
+        }
+    };
+    Log::out() << "[Node " << id_ << "] Sent AppendEntriesResponse to node " << msg.from << std::endl;
+    system_->send_message(response);
+    co_return;
+}
+
+template<typename Stack>
+Task BasicRaftNode<Stack>::handle(IO::Envelope msg, IO::RequestVoteRequest request) {
+    if (msg.to != id_) {
+        throw std::runtime_error("Message got to the wrong node: was meant for " + std::to_string(msg.to) + ", but arrived to " + std::to_string(id_));
+    }
+
+    bool vote_granted = false;
+
+    // If the candidate's term is higher, update our term and reset vote
+    if (request.term > get_term()) {
+        Log::out() << "[Node " << id_ << "] RequestVote from " << request.candidate_id
+                  << " has higher term " << request.term << ", updating" << std::endl;
+        set_term(request.term);
+        set_state(FOLLOWER);
+        set_voted_for(std::nullopt);
+    }
+
+    // Grant vote if: term is current and we haven't voted or already voted for this candidate
+    if (request.term >= get_term() && (!get_voted_for().has_value() || get_voted_for().value() == request.candidate_id)) {
+        set_voted_for(request.candidate_id);
+        vote_granted = true;
+        set_last_heartbeat_time(system_->get_time());
+        Log::out() << "[Node " << id_ << "] Granting vote to candidate " << request.candidate_id
+                  << " for term " << request.term << std::endl;
+    } else {
+        Log::out() << "[Node " << id_ << "] Denying vote to candidate " << request.candidate_id
+                  << " for term " << request.term << " (our term=" << get_term()
+                  << ", voted_for=" << (get_voted_for().has_value() ? std::to_string(get_voted_for().value()) : "none") << ")" << std::endl;
+    }
+
+    auto response = IO::Envelope {
+        .message_id = msg.message_id,
+        .from = id_,
+        .to = msg.from,
+        .content = IO::RequestVoteResponse{
+            .term = get_term(),
+            .vote_granted = vote_granted,
+        }
+    };
+    Log::out() << "[Node " << id_ << "] Sent RequestVoteResponse to node " << msg.from << std::endl;
+    system_->send_message(response);
+    co_return;
+}
+
+// The dispatch table entry of message type T: the handler of a request, the
+// waiting RPC for a response, a refusal for anything else.
+template<typename RaftNode, typename T>
+void dispatch_message(RaftNode& node, const IO::Envelope& msg) {
+    if constexpr (requires(RaftNode& self, const T& request) { self.handle(msg, request); }) {
+        auto handler_coro = node.handle(msg, *std::get_if<T>(&msg.content));
+        auto resumer_lambda = [handler_coro]() {handler_coro.h_.resume();};
+        Log::out() << "[Node " << node.id_ << "] Dispatching " << T::NAME << " with id = " << msg.message_id << std::endl;
+        node.system_->request_work(resumer_lambda);
+    } else if constexpr (T::KIND == IO::MessageKind::Response) {
+        Log::out() << "[Node " << node.id_ << "] Resuming " << T::NAME << ", msg id = " << msg.message_id << std::endl;
+        node.system_->register_rpc_completion(msg.message_id, msg);
+    } else {
+        throw std::runtime_error(std::string("Unsupported message type for raft node: ") + T::NAME);
+    }
+}
+
+template<typename RaftNode, typename... Ts>
+constexpr auto dispatch_table(IO::TypeList<Ts...>) {
+    return std::array<void (*)(RaftNode&, const IO::Envelope&), sizeof...(Ts)>{&dispatch_message<RaftNode, Ts>...};
+}
+
+template<typename Stack>
+void BasicRaftNode<Stack>::dispatch() {
+    // Indexed by the content's type: no switch, and no second check of the
+    // type before taking the content out
+    static constexpr auto table = dispatch_table<BasicRaftNode>(IO::MessageTypes{});
+    Log::out() << "[Node " << id_ << "] Dispatching messages" << std::endl;
+    for (const auto& msg : inbox) {
+        table[msg.type()](*this, msg);
+    }
+    inbox.clear();
+}
+
+} // namespace Node
+
+#endif // _RAFT_NODE_IMPL_H_
@@ -37,19 +37,14 @@ size_t ClusterState::hash() const {
     return h;
 }
 
-ClusterState ClusterState::capture(const std::vector<std::shared_ptr<Node::RaftNode>>& nodes) {
-    ClusterState state;
-    state.nodes.reserve(nodes.size());
-    for (const auto& node : nodes) {
-        NodeState ns;
-        ns.id = node->id_;
-        ns.state = node->get_state();
-        ns.term = node->get_term();
-        ns.voted_for = node->get_voted_for();
-        ns.votes_received = node->get_votes_received();
-        state.nodes.push_back(ns);
-    }
-    return state;
+NodeState NodeState::of(const Node::RaftReplica& node) {
+    NodeState ns;
+    ns.id = node.replica_id();
+    ns.state = node.get_state();
+    ns.term = node.get_term();
+    ns.voted_for = node.get_voted_for();
+    ns.votes_received = node.get_votes_received();
+    return ns;
 }
 
 } // namespace State
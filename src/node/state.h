@@ -17,6 +17,8 @@ struct NodeState {
 
     bool operator==(const NodeState& other) const;
     size_t hash() const;
+
+    static NodeState of(const Node::RaftReplica& node);
 };
 
 struct ClusterState {
@@ -25,7 +27,16 @@ struct ClusterState {
     size_t hash() const;
     bool operator==(const ClusterState& other) const;
 
-    static ClusterState capture(const std::vector<std::shared_ptr<Node::RaftNode>>& nodes);
+    // nodes: std::shared_ptr to the RaftNodes of any stack
+    template<typename NodePtr>
+    static ClusterState capture(const std::vector<NodePtr>& nodes) {
+        ClusterState state;
+        state.nodes.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            state.nodes.push_back(NodeState::of(*node));
+        }
+        return state;
+    }
 };
 
 } // namespace State
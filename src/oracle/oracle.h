@@ -1,9 +1,52 @@
+#ifndef _ORACLE_H_
+#define _ORACLE_H_
+
 #include "src/node/node.h"
 #include <vector>
 #include <unordered_map>
+#include <stdexcept>
+#include <string>
 
 namespace Oracle {
 
+// Thrown when a safety property is broken. invariant() names the property, so
+// runs can be compared on which invariant they violate, not on the message.
+class InvariantViolation : public std::runtime_error {
+private:
+    std::string invariant_;
+public:
+    InvariantViolation(const std::string& invariant, const std::string& message)
+        : std::runtime_error(message), invariant_(invariant) {}
+    const std::string& invariant() const { return invariant_; }
+};
+
+// How close a run came to breaking election safety: the highest value each
+// signal reached at the end of any step. Two leaders in a term are always
+// preceded by two contenders in it.
+struct Proximity {
+    // Most nodes of a group standing as candidates for the same term at once
+    int concurrent_candidates = 0;
+    // Votes held by the runner-up among the contenders (candidates and the
+    // leader) for one term; a majority there is a second leader
+    int split_votes = 0;
+    // Largest spread between the highest and lowest term within a group
+    int term_gap = 0;
+
+    bool operator==(const Proximity&) const = default;
+};
+
+// What each Proximity signal is worth in fitness()
+struct FitnessWeights {
+    int concurrent_candidates = 4;
+    int split_votes = 8;
+    int term_gap = 1;
+};
+
+int fitness(const Proximity& proximity, const FitnessWeights& weights);
+// Parses "candidates=4,splits=8,gap=1"; signals left out keep their default
+// weight. Throws std::invalid_argument on unknown names or negative weights.
+FitnessWeights parse_fitness_weights(const std::string& spec);
+
 class Oracle {
 public:
     virtual void enforce_invariants() = 0;
@@ -11,21 +54,52 @@ public:
 
 class RaftOracle : public Oracle {
 private:
-    std::vector<std::shared_ptr<Node::RaftNode>> nodes_;
-    std::unordered_map<int, int> leader_per_term_;  // term -> node_id
+    std::vector<std::shared_ptr<Node::RaftReplica>> nodes_;
+    std::unordered_map<long long, int> leader_per_term_;  // (group, term) -> node_id
+    // Set when node i lives in row i of one shared table: only rows changed
+    // since the last check can have become leaders.
+    Node::NodeTable* table_ = nullptr;
+    // (group, term, role, votes received) of every node, reused across steps
+    struct Contender {
+        int group;
+        int term;
+        Node::RaftState state;
+        int votes;
+    };
+    std::vector<Contender> contenders_;
+    bool track_proximity_ = false;
+    Proximity proximity_;
+    void check_leader(const Node::RaftReplica& node);
     void enforce_election_safety();
+    void update_proximity();
 public:
     void enforce_invariants() override;
-    RaftOracle(std::vector<std::shared_ptr<Node::Node>> nodes) {
+    // Looks at every node after each check (not only the changed ones) to
+    // keep proximity() up to date; meant for the small clusters fuzzed.
+    void set_track_proximity(bool track) { track_proximity_ = track; }
+    const Proximity& proximity() const { return proximity_; }
+    // The leader seen in each (group, term) so far, including terms over
+    const std::unordered_map<long long, int>& leaders() const { return leader_per_term_; }
+    // Takes the nodes of any stack (std::shared_ptr<Node::BasicNode<Stack>>)
+    template<typename NodePtr>
+    RaftOracle(const std::vector<NodePtr>& nodes) {
         for(auto node : nodes) {
-            auto casted_ptr = std::dynamic_pointer_cast<Node::RaftNode>(node);
+            auto casted_ptr = std::dynamic_pointer_cast<Node::RaftReplica>(node);
             if (!casted_ptr) {
                 throw std::runtime_error("Unable to cast Node into RaftNode");
             }
             nodes_.push_back(casted_ptr);
         }
-
+        bool shared = !nodes_.empty() && nodes_[0]->table()->size() == static_cast<int>(nodes_.size());
+        for (size_t i = 0; shared && i < nodes_.size(); ++i) {
+            shared = nodes_[i]->replica_id() == static_cast<int>(i) && nodes_[i]->table() == nodes_[0]->table();
+        }
+        if (shared && nodes_.size() > 1) {
+            table_ = nodes_[0]->table().get();
+        }
     }
 };
 
-}
\ No newline at end of file
+}
+
+#endif // _ORACLE_H_
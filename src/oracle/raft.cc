@@ -1,35 +1,126 @@
 #include "src/oracle/oracle.h"
+#include "src/log/log.h"
 #include "src/node/node.h"
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 namespace Oracle {
 
+void RaftOracle::check_leader(const Node::RaftReplica& node) {
+    if (node.get_state() != Node::LEADER) {
+        return;
+    }
+    int term = node.get_term();
+    int node_id = node.replica_id();
+    // Groups elect their leaders independently
+    long long key = (static_cast<long long>(node.group_first()) << 32) | static_cast<unsigned int>(term);
+
+    auto it = leader_per_term_.find(key);
+    if (it != leader_per_term_.end()) {
+        if (it->second != node_id) {
+            throw InvariantViolation("election_safety",
+                "ELECTION SAFETY VIOLATION: Two leaders in term " + std::to_string(term) +
+                "! Node " + std::to_string(it->second) + " and Node " + std::to_string(node_id) +
+                " are both leaders.");
+        }
+    } else {
+        leader_per_term_[key] = node_id;
+        Log::out() << "[Oracle] Recorded leader " << node_id << " for term " << term << std::endl;
+    }
+}
+
 void RaftOracle::enforce_election_safety() {
     // Election safety invariant: At most one leader can be elected per term
+    if (table_) {
+        // A node that has not changed since the last check was checked then
+        for (int row : table_->changed()) {
+            check_leader(*nodes_[row]);
+        }
+        return;
+    }
+    for (const auto& node : nodes_) {
+        check_leader(*node);
+    }
+}
+
+void RaftOracle::update_proximity() {
+    contenders_.clear();
     for (const auto& node : nodes_) {
-        if (node->get_state() == Node::LEADER) {
-            int term = node->get_term();
-            int node_id = node->id_;
-
-            auto it = leader_per_term_.find(term);
-            if (it != leader_per_term_.end()) {
-                if (it->second != node_id) {
-                    throw std::runtime_error(
-                        "ELECTION SAFETY VIOLATION: Two leaders in term " + std::to_string(term) +
-                        "! Node " + std::to_string(it->second) + " and Node " + std::to_string(node_id) +
-                        " are both leaders.");
-                }
-            } else {
-                leader_per_term_[term] = node_id;
-                std::cout << "[Oracle] Recorded leader " << node_id << " for term " << term << std::endl;
+        contenders_.push_back({node->group_first(), node->get_term(), node->get_state(), node->get_votes_received()});
+    }
+    std::sort(contenders_.begin(), contenders_.end(), [](const Contender& a, const Contender& b) {
+        return a.group != b.group ? a.group < b.group : a.term < b.term;
+    });
+    size_t group_start = 0;
+    for (size_t i = 0; i < contenders_.size();) {
+        const Contender& first = contenders_[i];
+        if (first.group != contenders_[group_start].group) {
+            group_start = i;
+        }
+        // Sorted by term within the group: the first node has its lowest term
+        proximity_.term_gap = std::max(proximity_.term_gap, first.term - contenders_[group_start].term);
+        int candidates = 0;
+        int best = 0, runner_up = 0;
+        size_t j = i;
+        for (; j < contenders_.size() && contenders_[j].group == first.group && contenders_[j].term == first.term;
+             ++j) {
+            if (contenders_[j].state == Node::FOLLOWER) {
+                continue;
+            }
+            candidates += contenders_[j].state == Node::CANDIDATE ? 1 : 0;
+            int votes = contenders_[j].votes;
+            if (votes > best) {
+                runner_up = best;
+                best = votes;
+            } else if (votes > runner_up) {
+                runner_up = votes;
             }
         }
+        proximity_.concurrent_candidates = std::max(proximity_.concurrent_candidates, candidates);
+        proximity_.split_votes = std::max(proximity_.split_votes, runner_up);
+        i = j;
     }
 }
 
 void RaftOracle::enforce_invariants() {
     enforce_election_safety();
+    if (track_proximity_) {
+        update_proximity();
+    }
+}
+
+int fitness(const Proximity& proximity, const FitnessWeights& weights) {
+    return proximity.concurrent_candidates * weights.concurrent_candidates +
+           proximity.split_votes * weights.split_votes + proximity.term_gap * weights.term_gap;
+}
+
+FitnessWeights parse_fitness_weights(const std::string& spec) {
+    FitnessWeights weights;
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("Fitness weight without a value: " + item);
+        }
+        std::string name = item.substr(0, eq);
+        int weight = std::stoi(item.substr(eq + 1));
+        if (weight < 0) {
+            throw std::invalid_argument("Negative fitness weight: " + item);
+        }
+        if (name == "candidates") {
+            weights.concurrent_candidates = weight;
+        } else if (name == "splits") {
+            weights.split_votes = weight;
+        } else if (name == "gap") {
+            weights.term_gap = weight;
+        } else {
+            throw std::invalid_argument("Unknown fitness signal: " + name);
+        }
+    }
+    return weights;
 }
 
 };
@@ -1,11 +1,19 @@
 #include "src/rng/rng.h"
+#include <utility>
 
 namespace RNG {
 
 UniformDistributionRange::UniformDistributionRange(int seed) : mt_(seed) {}
 
-int UniformDistributionRange::draw(int lo, int hi) {
-    std::uniform_int_distribution dist(lo, hi);
-    return dist(mt_);
+void UniformDistributionRange::reseed(int seed) {
+    mt_.seed(seed);
+}
+
+ByteStreamRNG::ByteStreamRNG(std::vector<uint8_t> bytes, int seed)
+    : bytes_(std::move(bytes)), fallback_(seed) {}
+
+void ByteStreamRNG::reseed(int seed) {
+    offset_ = bytes_.size();
+    fallback_.reseed(seed);
 }
 } // namespace RNG
\ No newline at end of file
@@ -2,7 +2,10 @@
 #ifndef _RNG_H_
 #define _RNG_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 namespace RNG {
 
@@ -12,15 +15,71 @@ public:
     virtual int draw(int lo, int hi)  = 0;
 };
 
-class UniformDistributionRange : public RNG {
+class UniformDistributionRange final : public RNG {
 private:
     std::mt19937 mt_;
 public:
     ~UniformDistributionRange() = default;
     UniformDistributionRange(int seed);
-    int draw(int lo, int hi) override;
+    int draw(int lo, int hi) override {
+        std::uniform_int_distribution dist(lo, hi);
+        return dist(mt_);
+    }
+    void reseed(int seed);
 };
 
+// Takes its decisions from a caller supplied byte stream (the tail of a fuzz
+// input) and carries on as UniformDistributionRange once the bytes run out.
+// Each draw consumes 1, 2 or 4 bytes depending on the size of the range, so
+// changing one byte changes one decision and leaves the rest in place.
+class ByteStreamRNG final : public RNG {
+private:
+    std::vector<uint8_t> bytes_;
+    size_t offset_ = 0;
+    UniformDistributionRange fallback_;
+public:
+    ByteStreamRNG(std::vector<uint8_t> bytes, int seed);
+    // Inline, so that callers holding a ByteStreamRNG (not an RNG) can inline draws
+    int draw(int lo, int hi) override {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+        size_t width = range <= (1u << 8) ? 1 : range <= (1u << 16) ? 2 : 4;
+        if (offset_ + width > bytes_.size()) {
+            offset_ = bytes_.size();
+            return fallback_.draw(lo, hi);
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            value |= static_cast<uint64_t>(bytes_[offset_ + i]) << (8 * i);
+        }
+        offset_ += width;
+        return static_cast<int>(lo + static_cast<int64_t>(value % range));
+    }
+    // Drops whatever is left of the byte stream and reseeds the fallback.
+    void reseed(int seed);
+    size_t consumed() const { return offset_; }
+    size_t remaining() const { return bytes_.size() - offset_; }
+};
+
+// splitmix64: eight bytes of state, for simulations that hold one stream per
+// node, where mt19937's 2.5 KB each would crowd everything else out of cache.
+class SplitMixRNG final : public RNG {
+private:
+    uint64_t state_;
+public:
+    explicit SplitMixRNG(uint64_t seed) : state_(seed) {}
+    int draw(int lo, int hi) override {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+        uint64_t x = state_ += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        // Multiply-shift rather than modulo: no division, and no bias worth
+        // the name for ranges this small
+        return static_cast<int>(lo + static_cast<int64_t>((static_cast<unsigned __int128>(x) * range) >> 64));
+    }
+    void reseed(uint64_t seed) { state_ = seed; }
+    uint64_t state() const { return state_; }
+};
 
 } // namespace RNG
 
@@ -1,28 +1,56 @@
+#ifndef _ROUTER_H_
+#define _ROUTER_H_
+
 #include "src/node/node.h"
 #include "src/io/network.h"
 #include "src/io/messages.h"
-#include <set>
+#include <algorithm>
+#include <vector>
 
 namespace Routing {
 
-class Router {
+template<typename Stack>
+class BasicRouter {
 private:
-    std::vector<std::shared_ptr<Node::Node>> nodes_;
-    std::shared_ptr<IO::Network> network_;
-    std::shared_ptr<System::System> sys_;
+    std::vector<std::shared_ptr<Node::BasicNode<Stack>>> nodes_;
+    std::shared_ptr<typename Stack::Network> network_;
+    std::shared_ptr<System::BasicSystem<Stack>> sys_;
+    // Reused across calls; only nodes with mail are touched
+    std::vector<int> ready_nodes_;
+    void deliver(IO::Envelope msg) {
+        ready_nodes_.push_back(msg.to);
+        nodes_[msg.to]->inbox.push_back(std::move(msg));
+    }
 public:
-    Router(std::vector<std::shared_ptr<Node::Node>> nodes, std::shared_ptr<IO::Network> network, std::shared_ptr<System::System> sys)
+    BasicRouter(std::vector<std::shared_ptr<Node::BasicNode<Stack>>> nodes, std::shared_ptr<typename Stack::Network> network,
+                std::shared_ptr<System::BasicSystem<Stack>> sys)
         :   nodes_(std::move(nodes)), network_(network), sys_(sys) {}
     void route() {
-        std::set<int> ready_nodes;
-        for (auto msg : network_->fetch_ready()) {
-            nodes_[msg.to]->inbox.push_back(msg);
-            ready_nodes.insert(msg.to);
+        ready_nodes_.clear();
+        for (const auto& lost : network_->fetch_lost()) {
+            sys_->fail_rpc(lost.message_id, lost.caller);
+        }
+        for (auto& msg : network_->fetch_ready()) {
+            if (std::holds_alternative<IO::HeartbeatBatch>(msg.content)) {
+                // Addressed host to host; each heartbeat inside goes to its replica
+                for (const auto& inner : std::get<IO::HeartbeatBatch>(msg.content).messages()) {
+                    deliver(inner);
+                }
+                continue;
+            }
+            deliver(std::move(msg));
         }
-        for (auto node_id : ready_nodes) {
-            sys_->request_work([node_id, *this]() {nodes_[node_id]->dispatch();});
+        // Dispatch in node order, once per node
+        std::sort(ready_nodes_.begin(), ready_nodes_.end());
+        ready_nodes_.erase(std::unique(ready_nodes_.begin(), ready_nodes_.end()), ready_nodes_.end());
+        for (auto node_id : ready_nodes_) {
+            sys_->request_work_for(node_id, [node = nodes_[node_id]]() {node->dispatch();});
         }
     }
 };
 
-};
\ No newline at end of file
+using Router = BasicRouter<System::VirtualStack>;
+
+};
+
+#endif // _ROUTER_H_
@@ -0,0 +1,97 @@
+#include "src/runtime/event_loop.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace Runtime {
+
+namespace {
+
+const int MAX_EVENTS = 64;
+
+} // namespace
+
+EventLoop::EventLoop() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
+    if (epoll_fd_ < 0) {
+        throw std::runtime_error("Unable to create epoll instance: " + std::string(strerror(errno)));
+    }
+}
+
+EventLoop::~EventLoop() {
+    ::close(epoll_fd_);
+}
+
+void EventLoop::add(int fd, uint32_t events, Handler handler) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw std::runtime_error("Unable to watch fd " + std::to_string(fd) + ": " + strerror(errno));
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+}
+
+void EventLoop::modify(int fd, uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) != 0) {
+        throw std::runtime_error("Unable to modify fd " + std::to_string(fd) + ": " + strerror(errno));
+    }
+}
+
+void EventLoop::remove(int fd) {
+    if (handlers_.erase(fd) > 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+void EventLoop::call_after(int delay_ms, std::function<void()> callback) {
+    timers_.push(Timer{std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms), next_timer_id_++,
+                       std::move(callback)});
+}
+
+int EventLoop::run_due_timers() {
+    int ran = 0;
+    auto now = std::chrono::steady_clock::now();
+    // Timers added by these callbacks wait for the next poll, even if due now
+    uint64_t last_id = next_timer_id_;
+    while (!timers_.empty() && timers_.top().due <= now && timers_.top().id < last_id) {
+        auto callback = timers_.top().callback;
+        timers_.pop();
+        callback();
+        ++ran;
+    }
+    return ran;
+}
+
+int EventLoop::poll(int timeout_ms) {
+    if (!timers_.empty()) {
+        auto until_timer = std::chrono::ceil<std::chrono::milliseconds>(timers_.top().due - std::chrono::steady_clock::now());
+        int wait = static_cast<int>(std::max<long long>(0, until_timer.count()));
+        timeout_ms = timeout_ms < 0 ? wait : std::min(timeout_ms, wait);
+    }
+    epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+    if (ready < 0 && errno != EINTR) {
+        throw std::runtime_error("epoll_wait failed: " + std::string(strerror(errno)));
+    }
+    int ran = 0;
+    for (int i = 0; i < ready; ++i) {
+        auto it = handlers_.find(events[i].data.fd);
+        if (it == handlers_.end()) {
+            // Removed by an earlier handler of this batch
+            continue;
+        }
+        auto handler = it->second;
+        (*handler)(events[i].events);
+        ++ran;
+    }
+    return ran + run_due_timers();
+}
+
+} // namespace Runtime
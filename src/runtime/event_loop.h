@@ -0,0 +1,61 @@
+#ifndef _EVENT_LOOP_H_
+#define _EVENT_LOOP_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Runtime {
+
+// Single-threaded epoll loop with one-shot timers on the monotonic clock. File
+// descriptors are watched with a handler each; poll() waits for the first
+// ready descriptor or due timer and runs what is ready. Handlers may add and
+// remove descriptors and timers, their own included.
+class EventLoop {
+public:
+    // Called with the ready epoll events (EPOLLIN, EPOLLOUT, EPOLLERR...)
+    using Handler = std::function<void(uint32_t events)>;
+
+    // Throws std::runtime_error if epoll is unavailable.
+    EventLoop();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Watches fd for events. The loop does not own fd: remove it before closing.
+    void add(int fd, uint32_t events, Handler handler);
+    void modify(int fd, uint32_t events);
+    void remove(int fd);
+    // Runs callback once, delay_ms milliseconds from now.
+    void call_after(int delay_ms, std::function<void()> callback);
+
+    // Waits up to timeout_ms (-1: until something happens) and runs the
+    // handlers of ready descriptors and the callbacks of due timers. Returns
+    // how many ran.
+    int poll(int timeout_ms);
+private:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    struct Timer {
+        TimePoint due;
+        uint64_t id;
+        std::function<void()> callback;
+        bool operator>(const Timer& other) const {
+            return due != other.due ? due > other.due : id > other.id;
+        }
+    };
+    int epoll_fd_;
+    // Shared, so a handler that removes itself lives until it returns
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t next_timer_id_ = 0;
+
+    int run_due_timers();
+};
+
+} // namespace Runtime
+
+#endif // _EVENT_LOOP_H_
@@ -0,0 +1,67 @@
+#include "src/runtime/raft_process.h"
+#include "src/node/raft_node_impl.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Node {
+
+template class BasicRaftNode<Runtime::RealStack>;
+
+} // namespace Node
+
+namespace Runtime {
+
+RaftProcess::RaftProcess(const ProcessOptions& options) {
+    int nr_nodes = static_cast<int>(options.peers.size());
+    if (nr_nodes < 1 || options.id < 0 || options.id >= nr_nodes) {
+        throw std::invalid_argument("Node " + std::to_string(options.id) + " is not one of " +
+                                    std::to_string(nr_nodes) + " peers");
+    }
+    if (options.election_timeout_min <= 0 || options.election_timeout_max < options.election_timeout_min ||
+        options.heartbeat_interval <= 0) {
+        throw std::invalid_argument("Election timeouts and heartbeat interval must be positive and ordered");
+    }
+    clock_ = std::make_shared<RealStack::Clock>();
+    auto rng = std::make_shared<RealStack::RNG>(options.seed);
+    executor_ = std::make_shared<RealStack::Executor>(clock_);
+    // No jitter: real scheduling has plenty of its own
+    auto scheduler = std::make_shared<RealStack::Scheduler>(executor_, rng, clock_, 0);
+    network_ = std::make_shared<TcpNetwork>(loop_, options.id, options.peers, options.listen_fd);
+    system_ = std::make_shared<System::BasicSystem<RealStack>>(scheduler, clock_, rng, network_);
+
+    node_ = std::make_shared<RaftNodeType>(options.id, system_, nr_nodes, options.election_timeout_min,
+                                           options.election_timeout_max, options.heartbeat_interval);
+    auto main_loop = node_->main_loop();
+    system_->request_work_for(options.id, [main_loop]() { main_loop.h_.resume(); });
+
+    // The router indexes nodes by id; only this process's slot is filled
+    std::vector<std::shared_ptr<Node::BasicNode<RealStack>>> nodes(nr_nodes);
+    nodes[options.id] = node_;
+    router_ = std::make_shared<Routing::BasicRouter<RealStack>>(nodes, network_, system_);
+}
+
+void RaftProcess::run_ready() {
+    router_->route();
+    executor_->run_until_blocked();
+    bool leader = node_->get_state() == Node::LEADER;
+    if (leader && !was_leader_) {
+        ++elections_won_;
+    }
+    was_leader_ = leader;
+}
+
+void RaftProcess::poll(int max_wait_ms) {
+    run_ready();
+    int wait = max_wait_ms;
+    if (network_->has_messages()) {
+        wait = 0;
+    } else if (executor_->has_work()) {
+        long long until_due = executor_->next_time() - clock_->now();
+        wait = static_cast<int>(std::clamp<long long>(until_due, 0, max_wait_ms));
+    }
+    loop_.poll(wait);
+    run_ready();
+}
+
+} // namespace Runtime
@@ -0,0 +1,81 @@
+#ifndef _RAFT_PROCESS_H_
+#define _RAFT_PROCESS_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/node/node.h"
+#include "src/rng/rng.h"
+#include "src/routing/router.h"
+#include "src/runtime/event_loop.h"
+#include "src/runtime/tcp_network.h"
+#include "src/scheduler/scheduler.h"
+#include "src/system/system.h"
+
+namespace Runtime {
+
+// The components a node runs on outside the simulation: time is real
+// (milliseconds on the monotonic clock), randomness comes from a seeded
+// generator, and messages travel over TCP. Timers are executor tasks due at a
+// real time; the process's loop waits on epoll until the next one is due.
+struct RealStack {
+    using Clock = ::Clock::MonotonicClock;
+    using RNG = ::RNG::UniformDistributionRange;
+    using Executor = ::Executor::BasicPriorityQueueExecutor<Clock>;
+    using Scheduler = ::Scheduler::BasicDeterministicScheduler<Executor, RNG, Clock>;
+    using Network = TcpNetwork;
+};
+
+struct ProcessOptions {
+    // This node's index into peers
+    int id = 0;
+    // Where every node of the cluster listens, this one included
+    std::vector<Endpoint> peers;
+    // In milliseconds
+    int election_timeout_min = 150;
+    int election_timeout_max = 300;
+    int heartbeat_interval = 50;
+    uint32_t seed = 0;
+    // A listening socket to take over instead of opening peers[id]
+    int listen_fd = -1;
+};
+
+// One RaftNode running as a process of a real cluster: the same coroutines
+// the simulator fuzzes, configured the same way, on System's real-time
+// backend. The only difference is the network: TcpNetwork also loses RPCs
+// to broken connections and timeouts, and reports them as the simulated
+// network reports those its full links drop.
+class RaftProcess {
+public:
+    using RaftNodeType = Node::BasicRaftNode<RealStack>;
+
+    // Throws std::invalid_argument on options a node cannot run with, and
+    // std::runtime_error if its socket cannot be opened.
+    explicit RaftProcess(const ProcessOptions& options);
+    // Runs due tasks and delivers received messages, then waits up to
+    // max_wait_ms (less if a task falls due sooner) for network events.
+    void poll(int max_wait_ms);
+    // Leaderships won since the process started
+    size_t elections_won() const { return elections_won_; }
+    const RaftNodeType& node() const { return *node_; }
+    const TcpNetwork& network() const { return *network_; }
+    int port() const { return network_->port(); }
+private:
+    EventLoop loop_;
+    std::shared_ptr<RealStack::Clock> clock_;
+    std::shared_ptr<RealStack::Executor> executor_;
+    std::shared_ptr<TcpNetwork> network_;
+    std::shared_ptr<System::BasicSystem<RealStack>> system_;
+    std::shared_ptr<RaftNodeType> node_;
+    std::shared_ptr<Routing::BasicRouter<RealStack>> router_;
+    bool was_leader_ = false;
+    size_t elections_won_ = 0;
+
+    void run_ready();
+};
+
+} // namespace Runtime
+
+#endif // _RAFT_PROCESS_H_
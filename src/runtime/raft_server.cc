@@ -0,0 +1,104 @@
+#include "src/log/log.h"
+#include "src/runtime/raft_process.h"
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int) { stop_requested = 1; }
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " --id=<n> --peers=<host:port>,<host:port>,..."
+              << " [--election-timeout=<min>-<max>] [--heartbeat=<ms>] [--seed=<n>] [--duration-ms=<ms>]"
+              << " [--verbose]" << std::endl;
+    std::cout << "  --peers             every node's endpoint, this one's included, in id order" << std::endl;
+    std::cout << "  --election-timeout  in milliseconds (default 150-300)" << std::endl;
+    std::cout << "  --heartbeat         leader heartbeat interval in milliseconds (default 50)" << std::endl;
+    std::cout << "  --duration-ms       exit after this long (default: run until SIGINT/SIGTERM)" << std::endl;
+    std::cout << "  --verbose           log every node and executor event" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+// One Raft node as a real process: the RaftNode the simulator runs, on an
+// epoll loop with real timers and TCP between the peers.
+int main(int argc, char* argv[]) {
+    Runtime::ProcessOptions options;
+    long long duration_ms = -1;
+    bool verbose = false;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--id=", 0) == 0) {
+                options.id = std::stoi(arg.substr(5));
+            } else if (arg.rfind("--peers=", 0) == 0) {
+                std::stringstream list(arg.substr(8));
+                std::string item;
+                while (std::getline(list, item, ',')) {
+                    options.peers.push_back(Runtime::parse_endpoint(item));
+                }
+            } else if (arg.rfind("--election-timeout=", 0) == 0) {
+                std::string range = arg.substr(19);
+                size_t dash = range.find('-');
+                if (dash == std::string::npos) {
+                    return usage(argv[0]);
+                }
+                options.election_timeout_min = std::stoi(range.substr(0, dash));
+                options.election_timeout_max = std::stoi(range.substr(dash + 1));
+            } else if (arg.rfind("--heartbeat=", 0) == 0) {
+                options.heartbeat_interval = std::stoi(arg.substr(12));
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoul(arg.substr(7));
+            } else if (arg.rfind("--duration-ms=", 0) == 0) {
+                duration_ms = std::stoll(arg.substr(14));
+            } else if (arg == "--verbose") {
+                verbose = true;
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+    if (options.peers.empty()) {
+        return usage(argv[0]);
+    }
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    Log::ScopedSink sink(verbose ? std::cout : Log::null_stream());
+    try {
+        Runtime::RaftProcess process(options);
+        std::cout << "[Runtime] Node " << options.id << " listening on port " << process.port() << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        size_t elections = 0;
+        while (!stop_requested) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            if (duration_ms >= 0 && elapsed.count() >= duration_ms) {
+                break;
+            }
+            process.poll(100);
+            if (process.elections_won() != elections) {
+                elections = process.elections_won();
+                std::cout << "[Runtime] Node " << options.id << " is leader for term " << process.node().get_term()
+                          << std::endl;
+            }
+        }
+        std::cout << "[Runtime] Node " << options.id << " stopping in term " << process.node().get_term() << ": "
+                  << process.network().messages_sent() << " messages sent, "
+                  << process.network().messages_received() << " received" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,388 @@
+#include "src/runtime/tcp_network.h"
+#include "src/io/codec.h"
+#include "src/log/log.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Runtime {
+
+namespace {
+
+const size_t HEADER_SIZE = 4;
+
+sockaddr_in resolve(const Endpoint& endpoint) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(endpoint.port));
+    if (inet_pton(AF_INET, endpoint.host.c_str(), &addr.sin_addr) == 1) {
+        return addr;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(endpoint.host.c_str(), nullptr, &hints, &found) != 0 || found == nullptr) {
+        throw std::runtime_error("Unable to resolve " + endpoint.host);
+    }
+    addr.sin_addr = reinterpret_cast<sockaddr_in*>(found->ai_addr)->sin_addr;
+    freeaddrinfo(found);
+    return addr;
+}
+
+void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw std::runtime_error("Unable to make socket non-blocking: " + std::string(strerror(errno)));
+    }
+}
+
+void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+} // namespace
+
+Endpoint parse_endpoint(const std::string& text) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == text.size()) {
+        throw std::invalid_argument("Expected host:port, got '" + text + "'");
+    }
+    size_t used = 0;
+    int port = std::stoi(text.substr(colon + 1), &used);
+    if (used != text.size() - colon - 1 || port < 0 || port > 65535) {
+        throw std::invalid_argument("Invalid port in '" + text + "'");
+    }
+    return Endpoint{text.substr(0, colon), port};
+}
+
+int open_listener(const Endpoint& endpoint) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open listening socket: " + std::string(strerror(errno)));
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = resolve(endpoint);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Unable to listen on " + endpoint.host + ":" + std::to_string(endpoint.port) + ": " +
+                                 strerror(error));
+    }
+    return fd;
+}
+
+int bound_port(int fd) {
+    sockaddr_in bound{};
+    socklen_t length = sizeof(bound);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &length) != 0) {
+        return -1;
+    }
+    return ntohs(bound.sin_port);
+}
+
+TcpNetwork::TcpNetwork(EventLoop& loop, int id, std::vector<Endpoint> peers, int listen_fd)
+    : loop_(loop), id_(id), peers_(std::move(peers)), listen_fd_(listen_fd), outgoing_(peers_.size()) {
+    if (id_ < 0 || static_cast<size_t>(id_) >= peers_.size()) {
+        throw std::invalid_argument("Node id " + std::to_string(id_) + " has no endpoint");
+    }
+    if (listen_fd_ < 0) {
+        listen_fd_ = open_listener(peers_[id_]);
+    }
+    set_nonblocking(listen_fd_);
+    port_ = bound_port(listen_fd_);
+    loop_.add(listen_fd_, EPOLLIN, [this](uint32_t) { accept_connections(); });
+}
+
+TcpNetwork::~TcpNetwork() {
+    for (auto& out : outgoing_) {
+        if (out.fd >= 0) {
+            loop_.remove(out.fd);
+            ::close(out.fd);
+        }
+    }
+    for (auto& [fd, in] : incoming_) {
+        loop_.remove(fd);
+        ::close(fd);
+    }
+    loop_.remove(listen_fd_);
+    ::close(listen_fd_);
+}
+
+void TcpNetwork::push_entry(IO::Envelope msg) {
+    auto now = std::chrono::steady_clock::now();
+    if (IO::is_request(msg.type())) {
+        pending_requests_[msg.message_id] = now;
+        request_order_.emplace_back(now, msg.message_id);
+    }
+    ++messages_sent_;
+    if (msg.to == id_) {
+        receive(std::move(msg));
+        return;
+    }
+    if (msg.to < 0 || static_cast<size_t>(msg.to) >= peers_.size()) {
+        throw std::invalid_argument("No endpoint for node " + std::to_string(msg.to));
+    }
+    size_t size = IO::encoded_size(msg);
+    std::vector<uint8_t> frame(HEADER_SIZE + size);
+    uint32_t length = htonl(static_cast<uint32_t>(size));
+    std::memcpy(frame.data(), &length, HEADER_SIZE);
+    IO::encode(msg, std::span<uint8_t>(frame).subspan(HEADER_SIZE));
+
+    Outgoing& out = outgoing_[msg.to];
+    if (out.frames.size() >= MAX_QUEUED_FRAMES) {
+        // Make room by dropping the oldest frame not being written
+        auto oldest = out.frames.begin() + (out.written > 0 ? 1 : 0);
+        lose(*oldest);
+        out.frames.erase(oldest);
+    }
+    out.frames.push_back(Frame{std::move(frame), IO::is_request(msg.type()) ? msg.message_id : -1, now});
+    if (out.connected) {
+        flush(msg.to);
+    } else if (out.fd < 0 && !out.retry_pending) {
+        connect_to(msg.to);
+    }
+}
+
+std::vector<IO::Envelope> TcpNetwork::fetch_ready() {
+    std::vector<IO::Envelope> results;
+    results.swap(received_);
+    return results;
+}
+
+std::vector<IO::LostRpc> TcpNetwork::fetch_lost() {
+    expire_requests();
+    std::vector<IO::LostRpc> lost;
+    lost.swap(lost_);
+    return lost;
+}
+
+void TcpNetwork::accept_connections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        set_nodelay(fd);
+        incoming_[fd] = Incoming{};
+        loop_.add(fd, EPOLLIN | EPOLLRDHUP, [this, fd](uint32_t) { read_from(fd); });
+    }
+}
+
+void TcpNetwork::read_from(int fd) {
+    auto& buffer = incoming_[fd].buffer;
+    bool closed = false;
+    uint8_t chunk[65536];
+    while (true) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+            continue;
+        }
+        closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+        if (!closed && errno == EINTR) {
+            continue;
+        }
+        break;
+    }
+
+    size_t offset = 0;
+    while (buffer.size() - offset >= HEADER_SIZE) {
+        uint32_t length;
+        std::memcpy(&length, buffer.data() + offset, HEADER_SIZE);
+        length = ntohl(length);
+        if (length > MAX_FRAME_SIZE) {
+            Log::out() << "[Runtime] Dropping connection sending a " << length << " byte frame" << std::endl;
+            close_incoming(fd);
+            return;
+        }
+        if (buffer.size() - offset < HEADER_SIZE + length) {
+            break;
+        }
+        IO::Envelope msg;
+        try {
+            msg = IO::decode(std::span<const uint8_t>(buffer.data() + offset + HEADER_SIZE, length));
+        } catch (const IO::CodecError& e) {
+            Log::out() << "[Runtime] Dropping connection sending a bad frame: " << e.what() << std::endl;
+            close_incoming(fd);
+            return;
+        }
+        if (!addressed_here(msg)) {
+            ++misaddressed_frames_;
+            Log::out() << "[Runtime] Dropping connection sending a frame for node " << msg.to << " to node " << id_
+                       << std::endl;
+            close_incoming(fd);
+            return;
+        }
+        receive(std::move(msg));
+        offset += HEADER_SIZE + length;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+    if (closed) {
+        close_incoming(fd);
+    }
+}
+
+bool TcpNetwork::addressed_here(const IO::Envelope& msg) const {
+    if (msg.to != id_) {
+        return false;
+    }
+    // Only this node's slot in the router is filled: what a batch carries must be for it too
+    if (auto* batch = std::get_if<IO::HeartbeatBatch>(&msg.content)) {
+        return std::all_of(batch->messages().begin(), batch->messages().end(),
+                           [this](const IO::Envelope& inner) { return inner.to == id_; });
+    }
+    return true;
+}
+
+void TcpNetwork::close_incoming(int fd) {
+    loop_.remove(fd);
+    ::close(fd);
+    incoming_.erase(fd);
+}
+
+void TcpNetwork::connect_to(int peer) {
+    Outgoing& out = outgoing_[peer];
+    out.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (out.fd < 0) {
+        throw std::runtime_error("Unable to open socket: " + std::string(strerror(errno)));
+    }
+    set_nodelay(out.fd);
+    sockaddr_in addr = resolve(peers_[peer]);
+    if (connect(out.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 && errno != EINPROGRESS) {
+        drop_connection(peer);
+        return;
+    }
+    // Writable once connected (or failed)
+    loop_.add(out.fd, EPOLLOUT | EPOLLIN | EPOLLRDHUP, [this, peer](uint32_t events) { on_writable(peer, events); });
+}
+
+void TcpNetwork::on_writable(int peer, uint32_t events) {
+    Outgoing& out = outgoing_[peer];
+    if (!out.connected) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(out.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0 || (events & (EPOLLERR | EPOLLHUP))) {
+            drop_connection(peer);
+            return;
+        }
+        out.connected = true;
+    }
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+        // Peers never write back on this connection: readable means it closed
+        uint8_t discard[256];
+        if (::read(out.fd, discard, sizeof(discard)) <= 0 || (events & (EPOLLERR | EPOLLHUP))) {
+            drop_connection(peer);
+            return;
+        }
+    }
+    flush(peer);
+}
+
+void TcpNetwork::flush(int peer) {
+    Outgoing& out = outgoing_[peer];
+    while (!out.frames.empty()) {
+        const auto& frame = out.frames.front().bytes;
+        ssize_t n = ::send(out.fd, frame.data() + out.written, frame.size() - out.written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            drop_connection(peer);
+            return;
+        }
+        out.written += n;
+        bytes_sent_ += n;
+        if (out.written == frame.size()) {
+            out.frames.pop_front();
+            out.written = 0;
+        }
+    }
+    // Only wait for writability while something is left to write
+    loop_.modify(out.fd, EPOLLIN | EPOLLRDHUP | (out.frames.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT)));
+}
+
+void TcpNetwork::drop_connection(int peer) {
+    Outgoing& out = outgoing_[peer];
+    loop_.remove(out.fd);
+    ::close(out.fd);
+    out.fd = -1;
+    out.connected = false;
+    if (out.written > 0) {
+        lose(out.frames.front());
+        out.frames.pop_front();
+        out.written = 0;
+    }
+    // Heartbeats and votes go stale: what waited out a request's timeout is
+    // not worth another attempt
+    auto stale = std::chrono::steady_clock::now() - std::chrono::milliseconds(RPC_TIMEOUT_MS);
+    while (!out.frames.empty() && out.frames.front().queued_at <= stale) {
+        lose(out.frames.front());
+        out.frames.pop_front();
+    }
+    if (out.frames.empty()) {
+        // The next message reconnects
+        return;
+    }
+    out.retry_pending = true;
+    loop_.call_after(RECONNECT_DELAY_MS, [this, peer, alive = std::weak_ptr<bool>(alive_)]() {
+        if (alive.expired()) {
+            return;
+        }
+        Outgoing& out = outgoing_[peer];
+        out.retry_pending = false;
+        if (out.fd < 0 && !out.frames.empty()) {
+            connect_to(peer);
+        }
+    });
+}
+
+void TcpNetwork::lose(const Frame& frame) {
+    if (frame.request_id >= 0) {
+        lose_request(frame.request_id);
+    }
+}
+
+void TcpNetwork::lose_request(int id) {
+    if (pending_requests_.erase(id) > 0) {
+        lost_.push_back(IO::LostRpc{id, id_});
+    }
+}
+
+void TcpNetwork::expire_requests() {
+    auto expired = std::chrono::steady_clock::now() - std::chrono::milliseconds(RPC_TIMEOUT_MS);
+    while (!request_order_.empty() && request_order_.front().first <= expired) {
+        lose_request(request_order_.front().second);
+        request_order_.pop_front();
+    }
+}
+
+void TcpNetwork::receive(IO::Envelope msg) {
+    ++messages_received_;
+    if (IO::is_response(msg.type())) {
+        auto it = pending_requests_.find(msg.message_id);
+        if (it == pending_requests_.end()) {
+            // Given up on: its caller already resumed without it
+            ++late_responses_;
+            return;
+        }
+        std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - it->second;
+        rpc_latencies_us_.push_back(latency.count());
+        pending_requests_.erase(it);
+    }
+    received_.push_back(std::move(msg));
+}
+
+} // namespace Runtime
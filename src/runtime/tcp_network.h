@@ -0,0 +1,139 @@
+#ifndef _TCP_NETWORK_H_
+#define _TCP_NETWORK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "src/io/messages.h"
+#include "src/io/network.h"
+#include "src/runtime/event_loop.h"
+
+namespace Runtime {
+
+struct Endpoint {
+    std::string host;
+    int port = 0;
+};
+
+// Parses "host:port"; throws std::invalid_argument if it is not one.
+Endpoint parse_endpoint(const std::string& text);
+
+// Opens a listening socket on endpoint (port 0: any free port) and returns
+// it. Throws std::runtime_error if it cannot.
+int open_listener(const Endpoint& endpoint);
+// Port a socket is bound to.
+int bound_port(int fd);
+
+// What System and Router need of a network (push_entry, fetch_ready,
+// fetch_lost, has_messages), over non-blocking TCP between processes. Node i listens on
+// peers[i]; messages to node j go over one outgoing connection to peers[j],
+// opened on first use and reopened if it drops. Each message is framed as
+// [u32 big-endian length][IO::encode(msg)]. A frame addressed to any node
+// but this one is dropped with its connection.
+//
+// Messages to a peer that is not up yet wait in its queue while connecting
+// is retried; a frame only partly written when a connection breaks is lost,
+// as it would be on a real network. What a peer that stays down can hold is
+// bounded: its queue keeps the newest MAX_QUEUED_FRAMES frames, a failed
+// reconnect drops the frames older than RPC_TIMEOUT_MS, and a request not
+// answered within RPC_TIMEOUT_MS is given up on (its response, should it
+// still come, is dropped). Every request lost or given up on is reported
+// through fetch_lost, so its caller stops waiting on it.
+class TcpNetwork {
+public:
+    static constexpr size_t MAX_FRAME_SIZE = 1 << 20;
+    static constexpr int RECONNECT_DELAY_MS = 20;
+    static constexpr size_t MAX_QUEUED_FRAMES = 1024;
+    static constexpr int RPC_TIMEOUT_MS = 1000;
+
+    // listen_fd is a bound, listening socket to take over, or -1 to open one
+    // on peers[id]. Throws std::runtime_error if sockets cannot be set up.
+    TcpNetwork(EventLoop& loop, int id, std::vector<Endpoint> peers, int listen_fd = -1);
+    ~TcpNetwork();
+    TcpNetwork(const TcpNetwork&) = delete;
+    TcpNetwork& operator=(const TcpNetwork&) = delete;
+
+    void push_entry(IO::Envelope msg);
+    // Messages received since the last call, in arrival order.
+    std::vector<IO::Envelope> fetch_ready();
+    // RPCs of this node lost since the last call, including the requests
+    // that have now gone unanswered for RPC_TIMEOUT_MS.
+    std::vector<IO::LostRpc> fetch_lost();
+    bool has_messages() const { return !received_.empty(); }
+
+    int port() const { return port_; }
+    size_t messages_sent() const { return messages_sent_; }
+    size_t messages_received() const { return messages_received_; }
+    size_t bytes_sent() const { return bytes_sent_; }
+    // Frames received for another node; each closes the connection it came on
+    size_t misaddressed_frames() const { return misaddressed_frames_; }
+    // Frames waiting to be written to peer
+    size_t queued_frames(int peer) const { return outgoing_.at(peer).frames.size(); }
+    // Requests sent and neither answered nor given up on yet
+    size_t pending_requests() const { return pending_requests_.size(); }
+    // Responses dropped because their request had been given up on
+    size_t late_responses() const { return late_responses_; }
+    // Time from sending each request this node made to receiving its
+    // response, in microseconds, oldest first.
+    const std::vector<double>& rpc_latencies_us() const { return rpc_latencies_us_; }
+private:
+    struct Frame {
+        std::vector<uint8_t> bytes;
+        // Message id of the request it carries, or -1 for any other message
+        int request_id = -1;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+    struct Outgoing {
+        int fd = -1;
+        bool connected = false;
+        bool retry_pending = false;
+        std::deque<Frame> frames;
+        // Bytes of frames.front() already written
+        size_t written = 0;
+    };
+    struct Incoming {
+        std::vector<uint8_t> buffer;
+    };
+
+    EventLoop& loop_;
+    int id_;
+    std::vector<Endpoint> peers_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::vector<Outgoing> outgoing_;
+    std::unordered_map<int, Incoming> incoming_;
+    std::vector<IO::Envelope> received_;
+    std::unordered_map<int, std::chrono::steady_clock::time_point> pending_requests_;
+    // The requests in pending_requests_ (and some since answered), oldest first
+    std::deque<std::pair<std::chrono::steady_clock::time_point, int>> request_order_;
+    std::vector<IO::LostRpc> lost_;
+    std::vector<double> rpc_latencies_us_;
+    size_t messages_sent_ = 0;
+    size_t messages_received_ = 0;
+    size_t bytes_sent_ = 0;
+    size_t misaddressed_frames_ = 0;
+    size_t late_responses_ = 0;
+    // Lets reconnect timers still queued in the loop see the network is gone
+    std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+
+    void accept_connections();
+    void read_from(int fd);
+    bool addressed_here(const IO::Envelope& msg) const;
+    void close_incoming(int fd);
+    void connect_to(int peer);
+    void on_writable(int peer, uint32_t events);
+    void flush(int peer);
+    void drop_connection(int peer);
+    void lose(const Frame& frame);
+    void lose_request(int id);
+    void expire_requests();
+    void receive(IO::Envelope msg);
+};
+
+} // namespace Runtime
+
+#endif // _TCP_NETWORK_H_
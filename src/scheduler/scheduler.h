@@ -2,9 +2,10 @@
 #define _SCHEDULER_H_
 
 #include <functional>
+#include <memory>
 #include "src/clock/clock.h"
 #include "src/executor/executor.h"
-#include "src/clock/clock.h"
+#include "src/log/log.h"
 #include "src/rng/rng.h"
 
 namespace Scheduler {
@@ -13,27 +14,55 @@ class Scheduler {
 public:
     virtual void schedule_task(std::function<void()> task) = 0;
     virtual void schedule_task_with_delay(std::function<void()> task, int delay) = 0;
+    // Schedules work started on behalf of node `owner` (see Executor::push_task_for).
+    virtual void schedule_task_for(int owner, std::function<void()> task) {
+        (void)owner;
+        schedule_task(std::move(task));
+    }
     virtual ~Scheduler() = default;
 };
 
-class DeterministicScheduler : public Scheduler {
+// Schedules tasks with a random jitter of up to base_jitter ticks. The
+// template parameters are the types it holds: the Executor, RNG and Clock
+// interfaces (DeterministicScheduler, for tests and mocks), or concrete final
+// classes so every call on the scheduling path is resolved at compile time.
+template<typename ExecutorT, typename RNGT, typename ClockT>
+class BasicDeterministicScheduler final : public Scheduler {
 private:
-    std::shared_ptr<Executor::Executor> executor_;
-    std::shared_ptr<RNG::RNG> rng_;
-    std::shared_ptr<Clock::Clock> clock_;
+    std::shared_ptr<ExecutorT> executor_;
+    std::shared_ptr<RNGT> rng_;
+    std::shared_ptr<ClockT> clock_;
     int base_jitter_;
 public:
-    void schedule_task(std::function<void()> task) override;
-    void schedule_task_with_delay(std::function<void()> task, int delay) override;
-    DeterministicScheduler(
-        std::shared_ptr<Executor::Executor> executor,
-        std::shared_ptr<RNG::RNG> rng,
-        std::shared_ptr<Clock::Clock> clock,
+    void schedule_task(std::function<void()> task) override {
+        int jitter = rng_->draw(0, base_jitter_);
+        int now = clock_->now();
+        executor_->push_task(std::move(task), now + jitter);
+        Log::out() << "[Scheduler] time = " << now << ", scheduled for time " << now + jitter << std::endl;
+    }
+    void schedule_task_with_delay(std::function<void()> task, int delay) override {
+        int now = clock_->now();
+        int jitter = rng_->draw(0, base_jitter_);
+        executor_->push_task(std::move(task), now + delay + jitter);
+        Log::out() << "[Scheduler]  time = " << now << ", scheduled for time " << now + delay + jitter << std::endl;
+    }
+    void schedule_task_for(int owner, std::function<void()> task) override {
+        int jitter = rng_->draw(0, base_jitter_);
+        int now = clock_->now();
+        executor_->push_task_for(owner, std::move(task), now + jitter);
+        Log::out() << "[Scheduler] time = " << now << ", scheduled for time " << now + jitter << " (node " << owner << ")" << std::endl;
+    }
+    BasicDeterministicScheduler(
+        std::shared_ptr<ExecutorT> executor,
+        std::shared_ptr<RNGT> rng,
+        std::shared_ptr<ClockT> clock,
         int base_jitter
-    );
-    ~DeterministicScheduler() = default;
+    ) : executor_(std::move(executor)), rng_(std::move(rng)), clock_(std::move(clock)), base_jitter_(base_jitter) {}
+    ~BasicDeterministicScheduler() = default;
 };
 
+using DeterministicScheduler = BasicDeterministicScheduler<Executor::Executor, RNG::RNG, Clock::Clock>;
+
 }
 
 #endif // _SCHEDULER_H_
\ No newline at end of file
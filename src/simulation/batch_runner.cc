@@ -0,0 +1,187 @@
+#include "src/simulation/batch_runner.h"
+#include "src/log/log.h"
+#include "src/simulation/simulation_harness.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace Simulation {
+
+namespace {
+
+const char SUMMARY_MAGIC[] = "RBATCH01";
+const size_t MAGIC_SIZE = 8;
+
+template<typename T>
+void put(std::string& record, T value) {
+    record.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool get(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+RunSummary run_one(size_t index, const FuzzInput& input, std::ostream& log) {
+    Log::ScopedSink sink(log);
+    auto start = std::chrono::steady_clock::now();
+    SimulationResult result;
+    StaticSimulationContext ctx(input);
+    while (advance(ctx, result)) {}
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    RunSummary summary;
+    summary.index = index;
+    summary.seed = input.rng_seed;
+    summary.violation = result.oracle_violation;
+    summary.steps = result.steps;
+    summary.states = result.coverage.count();
+    summary.wall_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    summary.invariant = result.memory_exceeded ? "memory budget exceeded" : result.violated_invariant;
+    return summary;
+}
+
+} // namespace
+
+CsvSummaryWriter::CsvSummaryWriter(std::ostream& out) : out_(out) {
+    out_ << "index,seed,violation,steps,states,wall_ms,invariant\n";
+}
+
+void CsvSummaryWriter::write(const RunSummary& summary) {
+    // Invariant names are free text: quote them, doubling embedded quotes
+    std::string invariant;
+    for (char c : summary.invariant) {
+        invariant += c == '"' ? "\"\"" : std::string(1, c);
+    }
+    out_ << summary.index << ',' << summary.seed << ',' << summary.violation << ',' << summary.steps << ','
+         << summary.states << ',' << std::fixed << std::setprecision(3) << summary.wall_ms << ",\"" << invariant
+         << "\"\n";
+}
+
+BinarySummaryWriter::BinarySummaryWriter(std::ostream& out) : out_(out) {
+    out_.write(SUMMARY_MAGIC, MAGIC_SIZE);
+}
+
+void BinarySummaryWriter::write(const RunSummary& summary) {
+    std::string record;
+    put<uint64_t>(record, summary.index);
+    put<uint32_t>(record, summary.seed);
+    put<uint8_t>(record, summary.violation);
+    put<int32_t>(record, summary.steps);
+    put<uint32_t>(record, summary.states);
+    put<double>(record, summary.wall_ms);
+    uint16_t size = std::min<size_t>(summary.invariant.size(), UINT16_MAX);
+    put<uint16_t>(record, size);
+    record.append(summary.invariant, 0, size);
+    // One write per record, so a killed batch can only tear the last one
+    out_.write(record.data(), record.size());
+}
+
+std::vector<RunSummary> read_binary_summaries(std::istream& in) {
+    char magic[MAGIC_SIZE];
+    if (!in.read(magic, MAGIC_SIZE) || std::memcmp(magic, SUMMARY_MAGIC, MAGIC_SIZE) != 0) {
+        throw std::runtime_error("Not a batch summary file");
+    }
+    std::vector<RunSummary> summaries;
+    while (true) {
+        RunSummary summary;
+        uint8_t violation;
+        int32_t steps;
+        uint16_t size;
+        if (!get(in, summary.index) || !get(in, summary.seed) || !get(in, violation) || !get(in, steps) ||
+            !get(in, summary.states) || !get(in, summary.wall_ms) || !get(in, size)) {
+            break;
+        }
+        summary.violation = violation != 0;
+        summary.steps = steps;
+        summary.invariant.resize(size);
+        if (!in.read(summary.invariant.data(), size)) {
+            break;
+        }
+        summaries.push_back(std::move(summary));
+    }
+    return summaries;
+}
+
+BatchStats run_batch(size_t count, const std::function<FuzzInput(size_t)>& input_at, SummaryWriter& writer,
+                     const BatchOptions& options) {
+    int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (!options.log_dir.empty()) {
+        std::filesystem::create_directories(options.log_dir);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    // Runs share nothing but the index counter and the writer
+    std::atomic<size_t> next_index{0};
+    std::atomic<size_t> violations{0};
+    std::mutex writer_mutex;
+    auto worker = [&]() {
+        for (size_t index = next_index++; index < count; index = next_index++) {
+            FuzzInput input = input_at(index);
+            RunSummary summary;
+            if (options.log_dir.empty()) {
+                summary = run_one(index, input, Log::null_stream());
+            } else {
+                std::ofstream log(options.log_dir + "/run_" + std::to_string(index) + ".log");
+                summary = run_one(index, input, log);
+            }
+            violations += summary.violation;
+            std::lock_guard<std::mutex> lock(writer_mutex);
+            writer.write(summary);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads && static_cast<size_t>(i) < count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    BatchStats stats;
+    stats.runs = count;
+    stats.violations = violations.load();
+    stats.threads = threads;
+    stats.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+FuzzInput input_for_seed(uint32_t seed, int max_steps) {
+    FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+std::vector<FuzzInput> read_inputs(std::istream& in) {
+    std::vector<FuzzInput> inputs;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<uint8_t> bytes;
+        try {
+            bytes = from_hex(line);
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Line " + std::to_string(line_number) + ": " + e.what());
+        }
+        inputs.push_back(FuzzInput::from_bytes(bytes.data(), bytes.size()));
+    }
+    return inputs;
+}
+
+} // namespace Simulation
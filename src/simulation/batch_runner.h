@@ -0,0 +1,95 @@
+#ifndef _BATCH_RUNNER_H_
+#define _BATCH_RUNNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "src/simulation/fuzz_input.h"
+
+namespace Simulation {
+
+// Outcome of one simulation in a batch.
+struct RunSummary {
+    // Position of the input in the batch; summaries arrive in completion order
+    uint64_t index = 0;
+    uint32_t seed = 0;
+    bool violation = false;
+    int steps = 0;
+    // Distinct cluster states visited (coverage slots hit)
+    uint32_t states = 0;
+    double wall_ms = 0;
+    // Empty unless violation, or "memory budget exceeded" for a run stopped
+    // for holding too much
+    std::string invariant;
+
+    bool operator==(const RunSummary& other) const = default;
+};
+
+// Where a batch streams its summaries. Only ever called by one thread at a time.
+class SummaryWriter {
+public:
+    virtual ~SummaryWriter() = default;
+    virtual void write(const RunSummary& summary) = 0;
+};
+
+// One line per run after a header:
+//   index,seed,violation,steps,states,wall_ms,invariant
+class CsvSummaryWriter : public SummaryWriter {
+private:
+    std::ostream& out_;
+public:
+    explicit CsvSummaryWriter(std::ostream& out);
+    void write(const RunSummary& summary) override;
+};
+
+// "RBATCH01", then one record per run:
+//   [u64 index][u32 seed][u8 violation][i32 steps][u32 states][f64 wall_ms]
+//   [u16 size][size bytes of invariant]
+// little endian, as the other on-disk formats.
+class BinarySummaryWriter : public SummaryWriter {
+private:
+    std::ostream& out_;
+public:
+    explicit BinarySummaryWriter(std::ostream& out);
+    void write(const RunSummary& summary) override;
+};
+
+// Reads what a BinarySummaryWriter wrote; a torn last record is dropped.
+// Throws std::runtime_error on a bad magic.
+std::vector<RunSummary> read_binary_summaries(std::istream& in);
+
+struct BatchOptions {
+    // 0: one per hardware thread
+    int threads = 0;
+    // If set, each run's log goes to <log_dir>/run_<index>.log; otherwise it is dropped
+    std::string log_dir{};
+};
+
+struct BatchStats {
+    size_t runs = 0;
+    size_t violations = 0;
+    int threads = 0;
+    double wall_ms = 0;
+};
+
+// Runs input_at(0) .. input_at(count - 1) as independent simulations on a pool
+// of threads, each building its own SimulationContext and logging to its own
+// sink, and hands every summary to writer as soon as the run ends. input_at
+// is called from the worker threads.
+BatchStats run_batch(size_t count, const std::function<FuzzInput(size_t)>& input_at, SummaryWriter& writer,
+                     const BatchOptions& options = {});
+
+// The default FuzzInput with rng_seed = seed.
+FuzzInput input_for_seed(uint32_t seed, int max_steps = FuzzInput{}.max_steps);
+
+// One hex-encoded FuzzInput per line; blank lines and lines starting with #
+// are skipped. Throws std::invalid_argument on a malformed line.
+std::vector<FuzzInput> read_inputs(std::istream& in);
+
+} // namespace Simulation
+
+#endif // _BATCH_RUNNER_H_
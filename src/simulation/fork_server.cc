@@ -0,0 +1,189 @@
+#include "src/simulation/fork_server.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace Simulation {
+
+namespace {
+
+void write_all(int fd, const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0) {
+            _exit(1);
+        }
+        bytes += written;
+        size -= written;
+    }
+}
+
+std::vector<uint8_t> read_all(int fd) {
+    std::vector<uint8_t> buffer;
+    uint8_t chunk[4096];
+    while (true) {
+        ssize_t nread = ::read(fd, chunk, sizeof(chunk));
+        if (nread < 0) {
+            throw std::runtime_error("Failed reading branch result from fork server child");
+        }
+        if (nread == 0) {
+            break;
+        }
+        buffer.insert(buffer.end(), chunk, chunk + nread);
+    }
+    return buffer;
+}
+
+// Wire format child -> parent: [u8 violation][u64 msg len][msg][u64 invariant len][invariant]
+// [i32 steps][i32 candidates, split votes, term gap][u64 nr slots][(u32 slot, u8 bucket bits) per slot]
+void send_result(int fd, const SimulationResult& result) {
+    uint8_t violation = result.oracle_violation ? 1 : 0;
+    uint64_t msg_len = result.error_message.size();
+    uint64_t invariant_len = result.violated_invariant.size();
+    int32_t steps = result.steps;
+    uint64_t nr_slots = result.coverage.count();
+    write_all(fd, &violation, sizeof(violation));
+    write_all(fd, &msg_len, sizeof(msg_len));
+    write_all(fd, result.error_message.data(), msg_len);
+    write_all(fd, &invariant_len, sizeof(invariant_len));
+    write_all(fd, result.violated_invariant.data(), invariant_len);
+    write_all(fd, &steps, sizeof(steps));
+    int32_t proximity[3] = {result.proximity.concurrent_candidates, result.proximity.split_votes,
+                            result.proximity.term_gap};
+    write_all(fd, proximity, sizeof(proximity));
+    write_all(fd, &nr_slots, sizeof(nr_slots));
+    std::vector<uint8_t> slots;
+    slots.reserve(nr_slots * 5);
+    for (uint32_t slot : result.coverage.slots()) {
+        auto slot_bytes = reinterpret_cast<const uint8_t*>(&slot);
+        slots.insert(slots.end(), slot_bytes, slot_bytes + sizeof(slot));
+        slots.push_back(result.coverage.at(slot));
+    }
+    write_all(fd, slots.data(), slots.size());
+}
+
+SimulationResult receive_result(const std::vector<uint8_t>& buffer) {
+    SimulationResult result;
+    size_t offset = 0;
+    auto take = [&](void* out, size_t size) {
+        if (offset + size > buffer.size()) {
+            throw std::runtime_error("Truncated branch result from fork server child");
+        }
+        std::memcpy(out, buffer.data() + offset, size);
+        offset += size;
+    };
+    uint8_t violation;
+    uint64_t msg_len, invariant_len, nr_slots;
+    int32_t steps;
+    take(&violation, sizeof(violation));
+    take(&msg_len, sizeof(msg_len));
+    result.oracle_violation = violation != 0;
+    result.error_message.resize(msg_len);
+    take(result.error_message.data(), msg_len);
+    take(&invariant_len, sizeof(invariant_len));
+    result.violated_invariant.resize(invariant_len);
+    take(result.violated_invariant.data(), invariant_len);
+    take(&steps, sizeof(steps));
+    result.steps = steps;
+    int32_t proximity[3];
+    take(proximity, sizeof(proximity));
+    result.proximity = {proximity[0], proximity[1], proximity[2]};
+    take(&nr_slots, sizeof(nr_slots));
+    for (uint64_t i = 0; i < nr_slots; ++i) {
+        uint32_t slot;
+        uint8_t bits;
+        take(&slot, sizeof(slot));
+        take(&bits, sizeof(bits));
+        result.coverage.set(slot, bits);
+    }
+    return result;
+}
+
+} // namespace
+
+ForkServer::ForkServer(const std::vector<uint8_t>& base_input, CheckpointPolicy policy)
+    : trunk_input_(FuzzInput::from_bytes(base_input.data(), base_input.size())),
+      policy_(policy) {
+    trunk_input_.branch_step = 0;
+    trunk_input_.branch_seed = 0;
+    SuppressOutput suppress;
+    ctx_ = std::make_unique<StaticSimulationContext>(trunk_input_);
+}
+
+ForkServer::~ForkServer() = default;
+
+bool ForkServer::reach_checkpoint(const Coverage::GlobalCoverage* known) {
+    SuppressOutput suppress;
+    int first_step = std::max(policy_.step, 1);
+    while (true) {
+        if (!policy_.on_new_state && ctx_->steps() >= first_step) {
+            break;
+        }
+        size_t seen_before = prefix_result_.coverage.count();
+        if (!advance(*ctx_, prefix_result_)) {
+            break;
+        }
+        bool new_to_run = prefix_result_.coverage.count() > seen_before;
+        if (policy_.on_new_state && ctx_->steps() >= first_step && new_to_run &&
+            (known == nullptr || !known->covers(ctx_->state_hash()))) {
+            break;
+        }
+    }
+    // A checkpoint is only useful if the continuation still has steps to run.
+    at_checkpoint_ = !prefix_result_.oracle_violation && !ctx_->done();
+    return at_checkpoint_;
+}
+
+SimulationResult ForkServer::branch(uint32_t branch_seed) {
+    if (!at_checkpoint_) {
+        throw std::runtime_error("Fork server asked to branch before reaching a checkpoint");
+    }
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("Fork server could not create a pipe");
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("Fork server could not fork");
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        SimulationResult result = prefix_result_;
+        {
+            SuppressOutput suppress;
+            ctx_->reseed(branch_seed);
+            while (advance(*ctx_, result)) {}
+            result.coverage.classify();
+        }
+        send_result(fds[1], result);
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    std::vector<uint8_t> buffer = read_all(fds[0]);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("Fork server child died with status " + std::to_string(status));
+    }
+    return receive_result(buffer);
+}
+
+std::vector<uint8_t> ForkServer::branch_input(uint32_t branch_seed) const {
+    FuzzInput branched = trunk_input_;
+    branched.branch_step = ctx_->steps();
+    branched.branch_seed = branch_seed;
+    return branched.to_bytes();
+}
+
+} // namespace Simulation
@@ -0,0 +1,56 @@
+#ifndef _FORK_SERVER_H_
+#define _FORK_SERVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+
+namespace Simulation {
+
+// Where the fork server stops the trunk run and starts branching.
+struct CheckpointPolicy {
+    // Never checkpoint before this many steps have run, nor before the first
+    // (branch_step 0 in an input means no branch, so step 0 has no replay).
+    int step = 0;
+    // Additionally wait for the first step that lands on a cluster state not seen
+    // earlier in the run (nor covered by known, when given).
+    bool on_new_state = false;
+};
+
+// Runs the prefix of a simulation once, parks it at a checkpoint and then forks
+// one child per branch. Each child reseeds the RNG and runs the continuation to
+// completion, so the prefix is paid for once instead of once per execution.
+// Coroutine frames cannot be serialized, fork() is what snapshots them.
+//
+// Every branch is also expressible as a plain input (branch_step/branch_seed),
+// which replays from scratch to the same result.
+class ForkServer {
+private:
+    FuzzInput trunk_input_;
+    CheckpointPolicy policy_;
+    std::unique_ptr<StaticSimulationContext> ctx_;
+    SimulationResult prefix_result_;
+    bool at_checkpoint_ = false;
+public:
+    // Any branch point in base_input is dropped: the trunk runs unbranched.
+    ForkServer(const std::vector<uint8_t>& base_input, CheckpointPolicy policy);
+    ~ForkServer();
+
+    // Runs the trunk up to the checkpoint. Returns false when the simulation
+    // ends (or violates an invariant) before getting there.
+    bool reach_checkpoint(const Coverage::GlobalCoverage* known = nullptr);
+    int checkpoint_step() const { return ctx_->steps(); }
+    const SimulationResult& prefix_result() const { return prefix_result_; }
+
+    // Forks the checkpoint, continues it with branch_seed in a child process and
+    // returns what the whole run (prefix included) covered.
+    SimulationResult branch(uint32_t branch_seed);
+    // The from-scratch equivalent of branch(branch_seed).
+    std::vector<uint8_t> branch_input(uint32_t branch_seed) const;
+};
+
+} // namespace Simulation
+
+#endif // _FORK_SERVER_H_
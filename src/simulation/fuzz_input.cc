@@ -1,6 +1,7 @@
 #include "src/simulation/fuzz_input.h"
 #include <cstring>
 #include <algorithm>
+#include <string>
 
 namespace Simulation {
 
@@ -40,6 +41,11 @@ FuzzInput FuzzInput::from_bytes(const uint8_t* data, size_t size) {
     input.heartbeat_interval = read_uint16();
     input.max_network_delay = read_uint16();
     input.max_steps = read_uint16();
+    input.branch_step = read_uint16();
+    input.branch_seed = read_uint32();
+    if (offset < size) {
+        input.decisions.assign(data + offset, data + std::min(size, offset + MAX_DECISIONS));
+    }
 
     input.normalize();
     return input;
@@ -47,7 +53,7 @@ FuzzInput FuzzInput::from_bytes(const uint8_t* data, size_t size) {
 
 std::vector<uint8_t> FuzzInput::to_bytes() const {
     std::vector<uint8_t> bytes;
-    bytes.reserve(15); // 4 + 1 + 2*5 = 15 bytes
+    bytes.reserve(HEADER_SIZE + decisions.size()); // 4 + 1 + 2*5 + 2 + 4 = 21 bytes, then the decisions
 
     auto write_uint32 = [&](uint32_t val) {
         bytes.push_back((val >> 0) & 0xFF);
@@ -72,13 +78,16 @@ std::vector<uint8_t> FuzzInput::to_bytes() const {
     write_uint16(static_cast<uint16_t>(heartbeat_interval));
     write_uint16(static_cast<uint16_t>(max_network_delay));
     write_uint16(static_cast<uint16_t>(max_steps));
+    write_uint16(static_cast<uint16_t>(branch_step));
+    write_uint32(branch_seed);
+    bytes.insert(bytes.end(), decisions.begin(), decisions.end());
 
     return bytes;
 }
 
 void FuzzInput::normalize() {
     // Clamp node count to valid range (3-7 for meaningful Raft behavior)
-    nr_nodes = std::clamp(nr_nodes, 3, 7);
+    nr_nodes = std::clamp(nr_nodes, MIN_NODES, MAX_NODES);
 
     // Ensure timeouts are positive and reasonable
     election_timeout_min = std::clamp(election_timeout_min, 50, 1000);
@@ -92,6 +101,28 @@ void FuzzInput::normalize() {
 
     // Simulation steps bounded
     max_steps = std::clamp(max_steps, 100, 50000);
+
+    // A branch point past the end of the run is never reached
+    branch_step = std::clamp(branch_step, 0, max_steps);
+}
+
+std::string to_hex(const std::vector<uint8_t>& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (uint8_t byte : bytes) {
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0xF];
+    }
+    return hex;
+}
+
+std::vector<uint8_t> from_hex(const std::string& hex) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
 }
 
 } // namespace Fuzzer
@@ -2,6 +2,8 @@
 #define _FUZZ_INPUT_H_
 
 #include <cstdint>
+#include <cstddef>
+#include <string>
 #include <vector>
 
 namespace Simulation {
@@ -14,6 +16,22 @@ struct FuzzInput {
     int heartbeat_interval = 50;
     int max_network_delay = 100;
     int max_steps = 10000;
+    // When non-zero, the RNG is reseeded with branch_seed right before step
+    // branch_step runs, so a continuation forked off a checkpoint can be
+    // replayed from scratch.
+    int branch_step = 0;
+    uint32_t branch_seed = 0;
+    // Everything after the parameters: the decision stream the simulation's
+    // RNG draws from before falling back to rng_seed (see RNG::ByteStreamRNG).
+    std::vector<uint8_t> decisions;
+
+    // Encoded size of the parameters above, i.e. where decisions start.
+    static constexpr size_t HEADER_SIZE = 21;
+    static constexpr size_t MAX_DECISIONS = 1 << 16;
+    // Cluster sizes the fuzzer explores; larger clusters are set up through
+    // SimulationContext's Topology.
+    static constexpr int MIN_NODES = 3;
+    static constexpr int MAX_NODES = 7;
 
     static FuzzInput from_bytes(const uint8_t* data, size_t size);
     std::vector<uint8_t> to_bytes() const;
@@ -22,6 +40,10 @@ struct FuzzInput {
     void normalize();
 };
 
+// Inputs are printed and passed around on the command line as hex strings
+std::string to_hex(const std::vector<uint8_t>& bytes);
+std::vector<uint8_t> from_hex(const std::string& hex);
+
 } // namespace Simulation
 
 #endif // _FUZZ_INPUT_H_
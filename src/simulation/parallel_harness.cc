@@ -0,0 +1,298 @@
+#include "src/simulation/parallel_harness.h"
+#include "src/log/log.h"
+#include "src/node/raft_node_impl.h"
+#include "src/node/state.h"
+#include "src/system/system.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+template class Node::BasicRaftNode<Simulation::PartitionStack>;
+
+namespace Simulation {
+
+namespace {
+
+// Seed of node's RNG stream in a run seeded with seed
+uint64_t node_seed(uint32_t seed, int node) {
+    // splitmix64 finalizer, so neighbouring nodes start far apart
+    uint64_t x = (static_cast<uint64_t>(seed) << 32 | static_cast<uint32_t>(node)) + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+ParallelSimulationContext::ParallelSimulationContext(const FuzzInput& input, Topology topology,
+                                                     ParallelOptions options)
+    : input_(input) {
+    int nr_nodes = topology.nr_nodes > 0 ? topology.nr_nodes : input_.nr_nodes;
+    int group_size = topology.group_size > 0 ? topology.group_size : nr_nodes;
+    if (nr_nodes > Topology::MAX_NODES || group_size < FuzzInput::MIN_NODES || nr_nodes % group_size != 0) {
+        throw std::invalid_argument("Invalid topology: " + std::to_string(nr_nodes) + " nodes in groups of " +
+                                    std::to_string(group_size));
+    }
+    if (topology.hosts > 0 || topology.coalesce_heartbeats || topology.links.shaped()) {
+        throw std::invalid_argument("Invalid topology: partitions can only share messages, not hosts or links");
+    }
+    if (topology.links.base_latency < 0 || topology.links.overhead < 0 || topology.links.queue_limit < 0) {
+        throw std::invalid_argument("Link model parameters must not be negative");
+    }
+    lookahead_ = std::max(1, topology.links.base_latency);
+
+    int nr_threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    int nr_partitions = std::min(options.partitions > 0 ? options.partitions : nr_threads, nr_nodes);
+    nr_threads = std::min(nr_threads, nr_partitions);
+
+    // Balanced contiguous ranges; the networks point into partitions_, so it
+    // is sized once and for all
+    partitions_.resize(nr_partitions);
+    partition_of_.resize(nr_nodes);
+    std::vector<int> bounds;
+    for (int p = 0; p < nr_partitions; ++p) {
+        Partition& partition = partitions_[p];
+        partition.first = static_cast<int>(static_cast<long long>(p) * nr_nodes / nr_partitions);
+        partition.last = static_cast<int>(static_cast<long long>(p + 1) * nr_nodes / nr_partitions);
+        partition.clock = std::make_shared<Clock::DeterministicClock>();
+        partition.executor = std::make_shared<PartitionStack::Executor>(partition.clock);
+        partition.outbox.resize(nr_partitions);
+        partition.sent.resize(nr_partitions);
+        partition.memory = std::make_unique<Memory::RunMemory>();
+        std::fill(partition_of_.begin() + partition.first, partition_of_.begin() + partition.last, p);
+        bounds.push_back(partition.first);
+    }
+    bounds.push_back(nr_nodes);
+    table_ = std::make_shared<Node::NodeTable>(nr_nodes);
+    table_->partition(bounds);
+
+    const int MAX_TASK_SCHEDULE_JITTER = 100;
+    rngs_.reserve(nr_nodes);
+    systems_.reserve(nr_nodes);
+    networks_.reserve(nr_nodes);
+    raft_nodes_.reserve(nr_nodes);
+    for (int i = 0; i < nr_nodes; ++i) {
+        Partition& partition = partitions_[partition_of_[i]];
+        auto rng = std::make_shared<PartitionStack::RNG>(node_seed(input_.rng_seed, i));
+        auto scheduler = std::make_shared<PartitionStack::Scheduler>(partition.executor, rng, partition.clock,
+                                                                     MAX_TASK_SCHEDULE_JITTER);
+        auto network = std::make_shared<PartitionNetwork>(i, partition.clock, rng, input_.max_network_delay,
+                                                          topology.links.base_latency, &partition_of_,
+                                                          &partition.outbox);
+        auto system = std::make_shared<System::BasicSystem<PartitionStack>>(scheduler, partition.clock, rng, network);
+        auto node = std::make_shared<RaftNodeType>(
+            i, system, group_size,
+            input_.election_timeout_min,
+            input_.election_timeout_max,
+            input_.heartbeat_interval,
+            table_, i - i % group_size);
+        rngs_.push_back(rng);
+        networks_.push_back(network);
+        systems_.push_back(system);
+        raft_nodes_.push_back(node);
+
+        Memory::ScopedRun run(partition.memory.get());
+        auto main_loop = node->main_loop();
+        system->request_work_for(i, [main_loop]() { main_loop.h_.resume(); });
+    }
+    oracle_ = std::make_shared<Oracle::RaftOracle>(raft_nodes_);
+    oracle_->set_track_proximity(nr_nodes <= FuzzInput::MAX_NODES);
+
+    if (nr_threads > 1) {
+        start_ = std::make_unique<std::barrier<>>(nr_threads);
+        end_ = std::make_unique<std::barrier<>>(nr_threads);
+        for (int thread = 1; thread < nr_threads; ++thread) {
+            workers_.emplace_back(&ParallelSimulationContext::worker, this, thread);
+        }
+    }
+}
+
+ParallelSimulationContext::~ParallelSimulationContext() {
+    if (!workers_.empty()) {
+        stop_.store(true);
+        start_->arrive_and_wait();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+    // Nothing may resume the frames once they are gone
+    for (auto& system : systems_) {
+        system->suspended_rpcs.clear();
+        system->responses.clear();
+    }
+    for (auto& partition : partitions_) {
+        partition.memory->destroy_frames();
+    }
+}
+
+void ParallelSimulationContext::worker(int thread) {
+    while (true) {
+        start_->arrive_and_wait();
+        if (stop_.load()) {
+            return;
+        }
+        run_partitions(thread);
+        end_->arrive_and_wait();
+    }
+}
+
+void ParallelSimulationContext::run_partitions(int thread) {
+    Log::ScopedSink sink(*log_);
+    for (int index = thread; index < partitions(); index += threads()) {
+        try {
+            run_window(index);
+        } catch (...) {
+            partitions_[index].error = std::current_exception();
+        }
+    }
+}
+
+void ParallelSimulationContext::run_window(int index) {
+    Partition& partition = partitions_[index];
+    Memory::ScopedRun run(partition.memory.get());
+    // What the other partitions sent here during the last window; nothing is
+    // due before this window starts
+    for (auto& source : partitions_) {
+        for (auto& transit : source.sent[index]) {
+            partition.incoming.push(std::move(transit));
+        }
+        source.sent[index].clear();
+    }
+    for (int tick = 0; tick < window_ticks_; ++tick) {
+        if (input_.branch_step != 0 && steps_ + tick == input_.branch_step) {
+            for (int node = partition.first; node < partition.last; ++node) {
+                rngs_[node]->reseed(node_seed(input_.branch_seed, node));
+            }
+        }
+        partition.clock->tick();
+        route(partition);
+        partition.executor->run_until_blocked();
+    }
+}
+
+void ParallelSimulationContext::route(Partition& partition) {
+    partition.ready_nodes.clear();
+    long long now = partition.clock->now();
+    while (!partition.incoming.empty() && partition.incoming.top().arrival <= now) {
+        IO::Envelope msg = partition.incoming.top().envelope;
+        partition.incoming.pop();
+        partition.ready_nodes.push_back(msg.to);
+        raft_nodes_[msg.to]->inbox.push_back(std::move(msg));
+    }
+    // Dispatch in node order, once per node, as Routing::BasicRouter does
+    auto& ready = partition.ready_nodes;
+    std::sort(ready.begin(), ready.end());
+    ready.erase(std::unique(ready.begin(), ready.end()), ready.end());
+    for (int node_id : ready) {
+        systems_[node_id]->request_work_for(node_id, [node = raft_nodes_[node_id]]() { node->dispatch(); });
+    }
+}
+
+bool ParallelSimulationContext::done() {
+    if (steps_ >= input_.max_steps) {
+        return true;
+    }
+    for (const auto& partition : partitions_) {
+        if (partition.executor->has_work() || !partition.incoming.empty()) {
+            return false;
+        }
+        for (const auto& sent : partition.sent) {
+            if (!sent.empty()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t ParallelSimulationContext::step() {
+    window_ticks_ = std::max(1, std::min(lookahead_, input_.max_steps - steps_));
+    log_ = &Log::out();
+    if (workers_.empty()) {
+        run_partitions(0);
+    } else {
+        start_->arrive_and_wait();
+        run_partitions(0);
+        end_->arrive_and_wait();
+    }
+    steps_ += window_ticks_;
+    for (auto& partition : partitions_) {
+        std::swap(partition.outbox, partition.sent);
+    }
+    for (auto& partition : partitions_) {
+        if (partition.error) {
+            std::exception_ptr error = partition.error;
+            partition.error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    table_->merge_partitions();
+    if (raft_nodes_.size() <= static_cast<size_t>(FuzzInput::MAX_NODES)) {
+        state_hash_ = State::ClusterState::capture(raft_nodes_).hash();
+    } else {
+        state_hash_ = table_->digest();
+    }
+    oracle_->enforce_invariants();
+    table_->clear_changed();
+    return state_hash_;
+}
+
+size_t ParallelSimulationContext::tasks_run() const {
+    size_t total = 0;
+    for (const auto& partition : partitions_) {
+        total += partition.executor->tasks_run();
+    }
+    return total;
+}
+
+size_t ParallelSimulationContext::messages_sent() const {
+    size_t total = 0;
+    for (const auto& network : networks_) {
+        total += network->messages_sent();
+    }
+    return total;
+}
+
+Memory::Usage ParallelSimulationContext::memory_usage() const {
+    Memory::Usage usage;
+    for (const auto& partition : partitions_) {
+        usage.frames += partition.memory->frame_bytes();
+        usage.executor += partition.executor->pending() * sizeof(Executor::PendingTask);
+        size_t queued = partition.incoming.size();
+        for (const auto& sent : partition.sent) {
+            queued += sent.size();
+        }
+        usage.network += queued * sizeof(Transit);
+    }
+    for (const auto& system : systems_) {
+        usage.rpc += system->suspended_rpcs.size() * (sizeof(int) + sizeof(std::coroutine_handle<>)) +
+                     system->responses.size() * (sizeof(int) + sizeof(std::optional<IO::Envelope>));
+    }
+    return usage;
+}
+
+bool ParallelSimulationContext::within_memory_budget() {
+    if (memory_budget_ == 0) {
+        return true;
+    }
+    size_t total = memory_usage().total();
+    peak_usage_ = std::max(peak_usage_, total);
+    return total <= memory_budget_;
+}
+
+Memory::Report ParallelSimulationContext::memory_report() const {
+    Memory::Report report;
+    report.usage = memory_usage();
+    report.peak = std::max(peak_usage_, report.usage.total());
+    for (const auto& partition : partitions_) {
+        partition.memory->count_frames(report);
+    }
+    for (const auto& system : systems_) {
+        report.pending_rpcs += system->suspended_rpcs.size();
+        report.unclaimed_responses += system->responses.size();
+    }
+    return report;
+}
+
+} // namespace Simulation
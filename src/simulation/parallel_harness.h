@@ -0,0 +1,193 @@
+#ifndef _PARALLEL_HARNESS_H_
+#define _PARALLEL_HARNESS_H_
+
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/io/messages.h"
+#include "src/memory/memory.h"
+#include "src/node/node.h"
+#include "src/node/node_table.h"
+#include "src/oracle/oracle.h"
+#include "src/rng/rng.h"
+#include "src/scheduler/scheduler.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+
+namespace Simulation {
+
+class PartitionNetwork;
+
+// The stack of a node in a partitioned simulation: its partition's clock and
+// executor, but an RNG and a network endpoint of its own.
+struct PartitionStack {
+    using Clock = ::Clock::DeterministicClock;
+    using RNG = ::RNG::SplitMixRNG;
+    using Executor = ::Executor::BasicPriorityQueueExecutor<Clock>;
+    using Scheduler = ::Scheduler::BasicDeterministicScheduler<Executor, RNG, Clock>;
+    using Network = PartitionNetwork;
+};
+
+// A message between partitions. Messages arriving on the same tick are
+// delivered by sender, then in the order it sent them, so delivery does not
+// depend on which partition got to run first.
+struct Transit {
+    long long arrival;
+    int from;
+    uint64_t seq;
+    IO::Envelope envelope;
+
+    bool operator>(const Transit& other) const {
+        return std::tie(arrival, from, seq) > std::tie(other.arrival, other.from, other.seq);
+    }
+};
+
+// Where a node's sends go: each draws its delay from the node's own RNG and
+// lands in the outbox of the partition the destination lives in.
+class PartitionNetwork {
+private:
+    int node_;
+    std::shared_ptr<Clock::DeterministicClock> clock_;
+    std::shared_ptr<RNG::SplitMixRNG> rng_;
+    int max_delay_;
+    int base_latency_;
+    const std::vector<int>* partition_of_;
+    // The sending partition's outboxes, by destination partition
+    std::vector<std::vector<Transit>>* outbox_;
+    uint64_t sent_ = 0;
+public:
+    PartitionNetwork(int node, std::shared_ptr<Clock::DeterministicClock> clock,
+                     std::shared_ptr<RNG::SplitMixRNG> rng, int max_delay, int base_latency,
+                     const std::vector<int>* partition_of, std::vector<std::vector<Transit>>* outbox)
+        : node_(node),
+          clock_(std::move(clock)),
+          rng_(std::move(rng)),
+          max_delay_(max_delay),
+          base_latency_(base_latency),
+          partition_of_(partition_of),
+          outbox_(outbox) {}
+    void push_entry(IO::Envelope msg) {
+        long long arrival = clock_->now() + base_latency_ + rng_->draw(0, max_delay_);
+        int to = (*partition_of_)[msg.to];
+        (*outbox_)[to].push_back(Transit{arrival, node_, sent_++, std::move(msg)});
+    }
+    size_t messages_sent() const { return sent_; }
+};
+
+// How a ParallelSimulationContext spreads its work.
+struct ParallelOptions {
+    // Threads stepping partitions, the calling one included; 0: one per core
+    int threads = 1;
+    // Contiguous node ranges the cluster is cut into, each with its own
+    // clock, executor and message queue; 0: one per thread
+    int partitions = 0;
+};
+
+// A cluster simulated as conservative parallel discrete events. The nodes
+// are cut into partitions that each run their own events; they only meet
+// through messages, and a message sent on tick t is never delivered before
+// tick t + lookahead(). So every partition can run a whole lookahead window
+// on its own, on its own thread, and they swap messages at the window's end.
+//
+// Every node draws from its own RNG stream (RNG::SplitMixRNG seeded from
+// input.rng_seed and its id; decision bytes are not used), keeps its own message ids, and gets
+// its messages in (arrival, sender, send order) order. Nothing a node sees
+// depends on the other partitions' progress, so a run is the same, step for
+// step and hash for hash, whatever threads and partitions it is given: one
+// thread and one partition is the serial reference.
+//
+// Shares BasicSimulationContext's Topology but not its stream: the same
+// input gives a different (equally valid) run. Hosts, coalescing and
+// bandwidth-limited links couple nodes outside of messages and are refused.
+class ParallelSimulationContext {
+public:
+    using RaftNodeType = Node::BasicRaftNode<PartitionStack>;
+private:
+    struct Partition {
+        int first = 0, last = 0;
+        std::shared_ptr<Clock::DeterministicClock> clock;
+        std::shared_ptr<PartitionStack::Executor> executor;
+        std::priority_queue<Transit, std::vector<Transit>, std::greater<Transit>> incoming;
+        // By destination partition: outbox is written during a window, then
+        // swapped with sent, which the destinations drain during the next
+        std::vector<std::vector<Transit>> outbox;
+        std::vector<std::vector<Transit>> sent;
+        std::vector<int> ready_nodes;
+        std::unique_ptr<Memory::RunMemory> memory;
+        std::exception_ptr error;
+    };
+
+    FuzzInput input_;
+    int lookahead_ = 1;
+    std::vector<int> partition_of_;
+    std::vector<Partition> partitions_;
+    std::vector<std::shared_ptr<RNG::SplitMixRNG>> rngs_;
+    std::vector<std::shared_ptr<System::BasicSystem<PartitionStack>>> systems_;
+    std::vector<std::shared_ptr<PartitionNetwork>> networks_;
+    std::shared_ptr<Node::NodeTable> table_;
+    std::vector<std::shared_ptr<RaftNodeType>> raft_nodes_;
+    std::shared_ptr<Oracle::RaftOracle> oracle_;
+    int steps_ = 0;
+    size_t state_hash_ = 0;
+    size_t memory_budget_ = 0;
+    size_t peak_usage_ = 0;
+
+    // Ticks in the window being run
+    int window_ticks_ = 0;
+    std::ostream* log_ = nullptr;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<std::barrier<>> start_;
+    std::unique_ptr<std::barrier<>> end_;
+    std::atomic<bool> stop_{false};
+
+    void worker(int thread);
+    void run_partitions(int thread);
+    void run_window(int index);
+    void route(Partition& partition);
+public:
+    // Throws std::invalid_argument on a topology BasicSimulationContext
+    // would refuse, and on one this context cannot split (see above).
+    explicit ParallelSimulationContext(const FuzzInput& input, Topology topology = {}, ParallelOptions options = {});
+    ~ParallelSimulationContext();
+    ParallelSimulationContext(const ParallelSimulationContext&) = delete;
+    ParallelSimulationContext& operator=(const ParallelSimulationContext&) = delete;
+
+    bool done();
+    // Runs one lookahead window (at most the steps left) and returns the hash
+    // of the cluster state it left behind. Throws std::runtime_error on an
+    // oracle violation, which is checked at the end of each window.
+    size_t step();
+    int steps() const { return steps_; }
+    size_t state_hash() const { return state_hash_; }
+    // As BasicSimulationContext::proximity, checked at the end of each window
+    const Oracle::Proximity& proximity() const { return oracle_->proximity(); }
+    // Ticks a window spans: the shortest delay a message can have, and at
+    // least one tick (messages sent on a tick are delivered on a later one).
+    int lookahead() const { return lookahead_; }
+    int threads() const { return static_cast<int>(workers_.size()) + 1; }
+    int partitions() const { return static_cast<int>(partitions_.size()); }
+    const std::vector<std::shared_ptr<RaftNodeType>>& nodes() const { return raft_nodes_; }
+    const Node::NodeTable& table() const { return *table_; }
+    const FuzzInput& input() const { return input_; }
+    size_t tasks_run() const;
+    size_t messages_sent() const;
+
+    // As in BasicSimulationContext
+    void set_memory_budget(size_t bytes) { memory_budget_ = bytes; }
+    size_t memory_budget() const { return memory_budget_; }
+    Memory::Usage memory_usage() const;
+    bool within_memory_budget();
+    Memory::Report memory_report() const;
+};
+
+} // namespace Simulation
+
+#endif // _PARALLEL_HARNESS_H_
@@ -0,0 +1,113 @@
+#include "src/simulation/batch_runner.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+int usage(const char* name) {
+    std::cout << "Usage: " << name << " (--seeds=<first>-<last> | --inputs=<file>) [--threads=N]"
+              << " [--max-steps=N] [--out=<file>] [--format=csv|binary] [--logs=<dir>] [--memory-budget-mb=N]"
+              << std::endl;
+    std::cout << "  --seeds      default FuzzInputs with rng_seed first .. last (inclusive)" << std::endl;
+    std::cout << "  --inputs     one hex-encoded FuzzInput per line" << std::endl;
+    std::cout << "  --threads    worker threads (default: one per core)" << std::endl;
+    std::cout << "  --max-steps  step budget for --seeds runs (default 10000)" << std::endl;
+    std::cout << "  --out        summary file (default: CSV on stdout)" << std::endl;
+    std::cout << "  --logs       keep each run's log as <dir>/run_<index>.log" << std::endl;
+    std::cout << "  --memory-budget-mb  stop runs holding more than N MiB (default: unlimited)" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::optional<std::pair<uint32_t, uint32_t>> seeds;
+    std::string inputs_path, out_path, format = "csv";
+    int max_steps = Simulation::FuzzInput{}.max_steps;
+    Simulation::BatchOptions options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--seeds=", 0) == 0) {
+                std::string range = arg.substr(8);
+                size_t dash = range.find('-');
+                if (dash == std::string::npos) {
+                    return usage(argv[0]);
+                }
+                seeds = {std::stoul(range.substr(0, dash)), std::stoul(range.substr(dash + 1))};
+            } else if (arg.rfind("--inputs=", 0) == 0) {
+                inputs_path = arg.substr(9);
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                options.threads = std::stoi(arg.substr(10));
+            } else if (arg.rfind("--max-steps=", 0) == 0) {
+                max_steps = std::stoi(arg.substr(12));
+            } else if (arg.rfind("--out=", 0) == 0) {
+                out_path = arg.substr(6);
+            } else if (arg.rfind("--format=", 0) == 0) {
+                format = arg.substr(9);
+            } else if (arg.rfind("--logs=", 0) == 0) {
+                options.log_dir = arg.substr(7);
+            } else if (arg.rfind("--memory-budget-mb=", 0) == 0) {
+                Simulation::set_run_memory_budget(std::stoull(arg.substr(19)) << 20);
+            } else {
+                return usage(argv[0]);
+            }
+        }
+    } catch (const std::logic_error& e) {
+        std::cerr << e.what() << std::endl;
+        return usage(argv[0]);
+    }
+    if (seeds.has_value() == !inputs_path.empty() || (seeds && seeds->first > seeds->second) ||
+        (format != "csv" && format != "binary") || (format == "binary" && out_path.empty())) {
+        return usage(argv[0]);
+    }
+
+    std::vector<Simulation::FuzzInput> inputs;
+    if (!inputs_path.empty()) {
+        std::ifstream in(inputs_path);
+        if (!in) {
+            std::cerr << "Unable to open " << inputs_path << std::endl;
+            return 1;
+        }
+        try {
+            inputs = Simulation::read_inputs(in);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << inputs_path << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!out_path.empty()) {
+        file.open(out_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Unable to open " << out_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = out_path.empty() ? std::cout : file;
+    std::unique_ptr<Simulation::SummaryWriter> writer;
+    if (format == "binary") {
+        writer = std::make_unique<Simulation::BinarySummaryWriter>(out);
+    } else {
+        writer = std::make_unique<Simulation::CsvSummaryWriter>(out);
+    }
+
+    size_t count = seeds ? static_cast<size_t>(seeds->second - seeds->first) + 1 : inputs.size();
+    auto stats = Simulation::run_batch(count, [&](size_t index) {
+        return seeds ? Simulation::input_for_seed(seeds->first + index, max_steps) : inputs[index];
+    }, *writer, options);
+    out.flush();
+
+    std::cerr << "[Batch] " << stats.runs << " runs on " << stats.threads << " threads in " << stats.wall_ms / 1000
+              << " s (" << (stats.wall_ms > 0 ? stats.runs * 1000 / stats.wall_ms : 0) << " runs/s), "
+              << stats.violations << " violations" << std::endl;
+    return stats.violations > 0 ? 2 : 0;
+}
@@ -0,0 +1,70 @@
+#include "src/simulation/fork_server.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Branches one trunk run many times through the fork server and replays the
+// same branches from scratch, reporting the throughput of both.
+int main(int argc, char* argv[]) {
+    uint32_t seed = 400;
+    int branches = 200;
+    Simulation::CheckpointPolicy policy;
+    policy.step = 5000;
+
+    if (argc > 1) {
+        seed = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+        branches = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        policy.step = std::stoi(argv[3]);
+    }
+    if (argc > 4 && std::strcmp(argv[4], "--new-state") == 0) {
+        policy.on_new_state = true;
+    }
+
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    auto base_input = input.to_bytes();
+
+    Simulation::ForkServer server(base_input, policy);
+    auto fork_start = std::chrono::steady_clock::now();
+    if (!server.reach_checkpoint()) {
+        std::cout << "Trunk run ended before reaching the checkpoint" << std::endl;
+        return 1;
+    }
+    // The prefix is part of what forking pays, once
+    std::chrono::duration<double> fork_elapsed = std::chrono::steady_clock::now() - fork_start;
+    std::chrono::duration<double> replay_elapsed{0};
+
+    // Each branch is compared as soon as it ran: results carry a whole
+    // coverage map, too large to keep one per branch
+    int mismatches = 0;
+    for (int b = 0; b < branches; ++b) {
+        auto start = std::chrono::steady_clock::now();
+        auto forked = server.branch(b + 1);
+        auto forked_end = std::chrono::steady_clock::now();
+        auto replayed = Simulation::run_simulation(server.branch_input(b + 1));
+        fork_elapsed += forked_end - start;
+        replay_elapsed += std::chrono::steady_clock::now() - forked_end;
+        if (replayed.oracle_violation != forked.oracle_violation || replayed.coverage != forked.coverage) {
+            ++mismatches;
+        }
+    }
+
+    double fork_rate = branches / fork_elapsed.count();
+    double replay_rate = branches / replay_elapsed.count();
+    std::cout << "=== Fork Server ===" << std::endl;
+    std::cout << "Checkpoint step:   " << server.checkpoint_step() << " of " << input.max_steps << std::endl;
+    std::cout << "Branches:          " << branches << std::endl;
+    std::cout << "Forked exec/s:     " << fork_rate << std::endl;
+    std::cout << "Replayed exec/s:   " << replay_rate << std::endl;
+    std::cout << "Speedup:           " << fork_rate / replay_rate << "x" << std::endl;
+    std::cout << "Replay mismatches: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -1,4 +1,6 @@
 #include "src/simulation/simulation_harness.h"
+#include "src/simulation/parallel_harness.h"
+#include "src/coverage/edge_coverage.h"
 #include "src/rng/rng.h"
 #include "src/clock/clock.h"
 #include "src/executor/executor.h"
@@ -9,25 +11,16 @@
 #include "src/routing/router.h"
 #include "src/oracle/oracle.h"
 #include "src/node/state.h"
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <cctype>
+#include <type_traits>
 
 namespace Simulation {
 
-// RAII helper to suppress cout during simulation
-class SuppressOutput {
-    std::streambuf* original_cout_;
-    std::ostringstream null_stream_;
-public:
-    SuppressOutput() : original_cout_(std::cout.rdbuf()) {
-        std::cout.rdbuf(null_stream_.rdbuf());
-    }
-    ~SuppressOutput() {
-        std::cout.rdbuf(original_cout_);
-    }
-};
-
 std::string generate_violation_message(const std::string& exception_message, FuzzInput violation_input_) {
     std::string msg = "";
     msg+= "\n";
@@ -45,77 +38,278 @@ std::string generate_violation_message(const std::string& exception_message, Fuz
     msg+= "heartbeat_interval:   " + std::to_string(violation_input_.heartbeat_interval) + "\n";
     msg+= "max_network_delay:    " + std::to_string(violation_input_.max_network_delay) + "\n";
     msg+= "max_steps:            " + std::to_string(violation_input_.max_steps) + "\n";
+    msg+= "branch_step:          " + std::to_string(violation_input_.branch_step) + "\n";
+    msg+= "branch_seed:          " + std::to_string(violation_input_.branch_seed) + "\n";
+    msg+= "decision_bytes:       " + std::to_string(violation_input_.decisions.size()) + "\n";
     msg+= "\n";
     msg+= "=== Raw Input Bytes (hex) ===\n";
     return msg;
 }
 
-SimulationResult run_simulation(const std::vector<uint8_t>& fuzz_input) {
-    FuzzInput input = FuzzInput::from_bytes(fuzz_input.data(), fuzz_input.size());
+// "RPC not registered for id 12" -> "RPC not registered for id #"
+std::string mask_numbers(const std::string& message) {
+    std::string masked;
+    for (size_t i = 0; i < message.size(); ++i) {
+        if (std::isdigit(static_cast<unsigned char>(message[i]))) {
+            if (masked.empty() || masked.back() != '#') {
+                masked += '#';
+            }
+        } else {
+            masked += message[i];
+        }
+    }
+    return masked;
+}
 
-    SimulationResult result;
+namespace {
 
-    try {
-        // Suppress verbose debug output from simulation components
-        SuppressOutput suppress;
-        // Initialize core components with fuzz input parameters
-        auto rng = std::make_shared<RNG::UniformDistributionRange>(input.rng_seed);
-        auto clock = std::make_shared<Clock::DeterministicClock>();
-        auto executor = std::make_shared<Executor::PriorityQueueExecutor>(clock);
-
-        const int MAX_TASK_SCHEDULE_JITTER = 100;
-        auto scheduler = std::make_shared<Scheduler::DeterministicScheduler>(
-            executor, rng, clock, MAX_TASK_SCHEDULE_JITTER);
-        auto network = std::make_shared<IO::Network>(clock, rng, input.max_network_delay);
-        auto system = std::make_shared<System::System>(scheduler, clock, rng, network);
-
-        // Create nodes
-        std::vector<std::shared_ptr<Node::Node>> nodes;
-        std::vector<std::shared_ptr<Node::RaftNode>> raft_nodes;
-
-        for (int i = 0; i < input.nr_nodes; ++i) {
-            auto node = std::make_shared<Node::RaftNode>(
-                i, system, input.nr_nodes,
-                input.election_timeout_min,
-                input.election_timeout_max,
-                input.heartbeat_interval);
-            nodes.push_back(node);
-            raft_nodes.push_back(node);
-
-            auto main_loop = node->main_loop();
-            system->request_work([main_loop]() { main_loop.h_.resume(); });
+std::atomic<size_t> default_memory_budget{0};
+
+} // namespace
+
+void set_run_memory_budget(size_t bytes) {
+    default_memory_budget.store(bytes, std::memory_order_relaxed);
+}
+
+size_t run_memory_budget() {
+    return default_memory_budget.load(std::memory_order_relaxed);
+}
+
+template<typename Stack>
+BasicSimulationContext<Stack>::BasicSimulationContext(const FuzzInput& input, Trace::EventSink* sink,
+                                                      Topology topology)
+    : input_(input),
+      sink_(sink),
+      memory_(std::make_unique<Memory::RunMemory>()),
+      memory_budget_(run_memory_budget()) {
+    Memory::ScopedRun run(memory_.get());
+    int nr_nodes = topology.nr_nodes > 0 ? topology.nr_nodes : input_.nr_nodes;
+    int group_size = topology.group_size > 0 ? topology.group_size : nr_nodes;
+    if (nr_nodes > Topology::MAX_NODES || group_size < FuzzInput::MIN_NODES || nr_nodes % group_size != 0) {
+        throw std::invalid_argument("Invalid topology: " + std::to_string(nr_nodes) + " nodes in groups of " +
+                                    std::to_string(group_size));
+    }
+    if ((topology.hosts > 0 && topology.hosts < group_size) || (topology.coalesce_heartbeats && topology.hosts <= 0)) {
+        throw std::invalid_argument("Invalid topology: groups of " + std::to_string(group_size) + " on " +
+                                    std::to_string(topology.hosts) + " hosts");
+    }
+
+    // Initialize core components with fuzz input parameters
+    // Decisions come from the input's tail first, then from rng_seed
+    rng_ = std::make_shared<RNG::ByteStreamRNG>(input_.decisions, input_.rng_seed);
+    clock_ = std::make_shared<Clock::DeterministicClock>();
+    executor_ = std::make_shared<ExecutorType>(clock_);
+
+    std::shared_ptr<typename Stack::RNG> rng = rng_;
+    if constexpr (std::is_same_v<typename Stack::RNG, RNG::RNG>) {
+        if (sink_) {
+            rng = std::make_shared<Trace::TracingRNG>(rng_, clock_, sink_);
+        }
+    } else if (sink_) {
+        throw std::invalid_argument("Tracing needs a stack with a virtual RNG");
+    }
+
+    const int MAX_TASK_SCHEDULE_JITTER = 100;
+    auto scheduler = std::make_shared<
+        Scheduler::BasicDeterministicScheduler<typename Stack::Executor, typename Stack::RNG, typename Stack::Clock>>(
+        executor_, rng, clock_, MAX_TASK_SCHEDULE_JITTER);
+    network_ = std::make_shared<NetworkType>(clock_, rng, input_.max_network_delay);
+    system_ = std::make_shared<System::BasicSystem<Stack>>(scheduler, clock_, rng, network_);
+    executor_->set_event_sink(sink_);
+    network_->set_event_sink(sink_);
+    system_->set_event_sink(sink_);
+
+    std::vector<int> host_of;
+    if (topology.hosts > 0) {
+        host_of.reserve(nr_nodes);
+        for (int i = 0; i < nr_nodes; ++i) {
+            host_of.push_back((i / group_size + i % group_size) % topology.hosts);
         }
+    }
+    network_->set_link_model(topology.links, host_of);
+    if (topology.coalesce_heartbeats) {
+        int window = topology.coalesce_window > 0 ? topology.coalesce_window : input_.heartbeat_interval;
+        coalescer_ = std::make_shared<CoalescerType>(network_, clock_, executor_, host_of, window);
+        network_->set_outbox(coalescer_.get());
+    }
+
+    // Create nodes
+    std::vector<std::shared_ptr<Node::BasicNode<Stack>>> nodes;
+    table_ = std::make_shared<Node::NodeTable>(nr_nodes);
+    nodes.reserve(nr_nodes);
+    raft_nodes_.reserve(nr_nodes);
+
+    for (int i = 0; i < nr_nodes; ++i) {
+        auto node = std::make_shared<RaftNodeType>(
+            i, system_, group_size,
+            input_.election_timeout_min,
+            input_.election_timeout_max,
+            input_.heartbeat_interval,
+            table_, i - i % group_size);
+        nodes.push_back(node);
+        raft_nodes_.push_back(node);
 
-        // Set up routing and oracle
-        auto router = std::make_shared<Routing::Router>(nodes, network, system);
-        auto oracle = std::make_shared<Oracle::RaftOracle>(nodes);
+        auto main_loop = node->main_loop();
+        system_->request_work_for(i, [main_loop]() { main_loop.h_.resume(); });
+    }
 
-        // Run simulation loop
-        int steps = 0;
-        while ((executor->has_work() || network->has_messages()) && steps < input.max_steps) {
-            clock->tick();
-            router->route();
-            executor->run_until_blocked();
+    // Set up routing and oracle
+    router_ = std::make_shared<Routing::BasicRouter<Stack>>(nodes, network_, system_);
+    oracle_ = std::make_shared<Oracle::RaftOracle>(nodes);
+    oracle_->set_track_proximity(nr_nodes <= FuzzInput::MAX_NODES);
+}
 
-            // Capture state after each step
-            auto cluster_state = State::ClusterState::capture(raft_nodes);
-            result.visited_state_hashes.insert(cluster_state.hash());
+template<typename Stack>
+BasicSimulationContext<Stack>::~BasicSimulationContext() {
+    // Nothing may resume the frames once they are gone
+    system_->suspended_rpcs.clear();
+    system_->responses.clear();
+    memory_->destroy_frames();
+}
 
-            // Check oracle invariants
-            oracle->enforce_invariants();
+template<typename Stack>
+bool BasicSimulationContext<Stack>::done() {
+    return !(executor_->has_work() || network_->has_messages()) || steps_ >= input_.max_steps;
+}
 
-            ++steps;
+template<typename Stack>
+size_t BasicSimulationContext<Stack>::step() {
+    if (input_.branch_step != 0 && steps_ == input_.branch_step) {
+        rng_->reseed(input_.branch_seed);
+    }
+    Memory::ScopedRun run(memory_.get());
+    clock_->tick();
+    router_->route();
+    executor_->run_until_blocked();
+
+    // Capture state after each step
+    if (raft_nodes_.size() <= static_cast<size_t>(FuzzInput::MAX_NODES)) {
+        state_hash_ = State::ClusterState::capture(raft_nodes_).hash();
+    } else {
+        state_hash_ = table_->digest();
+    }
+    ++steps_;
+    if (sink_) {
+        reported_.resize(raft_nodes_.size(), {-1, -1});
+        for (int row : table_->changed()) {
+            std::pair<int, int> now{table_->role(row), table_->term(row)};
+            if (reported_[row] != now) {
+                reported_[row] = now;
+                sink_->on_event(Trace::Event{Trace::EventKind::NodeState, clock_->now(), row, now.first, now.second});
+            }
         }
+        sink_->on_event(Trace::Event{Trace::EventKind::Step, clock_->now(), steps_, static_cast<int64_t>(state_hash_),
+                                     static_cast<int64_t>(executor_->pending())});
+    }
+
+    // Check oracle invariants
+    oracle_->enforce_invariants();
+    table_->clear_changed();
+
+    return state_hash_;
+}
+
+template<typename Stack>
+void BasicSimulationContext<Stack>::reseed(uint32_t seed) {
+    if (steps_ == 0) {
+        // branch_step 0 reads as "no branch": the input could not reproduce this run
+        throw std::runtime_error("A run can only be reseeded after its first step");
+    }
+    rng_->reseed(seed);
+    // Keep input() a faithful reproducer of this run
+    input_.branch_step = steps_;
+    input_.branch_seed = seed;
+}
+
+template<typename Stack>
+Memory::Usage BasicSimulationContext<Stack>::memory_usage() const {
+    Memory::Usage usage;
+    usage.frames = memory_->frame_bytes();
+    usage.executor = executor_->pending() * sizeof(Executor::PendingTask);
+    usage.network = network_->in_flight() * (sizeof(IO::NetworkItem) + sizeof(IO::Envelope));
+    usage.rpc = system_->suspended_rpcs.size() * (sizeof(int) + sizeof(std::coroutine_handle<>)) +
+                system_->responses.size() * (sizeof(int) + sizeof(std::optional<IO::Envelope>));
+    return usage;
+}
 
+template<typename Stack>
+bool BasicSimulationContext<Stack>::within_memory_budget() {
+    if (memory_budget_ == 0) {
+        return true;
+    }
+    size_t total = memory_usage().total();
+    peak_usage_ = std::max(peak_usage_, total);
+    return total <= memory_budget_;
+}
+
+template<typename Stack>
+Memory::Report BasicSimulationContext<Stack>::memory_report() const {
+    Memory::Report report;
+    report.usage = memory_usage();
+    report.peak = std::max({peak_usage_, report.usage.total(), memory_->peak_frame_bytes()});
+    memory_->count_frames(report);
+    report.pending_rpcs = system_->suspended_rpcs.size();
+    report.unclaimed_responses = system_->responses.size();
+    return report;
+}
+
+template<typename Context>
+bool advance(Context& ctx, SimulationResult& result) {
+    if (result.oracle_violation || result.memory_exceeded || ctx.done()) {
+        result.memory = ctx.memory_report();
+        return false;
+    }
+    try {
+        // Edges the step takes on this thread, in builds with edge coverage
+        Coverage::ScopedEdgeFeedback edges(&result.coverage);
+        result.coverage.record(ctx.step());
+    } catch (const Oracle::InvariantViolation& e) {
+        result.oracle_violation = true;
+        result.violated_invariant = e.invariant();
+        result.error_message = generate_violation_message(e.what(), ctx.input());
     } catch (const std::runtime_error& e) {
         result.oracle_violation = true;
-        result.error_message = generate_violation_message(e.what(),input);
+        result.violated_invariant = mask_numbers(e.what());
+        result.error_message = generate_violation_message(e.what(), ctx.input());
     } catch (const std::exception& e) {
         result.oracle_violation = true;
+        result.violated_invariant = mask_numbers(e.what());
         result.error_message = std::string("Unexpected error: ") + e.what();
     }
+    result.steps = ctx.steps();
+    result.proximity = ctx.proximity();
+    if (!result.oracle_violation && !ctx.within_memory_budget()) {
+        result.memory_exceeded = true;
+        result.memory = ctx.memory_report();
+        result.error_message = "Memory budget of " + std::to_string(ctx.memory_budget()) + " bytes exceeded at step " +
+                               std::to_string(result.steps) + "\n" + result.memory.describe();
+    }
+    if (result.oracle_violation) {
+        result.memory = ctx.memory_report();
+    }
+    return !result.oracle_violation && !result.memory_exceeded;
+}
+
+SimulationResult run_simulation(const std::vector<uint8_t>& fuzz_input) {
+    FuzzInput input = FuzzInput::from_bytes(fuzz_input.data(), fuzz_input.size());
+
+    SimulationResult result;
+
+    // Suppress verbose debug output from simulation components
+    SuppressOutput suppress;
+    StaticSimulationContext ctx(input);
+
+    // Run simulation loop
+    while (advance(ctx, result)) {}
+    result.coverage.classify();
 
     return result;
 }
 
+template class BasicSimulationContext<System::VirtualStack>;
+template class BasicSimulationContext<System::StaticStack>;
+template bool advance(SimulationContext& ctx, SimulationResult& result);
+template bool advance(StaticSimulationContext& ctx, SimulationResult& result);
+template bool advance(ParallelSimulationContext& ctx, SimulationResult& result);
+
 } // namespace Simulation
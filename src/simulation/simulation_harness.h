@@ -1,18 +1,184 @@
 #ifndef _SIMULATION_HARNESS_H_
 #define _SIMULATION_HARNESS_H_
 
-#include <unordered_set>
 #include <string>
+#include <memory>
+#include <vector>
+#include "src/coverage/coverage_map.h"
 #include "src/simulation/fuzz_input.h"
+#include "src/log/log.h"
+#include "src/memory/memory.h"
+#include "src/rng/rng.h"
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/io/coalescer.h"
+#include "src/io/network.h"
+#include "src/node/node.h"
+#include "src/node/node_table.h"
+#include "src/routing/router.h"
+#include "src/oracle/oracle.h"
+#include "src/trace/event.h"
 
 namespace Simulation {
 
 struct SimulationResult {
-    std::unordered_set<size_t> visited_state_hashes;
+    // Cluster states visited, one hit per step, and in builds with edge
+    // coverage (see Coverage::edge_count) the code edges taken while stepping.
+    // Raw hit counts while the run is in progress, bucketed
+    // (CoverageMap::classify) once it is over.
+    Coverage::CoverageMap coverage;
     bool oracle_violation = false;
     std::string error_message;
+    // Which invariant broke: the oracle's name for it, or the error text with
+    // ids and numbers masked for other failures.
+    std::string violated_invariant;
+    // Steps executed, including the one that violated an invariant.
+    int steps = 0;
+    // The run went over its memory budget and was stopped (not an invariant
+    // violation: the report is in error_message and memory).
+    bool memory_exceeded = false;
+    // What the run held when it ended.
+    Memory::Report memory;
+    // How close the run came to two leaders in a term (see
+    // Oracle::Proximity); zero for clusters larger than the fuzzer's.
+    Oracle::Proximity proximity;
 };
 
+// Budget, in bytes, of the runs run_simulation and the batch runner start
+// from now on (0, the default: unlimited). Process wide, so runners that
+// take nothing but the input bytes can be bounded too.
+void set_run_memory_budget(size_t bytes);
+size_t run_memory_budget();
+
+// RAII helper to silence the simulation components' logging on this thread
+class SuppressOutput {
+    Log::ScopedSink sink_;
+public:
+    SuppressOutput() : sink_(Log::null_stream()) {}
+};
+
+// Cluster layout beyond what a FuzzInput encodes, for simulating fleets of
+// thousands of nodes. The default is the single Raft group of input.nr_nodes
+// nodes the fuzzer explores.
+struct Topology {
+    // 0: input.nr_nodes
+    int nr_nodes = 0;
+    // Nodes per Raft group (groups never talk to each other); 0: one group
+    int group_size = 0;
+    // Machines the nodes run on, multi-Raft style: replica k of group g lives
+    // on host (g + k) % hosts, so no host holds two replicas of a group.
+    // 0: no hosts.
+    int hosts = 0;
+    // Batch the heartbeats each host sends to each other host (needs hosts)
+    bool coalesce_heartbeats = false;
+    // How long a host holds heartbeats before flushing; 0: heartbeat_interval
+    int coalesce_window = 0;
+    // Bandwidth, latency and queue bounds of the network's links. With
+    // hosts, links join hosts, so co-located replicas share them.
+    IO::LinkModel links{};
+
+    static constexpr int MAX_NODES = 100000;
+};
+
+// One simulated cluster built from a FuzzInput. The components live as long as
+// the context does, so a caller can stop between steps (to checkpoint, fork,
+// inspect...) and carry on later. Stack (see System::VirtualStack and
+// System::StaticStack) picks how the components are wired: both run the exact
+// same simulation, the static one without virtual calls but also without
+// tracing of RNG draws.
+template<typename Stack>
+class BasicSimulationContext {
+public:
+    using ExecutorType = Executor::BasicPriorityQueueExecutor<typename Stack::Clock>;
+    using NetworkType = typename Stack::Network;
+    using CoalescerType = IO::BasicHeartbeatCoalescer<NetworkType>;
+    using RaftNodeType = Node::BasicRaftNode<Stack>;
+private:
+    FuzzInput input_;
+    std::shared_ptr<RNG::ByteStreamRNG> rng_;
+    std::shared_ptr<Clock::DeterministicClock> clock_;
+    std::shared_ptr<ExecutorType> executor_;
+    std::shared_ptr<NetworkType> network_;
+    std::shared_ptr<CoalescerType> coalescer_;
+    std::shared_ptr<System::BasicSystem<Stack>> system_;
+    std::shared_ptr<Node::NodeTable> table_;
+    std::vector<std::shared_ptr<RaftNodeType>> raft_nodes_;
+    std::shared_ptr<Routing::BasicRouter<Stack>> router_;
+    std::shared_ptr<Oracle::RaftOracle> oracle_;
+    Trace::EventSink* sink_;
+    // (role, term) last reported per node, kept only when tracing
+    std::vector<std::pair<int, int>> reported_;
+    int steps_ = 0;
+    size_t state_hash_ = 0;
+    // Frames point back at it, so it must not move with the context
+    std::unique_ptr<Memory::RunMemory> memory_;
+    size_t memory_budget_ = 0;
+    size_t peak_usage_ = 0;
+public:
+    // With a sink, every task pop, delivery, RNG draw and step end of the run
+    // is reported to it. Throws std::invalid_argument if topology does not
+    // split into groups of at least FuzzInput::MIN_NODES nodes, or places
+    // them on fewer hosts than a group has replicas, if its link model has
+    // negative parameters, and if given a sink on a
+    // stack whose RNG cannot be wrapped for tracing.
+    explicit BasicSimulationContext(const FuzzInput& input, Trace::EventSink* sink = nullptr, Topology topology = {});
+    // Destroys the coroutine frames still suspended (every node's main loop
+    // at least), which would otherwise outlive the run.
+    ~BasicSimulationContext();
+    bool done();
+    // Runs one tick and returns the hash of the cluster state it left behind.
+    // Throws std::runtime_error on an oracle violation.
+    size_t step();
+    // Replaces the entropy stream from here on; used to branch continuations.
+    // Throws std::runtime_error before the first step, which an input cannot
+    // branch at.
+    void reseed(uint32_t seed);
+    int steps() const { return steps_; }
+    // Hash of the cluster state after the last step. Clusters the fuzzer
+    // explores hash State::ClusterState; larger ones use the node table's
+    // digest, which is kept up to date incrementally.
+    size_t state_hash() const { return state_hash_; }
+    // How close the run came to two leaders in a term so far; tracked only
+    // for clusters the fuzzer explores (all zero for larger ones).
+    const Oracle::Proximity& proximity() const { return oracle_->proximity(); }
+    const std::vector<std::shared_ptr<RaftNodeType>>& nodes() const { return raft_nodes_; }
+    const Node::NodeTable& table() const { return *table_; }
+    const NetworkType& network() const { return *network_; }
+    const ExecutorType& executor() const { return *executor_; }
+    // nullptr unless the topology coalesces heartbeats
+    const CoalescerType* coalescer() const { return coalescer_.get(); }
+    const FuzzInput& input() const { return input_; }
+
+    // Bytes the run may hold (see memory_usage) before advance stops it;
+    // 0: unlimited. Starts at run_memory_budget().
+    void set_memory_budget(size_t bytes) { memory_budget_ = bytes; }
+    size_t memory_budget() const { return memory_budget_; }
+    // Coroutine frames exactly; executor, network and RPC bookkeeping as
+    // their queued entries, without the heap those point to.
+    Memory::Usage memory_usage() const;
+    // Checks usage against the budget, tracking the peak; false if over.
+    bool within_memory_budget();
+    Memory::Report memory_report() const;
+};
+
+// Everything behind interfaces: what tests, mocks and tracing use.
+using SimulationContext = BasicSimulationContext<System::VirtualStack>;
+// Devirtualized: what fuzzing runs use.
+using StaticSimulationContext = BasicSimulationContext<System::StaticStack>;
+
+// Both defined in simulation_harness.cc
+extern template class BasicSimulationContext<System::VirtualStack>;
+extern template class BasicSimulationContext<System::StaticStack>;
+
+// Executes one guarded step of ctx, recording coverage and violations into result.
+// The coverage is left unclassified, so a run can be continued.
+// Returns false once the simulation is over (no work, step budget spent,
+// violation, or memory budget exceeded); result.memory is then filled in.
+// Context: a BasicSimulationContext or a ParallelSimulationContext.
+template<typename Context>
+bool advance(Context& ctx, SimulationResult& result);
+
+// Runs input to the end on the static stack.
 SimulationResult run_simulation(const std::vector<uint8_t>& input);
 
 } // namespace Simulation
@@ -0,0 +1,39 @@
+#ifndef _STACK_H_
+#define _STACK_H_
+
+#include "src/clock/clock.h"
+#include "src/executor/executor.h"
+#include "src/io/network.h"
+#include "src/rng/rng.h"
+#include "src/scheduler/scheduler.h"
+
+namespace System {
+
+// A stack picks, at compile time, the component types the simulation layers
+// hold on to: System the scheduler, clock, RNG and network, the scheduler the
+// executor, RNG and clock, the network the clock and RNG.
+
+// Everything behind its abstract interface, so any component can be swapped
+// for a mock. Tests, tracing and the tools built on them use this stack.
+struct VirtualStack {
+    using Clock = ::Clock::Clock;
+    using RNG = ::RNG::RNG;
+    using Executor = ::Executor::Executor;
+    using Scheduler = ::Scheduler::Scheduler;
+    using Network = ::IO::Network;
+};
+
+// The concrete components the harness builds, named directly. They are all
+// final, so the compiler resolves (and can inline) every clock read, RNG
+// draw, task push and schedule call. The fuzzing hot path runs on this stack.
+struct StaticStack {
+    using Clock = ::Clock::DeterministicClock;
+    using RNG = ::RNG::ByteStreamRNG;
+    using Executor = ::Executor::BasicPriorityQueueExecutor<Clock>;
+    using Scheduler = ::Scheduler::BasicDeterministicScheduler<Executor, RNG, Clock>;
+    using Network = ::IO::BasicNetwork<Clock, RNG>;
+};
+
+} // namespace System
+
+#endif // _STACK_H_
@@ -6,28 +6,41 @@
 #include "src/executor/executor.h"
 #include "src/io/messages.h"
 #include "src/io/network.h"
+#include "src/system/stack.h"
+#include "src/trace/event.h"
 #include "unordered_map"
 #include <coroutine>
 #include <memory>
 #include <iostream>
+#include <optional>
 
 
 namespace System {
 
-class System {
+// What nodes see of the simulation: scheduling, time, randomness and RPCs.
+// Stack (see stack.h) selects the component types it holds.
+template<typename Stack>
+class BasicSystem {
 public:
-    std::shared_ptr<Scheduler::Scheduler> scheduler_;
-    std::shared_ptr<Clock::Clock> clock_;
-    std::shared_ptr<RNG::RNG> rng_;
+    using SchedulerType = typename Stack::Scheduler;
+    using ClockType = typename Stack::Clock;
+    using RNGType = typename Stack::RNG;
+    using NetworkType = typename Stack::Network;
+
+    std::shared_ptr<SchedulerType> scheduler_;
+    std::shared_ptr<ClockType> clock_;
+    std::shared_ptr<RNGType> rng_;
     int message_id_;
-    std::shared_ptr<IO::Network> network_;
+    std::shared_ptr<NetworkType> network_;
     std::unordered_map<int, std::coroutine_handle<>> suspended_rpcs;
-    std::unordered_map<int, IO::Envelope> responses;
-    System(
-        std::shared_ptr<Scheduler::Scheduler> scheduler,
-        std::shared_ptr<Clock::Clock> clock,
-        std::shared_ptr<RNG::RNG> rng,
-        std::shared_ptr<IO::Network> network)
+    // Empty for an RPC that failed
+    std::unordered_map<int, std::optional<IO::Envelope>> responses;
+    Trace::EventSink* sink_ = nullptr;
+    BasicSystem(
+        std::shared_ptr<SchedulerType> scheduler,
+        std::shared_ptr<ClockType> clock,
+        std::shared_ptr<RNGType> rng,
+        std::shared_ptr<NetworkType> network)
         : scheduler_(std::move(scheduler)),
           clock_(std::move(clock)),
           rng_(rng),
@@ -36,17 +49,26 @@ public:
     void request_work(std::function<void()> task) {
         scheduler_->schedule_task(task);
     }
+    // Work node `node` starts outside of its own tasks (its main loop, message
+    // dispatch); whatever that work schedules belongs to the node as well.
+    void request_work_for(int node, std::function<void()> task) {
+        scheduler_->schedule_task_for(node, task);
+    }
+    // Reports the start and end of every RPC to sink (nullptr to stop).
+    void set_event_sink(Trace::EventSink* sink) { sink_ = sink; }
     void send_message(IO::Envelope msg) {
         network_->push_entry(msg);
     }
     int random_range(int lo, int hi) {return rng_->draw(lo, hi);}
     long long int get_time() {return clock_->now();}
-    int register_pending_rpc(std::coroutine_handle<> h, int from, int to, IO::MessageName name, IO::Message msg) {
+    int register_pending_rpc(std::coroutine_handle<> h, int from, int to, IO::Message msg) {
         int id = message_id_++;
         suspended_rpcs[id] = h;
+        if (sink_) {
+            sink_->on_event(Trace::Event{Trace::EventKind::RpcStart, clock_->now(), id, from, to});
+        }
         network_->push_entry(IO::Envelope{
             id,
-            name,
             from,
             to,
             msg
@@ -58,74 +80,91 @@ public:
             throw std::runtime_error("RPC not registered for id " + std::to_string(message_id));
         }
         responses[message_id] = response;
+        if (sink_) {
+            sink_->on_event(Trace::Event{Trace::EventKind::RpcEnd, clock_->now(), message_id, response.to, response.from});
+        }
         auto waiter = suspended_rpcs[message_id];
+        suspended_rpcs.erase(message_id);
         scheduler_->schedule_task([waiter](){waiter.resume();});
     }
-    IO::Envelope get_response(int message_id) {
-        if (!responses.count(message_id)) {
-            throw std::runtime_error("Response not registered for id " + std::to_string(message_id));
+    // Ends caller's RPC message_id without a response: the network lost its
+    // request or its response. The caller resumes with no response; an RPC
+    // already over is left alone.
+    void fail_rpc(int message_id, int caller) {
+        auto it = suspended_rpcs.find(message_id);
+        if (it == suspended_rpcs.end()) {
+            return;
         }
+        responses[message_id] = std::nullopt;
+        if (sink_) {
+            sink_->on_event(Trace::Event{Trace::EventKind::RpcEnd, clock_->now(), message_id, caller, -1});
+        }
+        auto waiter = it->second;
+        suspended_rpcs.erase(it);
+        scheduler_->schedule_task([waiter](){waiter.resume();});
+    }
+    std::optional<IO::Envelope> get_response(int message_id) {
         auto result_it = responses.find(message_id);
-        auto result = *result_it;
+        if (result_it == responses.end()) {
+            throw std::runtime_error("Response not registered for id " + std::to_string(message_id));
+        }
+        std::optional<IO::Envelope> result = std::move(result_it->second);
         responses.erase(result_it);
-        return result.second;
+        return result;
     }
-    class SleepRequest;
-    SleepRequest sleep(int delay);
-    class RPC;
-    RPC rpc(int from, int to, IO::MessageName rpc_name, IO::Message msg);
-};
-
-class System::SleepRequest {
-private:
-    int delay_;
-    std::shared_ptr<Scheduler::Scheduler> sched_;
-public:
-    SleepRequest(System& sys, int delay) : delay_(delay), sched_(sys.scheduler_) {}
-    bool await_ready() {return false;}
-    void await_suspend(std::coroutine_handle<> h) const {
-        auto resumer_lambda = [h]() {
-            h.resume();
-        };
-        sched_->schedule_task_with_delay(std::move(resumer_lambda), delay_);
+    class SleepRequest {
+    private:
+        int delay_;
+        std::shared_ptr<SchedulerType> sched_;
+    public:
+        SleepRequest(BasicSystem& sys, int delay) : delay_(delay), sched_(sys.scheduler_) {}
+        bool await_ready() {return false;}
+        void await_suspend(std::coroutine_handle<> h) const {
+            auto resumer_lambda = [h]() {
+                h.resume();
+            };
+            sched_->schedule_task_with_delay(std::move(resumer_lambda), delay_);
+        }
+        void await_resume() const noexcept {}
+    };
+    SleepRequest sleep(int delay) {
+        return SleepRequest(*this, delay);
     }
-    void await_resume() const noexcept {}
-};
 
-inline System::SleepRequest System::sleep(int delay) {
-    return SleepRequest(*this, delay);
-}
-
-class System::RPC {
-private:
-    IO::Envelope response_;
-    System* sys_;
-    int message_id_, from_, to_;
-    IO::MessageName msg_name_;
-    IO::Message request_;
-public:
-    RPC(System& sys, int from, int to, IO::MessageName rpc_name, IO::Message msg)
-          : sys_(&sys),
-            message_id_(-1),
-            from_(from),
-            to_(to),
-            msg_name_(rpc_name),
-            request_(msg) {}
-    bool await_ready() {return false;}
-    void await_suspend(std::coroutine_handle<> caller_handle) {
-        message_id_ =  sys_->register_pending_rpc(caller_handle, from_, to_, msg_name_, request_);
-    }
-    IO::Envelope await_resume() {
-        if (message_id_ == -1) {
-            throw std::runtime_error("Expected message id to be set.");
+    class RPC {
+    private:
+        IO::Envelope response_;
+        BasicSystem* sys_;
+        int message_id_, from_, to_;
+        IO::Message request_;
+    public:
+        RPC(BasicSystem& sys, int from, int to, IO::Message msg)
+              : sys_(&sys),
+                message_id_(-1),
+                from_(from),
+                to_(to),
+                request_(std::move(msg)) {}
+        bool await_ready() {return false;}
+        void await_suspend(std::coroutine_handle<> caller_handle) {
+            message_id_ =  sys_->register_pending_rpc(caller_handle, from_, to_, request_);
+        }
+        // Empty if the RPC failed
+        std::optional<IO::Envelope> await_resume() {
+            if (message_id_ == -1) {
+                throw std::runtime_error("Expected message id to be set.");
+            }
+            return sys_->get_response(message_id_);
         }
-        return sys_->get_response(message_id_);
+    };
+    // Only requests open an RPC; the message type is the request's
+    template<typename Request>
+        requires (Request::KIND == IO::MessageKind::Request)
+    RPC rpc(int from, int to, Request request) {
+        return RPC(*this, from, to, std::move(request));
     }
 };
 
-inline System::RPC System::rpc(int from, int to, IO::MessageName rpc_name, IO::Message msg) {
-    return System::RPC(*this, from, to, rpc_name, std::move(msg));
-}
+using System = BasicSystem<VirtualStack>;
 
 } // namespace System
 #endif // _SYSTEM_H_
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "src/trace/determinism.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/trace/event.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace Trace {
+
+namespace {
+
+class FingerprintSink : public EventSink {
+public:
+    RollingHash hash;
+    RunFingerprint fingerprint;
+
+    void on_event(const Event& event) override {
+        hash.update(event);
+        ++fingerprint.events;
+        if (event.kind == EventKind::Step) {
+            fingerprint.step_hashes.push_back(hash.value());
+        }
+    }
+};
+
+} // namespace
+
+RunFingerprint fingerprint(const std::vector<uint8_t>& input) {
+    FingerprintSink sink;
+    Simulation::SimulationResult result;
+    {
+        Simulation::SuppressOutput suppress;
+        Simulation::SimulationContext ctx(Simulation::FuzzInput::from_bytes(input.data(), input.size()), &sink);
+        while (Simulation::advance(ctx, result)) {}
+    }
+    sink.fingerprint.final_hash = sink.hash.value();
+    return std::move(sink.fingerprint);
+}
+
+RunFingerprint static_fingerprint(const std::vector<uint8_t>& input) {
+    RunFingerprint fingerprint;
+    RollingHash hash;
+    Simulation::SimulationResult result;
+    Simulation::SuppressOutput suppress;
+    Simulation::StaticSimulationContext ctx(Simulation::FuzzInput::from_bytes(input.data(), input.size()));
+    // A step that ends the run (an oracle violation) still counts, as it
+    // does on the virtual stack
+    for (bool running = true; running;) {
+        running = Simulation::advance(ctx, result);
+        if (ctx.steps() > static_cast<int>(fingerprint.step_hashes.size())) {
+            hash.update(Event{EventKind::Step, 0, ctx.steps(), static_cast<int64_t>(ctx.state_hash()),
+                              static_cast<int64_t>(ctx.executor().pending() << 32 | ctx.network().in_flight())});
+            fingerprint.step_hashes.push_back(hash.value());
+            ++fingerprint.events;
+        }
+    }
+    fingerprint.final_hash = hash.value();
+    return fingerprint;
+}
+
+std::optional<int> first_differing_step(const RunFingerprint& expected, const RunFingerprint& actual) {
+    const auto& a = expected.step_hashes;
+    const auto& b = actual.step_hashes;
+    auto [ita, itb] = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+    if (ita != a.end() || itb != b.end()) {
+        return static_cast<int>(ita - a.begin()) + 1;
+    }
+    if (expected.final_hash != actual.final_hash) {
+        // Same steps, different tail after the last step
+        return static_cast<int>(a.size()) + 1;
+    }
+    return std::nullopt;
+}
+
+std::string describe(const DeterminismReport& report) {
+    std::string msg = "";
+    msg+= "=== Determinism Check ===\n";
+    msg+= "runs:   " + std::to_string(report.runs) + " on each of the virtual and static stacks\n";
+    msg+= "steps:  " + std::to_string(report.steps) + "\n";
+    msg+= "events: " + std::to_string(report.events) + "\n";
+    msg+= "hash:   " + std::to_string(report.hash) + "\n";
+    if (report.deterministic()) {
+        msg+= "result: PASSED (all runs identical)\n";
+        return msg;
+    }
+    msg+= "result: FAILED\n";
+    msg+= "run " + std::to_string(*report.divergent_run) + " on the " + report.divergent_stack + " stack first differs from run 0 at step " +
+           std::to_string(*report.divergent_step) + " (step hash " + std::to_string(report.expected_step_hash) +
+           " vs " + std::to_string(report.actual_step_hash) + ")\n";
+    return msg;
+}
+
+DeterminismReport check_determinism(const std::vector<uint8_t>& input, int runs, int threads) {
+    if (runs <= 0 || threads <= 0) {
+        throw std::invalid_argument("Determinism check needs a positive number of runs and threads");
+    }
+    RunFingerprint reference = fingerprint(input);
+    RunFingerprint static_reference = static_fingerprint(input);
+
+    // Each run is independent, so workers just claim run indices. The earliest
+    // divergent run is the one reported, whatever order the threads finish in.
+    std::atomic<int> next_run{1};
+    std::atomic<int> first_divergent{runs};
+    std::mutex divergence_mutex;
+    RunFingerprint divergent;
+    bool divergent_static = false;
+    auto worker = [&]() {
+        for (int run = next_run++; run < runs && run < first_divergent.load(); run = next_run++) {
+            bool on_static = false;
+            RunFingerprint actual = fingerprint(input);
+            if (!first_differing_step(reference, actual)) {
+                on_static = true;
+                actual = static_fingerprint(input);
+                if (!first_differing_step(static_reference, actual)) {
+                    continue;
+                }
+            }
+            std::lock_guard<std::mutex> lock(divergence_mutex);
+            if (run < first_divergent.load()) {
+                first_divergent = run;
+                divergent = std::move(actual);
+                divergent_static = on_static;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min(threads, runs); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    DeterminismReport report;
+    report.runs = runs;
+    report.steps = static_cast<int>(reference.step_hashes.size());
+    report.events = reference.events;
+    report.hash = reference.final_hash;
+    if (first_divergent.load() < runs) {
+        const RunFingerprint& expected = divergent_static ? static_reference : reference;
+        int step = *first_differing_step(expected, divergent);
+        report.divergent_run = first_divergent.load();
+        report.divergent_step = step;
+        report.divergent_stack = divergent_static ? "static" : "virtual";
+        size_t index = step - 1;
+        if (index < expected.step_hashes.size()) {
+            report.expected_step_hash = expected.step_hashes[index];
+        }
+        if (index < divergent.step_hashes.size()) {
+            report.actual_step_hash = divergent.step_hashes[index];
+        }
+    }
+    return report;
+}
+
+} // namespace Trace
@@ -0,0 +1,58 @@
+#ifndef _DETERMINISM_H_
+#define _DETERMINISM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Trace {
+
+// Fingerprint of one run: the rolling hash of its events at the end of every
+// step (entry i covers steps 1..i+1), so two fingerprints locate the first step
+// at which their runs took a different decision.
+struct RunFingerprint {
+    std::vector<uint64_t> step_hashes;
+    // Rolling hash of every event of the run, including any after the last step
+    uint64_t final_hash = 0;
+    size_t events = 0;
+};
+
+// Runs input to completion (silently), hashing its events on the fly.
+RunFingerprint fingerprint(const std::vector<uint8_t>& input);
+// Runs input to completion on the static stack, the one fuzzing runs on. It
+// cannot be traced, so each step hashes what the step left behind instead of
+// its events: the cluster state hash, the tasks queued and the messages on
+// the wire.
+RunFingerprint static_fingerprint(const std::vector<uint8_t>& input);
+
+// First step (1-based) whose hash differs, or at which one run had already
+// ended; empty if the fingerprints are identical.
+std::optional<int> first_differing_step(const RunFingerprint& expected, const RunFingerprint& actual);
+
+struct DeterminismReport {
+    int runs = 0;
+    int steps = 0;
+    size_t events = 0;
+    uint64_t hash = 0;
+    // Set for the first run (in run order) that disagrees with run 0
+    std::optional<int> divergent_run;
+    std::optional<int> divergent_step;
+    // "virtual" or "static": the stack the divergent run disagreed on
+    std::string divergent_stack;
+    uint64_t expected_step_hash = 0, actual_step_hash = 0;
+
+    bool deterministic() const { return !divergent_run.has_value(); }
+};
+std::string describe(const DeterminismReport& report);
+
+// Runs input `runs` times on each stack in this process, spread over
+// `threads` threads, and compares every run's fingerprints with the first
+// one's. Throws
+// std::invalid_argument if runs or threads is not positive.
+DeterminismReport check_determinism(const std::vector<uint8_t>& input, int runs, int threads = 1);
+
+} // namespace Trace
+
+#endif // _DETERMINISM_H_
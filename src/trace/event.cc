@@ -0,0 +1,42 @@
+#include "src/trace/event.h"
+
+namespace Trace {
+
+std::string describe(const Event& event) {
+    std::string t = "t=" + std::to_string(event.time) + " ";
+    switch (event.kind) {
+        case EventKind::TaskPop:
+            return t + "pop task " + std::to_string(event.a) + " (due " + std::to_string(event.b) + ", node " +
+                   std::to_string(event.c) + ")";
+        case EventKind::Delivery:
+            return t + "deliver message " + std::to_string(event.a) + " " + std::to_string(event.b) +
+                   " -> " + std::to_string(event.c);
+        case EventKind::RngDraw:
+            return t + "draw [" + std::to_string(event.a) + ", " + std::to_string(event.b) + "] = " +
+                   std::to_string(event.c);
+        case EventKind::Step:
+            return t + "end of step " + std::to_string(event.a) + ", state " +
+                   std::to_string(static_cast<uint64_t>(event.b)) + ", " + std::to_string(event.c) + " tasks queued";
+        case EventKind::Send:
+            return t + "send message " + std::to_string(event.a) + " " + std::to_string(event.b) + " -> " +
+                   std::to_string(event.c);
+        case EventKind::RpcStart:
+            return t + "rpc " + std::to_string(event.a) + " " + std::to_string(event.b) + " -> " +
+                   std::to_string(event.c) + " started";
+        case EventKind::RpcEnd:
+            if (event.c < 0) {
+                return t + "rpc " + std::to_string(event.a) + " of " + std::to_string(event.b) + " failed";
+            }
+            return t + "rpc " + std::to_string(event.a) + " " + std::to_string(event.b) + " -> " +
+                   std::to_string(event.c) + " completed";
+        case EventKind::NodeState:
+            return t + "node " + std::to_string(event.a) + " now in state " + std::to_string(event.b) + ", term " +
+                   std::to_string(event.c);
+        case EventKind::Drop:
+            return t + "drop message " + std::to_string(event.a) + " " + std::to_string(event.b) + " -> " +
+                   std::to_string(event.c);
+    }
+    return t + "unknown event";
+}
+
+} // namespace Trace
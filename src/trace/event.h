@@ -0,0 +1,99 @@
+#ifndef _TRACE_EVENT_H_
+#define _TRACE_EVENT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "src/clock/clock.h"
+#include "src/rng/rng.h"
+
+namespace Trace {
+
+enum class EventKind : uint8_t {
+    // a = task id, b = time the task was scheduled for, c = owning node (-1 if none)
+    TaskPop = 1,
+    // a = message id, b = from, c = to
+    Delivery = 2,
+    // a = lo, b = hi, c = value drawn
+    RngDraw = 3,
+    // End of a simulation step: a = steps run so far, b = cluster state hash,
+    // c = tasks left in the executor queue
+    Step = 4,
+    // A message put on the wire: a = message id, b = from, c = to
+    Send = 5,
+    // A node starts waiting on an RPC: a = RPC id, b = caller, c = callee
+    RpcStart = 6,
+    // Its response is in and the caller is scheduled to resume: a = RPC id,
+    // b = caller, c = responder (-1 if the network lost the RPC)
+    RpcEnd = 7,
+    // A node's Raft role or term changed during the step: a = node,
+    // b = Node::RaftState, c = term
+    NodeState = 8,
+    // A message a full link refused to queue: a = message id, b = from, c = to
+    Drop = 9,
+};
+
+// One observable decision of a simulation, stamped with the virtual time it
+// happened at. Everything a run does follows from the sequence of these.
+struct Event {
+    EventKind kind;
+    long long int time = 0;
+    int64_t a = 0, b = 0, c = 0;
+
+    bool operator==(const Event& other) const {
+        return kind == other.kind && time == other.time && a == other.a && b == other.b && c == other.c;
+    }
+    bool operator!=(const Event& other) const { return !(*this == other); }
+};
+
+std::string describe(const Event& event);
+
+// Receives the events of a run as they happen. Components hold a raw pointer
+// that is null unless someone is listening, so an untraced run pays one branch
+// per event.
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void on_event(const Event& event) = 0;
+};
+
+// Order-sensitive 64-bit digest of an event sequence: two runs with the same
+// digest took the same decisions in the same order.
+class RollingHash {
+private:
+    uint64_t value_ = 0xcbf29ce484222325ULL;
+    void mix(uint64_t word) {
+        value_ ^= word;
+        value_ *= 0x100000001b3ULL;
+        value_ ^= value_ >> 29;
+    }
+public:
+    void update(const Event& event) {
+        mix(static_cast<uint64_t>(event.kind));
+        mix(static_cast<uint64_t>(event.time));
+        mix(static_cast<uint64_t>(event.a));
+        mix(static_cast<uint64_t>(event.b));
+        mix(static_cast<uint64_t>(event.c));
+    }
+    uint64_t value() const { return value_; }
+};
+
+// Reports every draw of the wrapped RNG to sink.
+class TracingRNG : public ::RNG::RNG {
+private:
+    std::shared_ptr<::RNG::RNG> inner_;
+    std::shared_ptr<Clock::Clock> clock_;
+    EventSink* sink_;
+public:
+    TracingRNG(std::shared_ptr<::RNG::RNG> inner, std::shared_ptr<Clock::Clock> clock, EventSink* sink)
+        : inner_(std::move(inner)), clock_(std::move(clock)), sink_(sink) {}
+    int draw(int lo, int hi) override {
+        int value = inner_->draw(lo, hi);
+        sink_->on_event(Event{EventKind::RngDraw, clock_->now(), lo, hi, value});
+        return value;
+    }
+};
+
+} // namespace Trace
+
+#endif // _TRACE_EVENT_H_
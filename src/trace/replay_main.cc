@@ -0,0 +1,106 @@
+#include "src/trace/determinism.h"
+#include "src/trace/timeline.h"
+#include "src/trace/trace.h"
+#include "src/simulation/fuzz_input.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int usage(const char* name) {
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  " << name << " record <hex input> <trace file> [checkpoint interval]" << std::endl;
+    std::cout << "  " << name << " verify <trace file>" << std::endl;
+    std::cout << "  " << name << " seek <trace file> <virtual time>" << std::endl;
+    std::cout << "  " << name << " diff <expected trace> <actual trace>" << std::endl;
+    std::cout << "  " << name << " check <hex input> [runs] [--threads=N]" << std::endl;
+    std::cout << "  " << name << " timeline <hex input|trace file> <json file> [--clock=virtual|wall]" << std::endl;
+    return 1;
+}
+
+int report(const std::optional<Trace::Divergence>& divergence) {
+    if (!divergence) {
+        std::cout << "No divergence" << std::endl;
+        return 0;
+    }
+    std::cout << Trace::describe(*divergence);
+    return 2;
+}
+
+} // namespace
+
+// Records simulation runs to compact binary traces and replays them: verify a
+// trace against a fresh run, jump to a virtual time with full logging, or find
+// where two traces part ways. `check` runs one input many times in-process and
+// reports the first step at which any run strays from the first. `timeline`
+// exports a run as Chrome trace-event JSON for chrome://tracing or Perfetto.
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage(argv[0]);
+    }
+    std::string command = argv[1];
+
+    if (command == "record" && argc >= 4) {
+        int interval = argc > 4 ? std::stoi(argv[4]) : 1000;
+        auto recording = Trace::record(Simulation::from_hex(argv[2]), interval);
+        Trace::save(recording, argv[3]);
+        std::cout << "Recorded " << recording.steps << " steps, " << recording.events.size() << " events, "
+                  << recording.checkpoints.size() << " checkpoints";
+        if (recording.oracle_violation) {
+            std::cout << ", violating " << recording.violated_invariant;
+        }
+        std::cout << std::endl;
+        return 0;
+    }
+    if (command == "verify") {
+        return report(Trace::verify(Trace::load(argv[2])));
+    }
+    if (command == "seek" && argc >= 4) {
+        auto trace = Trace::load(argv[2]);
+        auto result = Trace::seek(trace, std::stoll(argv[3]), std::cout);
+        std::cout << "=== Seek ===" << std::endl;
+        std::cout << "Replayed from step " << result.from.step << " (" << result.events.size() << " events)"
+                  << std::endl;
+        std::cout << "Step " << result.step << ", state " << result.state_hash << std::endl;
+        return report(result.divergence);
+    }
+    if (command == "diff" && argc >= 4) {
+        return report(Trace::first_divergence(Trace::load(argv[2]), Trace::load(argv[3])));
+    }
+    if (command == "check") {
+        int runs = 10000;
+        int threads = 1;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--threads=", 0) == 0) {
+                threads = std::stoi(arg.substr(10));
+            } else {
+                runs = std::stoi(arg);
+            }
+        }
+        auto report = Trace::check_determinism(Simulation::from_hex(argv[2]), runs, threads);
+        std::cout << Trace::describe(report);
+        return report.deterministic() ? 0 : 2;
+    }
+    if (command == "timeline" && argc >= 4) {
+        auto clock = Trace::TimelineClock::Virtual;
+        if (argc > 4 && std::string(argv[4]).rfind("--clock=", 0) == 0) {
+            clock = Trace::parse_timeline_clock(std::string(argv[4]).substr(8));
+        }
+        // A recorded trace only knows virtual time; a hex input is run live
+        auto timeline = std::filesystem::is_regular_file(argv[2])
+            ? Trace::timeline_of(Trace::load(argv[2]))
+            : Trace::capture_timeline(Simulation::from_hex(argv[2]));
+        std::ofstream file(argv[3], std::ios::trunc);
+        Trace::write_chrome_trace(timeline, clock, file);
+        if (!file) {
+            std::cerr << "Unable to write " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << timeline.events.size() << " events to " << argv[3] << std::endl;
+        return 0;
+    }
+    return usage(argv[0]);
+}
@@ -0,0 +1,202 @@
+#include "src/trace/timeline.h"
+#include "src/node/node.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace Trace {
+
+namespace {
+
+int64_t host_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* role_name(int64_t state) {
+    switch (state) {
+        case Node::LEADER: return "LEADER";
+        case Node::FOLLOWER: return "FOLLOWER";
+        case Node::CANDIDATE: return "CANDIDATE";
+    }
+    return "UNKNOWN";
+}
+
+// Track of a node; tid 0 is the executor's own track.
+int64_t track_of(int64_t node) {
+    return node < 0 ? 0 : node + 1;
+}
+
+// Timestamps in microseconds, the unit of the trace-event format.
+std::vector<double> timestamps(const Timeline& timeline, TimelineClock clock) {
+    const auto& events = timeline.events;
+    std::vector<double> ts(events.size());
+    if (clock == TimelineClock::Wall) {
+        if (timeline.wall_ns.size() != events.size()) {
+            throw std::invalid_argument("Timeline has no wall clock times");
+        }
+        for (size_t i = 0; i < events.size(); ++i) {
+            ts[i] = timeline.wall_ns[i] / 1000.0;
+        }
+        return ts;
+    }
+    // Events are in time order, so each tick is one contiguous run of them
+    for (size_t begin = 0; begin < events.size();) {
+        size_t end = begin;
+        while (end < events.size() && events[end].time == events[begin].time) {
+            ++end;
+        }
+        double spacing = 1000.0 / (end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            ts[i] = events[i].time * 1000.0 + (i - begin) * spacing;
+        }
+        begin = end;
+    }
+    return ts;
+}
+
+class JsonEvents {
+private:
+    std::ostream& out_;
+    bool first_ = true;
+public:
+    explicit JsonEvents(std::ostream& out) : out_(out) {}
+    // fields is the body of the object after the common keys, "" for none
+    void add(const char* phase, const std::string& name, double ts, int64_t tid, const std::string& fields) {
+        out_ << (first_ ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"name\":\"" << name << "\",\"pid\":0,\"tid\":"
+             << tid << ",\"ts\":" << ts;
+        if (!fields.empty()) {
+            out_ << "," << fields;
+        }
+        out_ << "}";
+        first_ = false;
+    }
+};
+
+} // namespace
+
+TimelineClock parse_timeline_clock(const std::string& name) {
+    if (name == "virtual") {
+        return TimelineClock::Virtual;
+    }
+    if (name == "wall") {
+        return TimelineClock::Wall;
+    }
+    throw std::invalid_argument("Unknown timeline clock: " + name + " (expected virtual or wall)");
+}
+
+TimelineRecorder::TimelineRecorder() : start_ns_(host_ns()) {}
+
+void TimelineRecorder::on_event(const Event& event) {
+    timeline_.events.push_back(event);
+    timeline_.wall_ns.push_back(host_ns() - start_ns_);
+}
+
+Timeline capture_timeline(const std::vector<uint8_t>& input) {
+    TimelineRecorder recorder;
+    Simulation::SimulationResult result;
+    {
+        Simulation::SuppressOutput suppress;
+        Simulation::SimulationContext ctx(Simulation::FuzzInput::from_bytes(input.data(), input.size()), &recorder);
+        while (Simulation::advance(ctx, result)) {}
+    }
+    return std::move(recorder.timeline());
+}
+
+Timeline timeline_of(const Recording& recording) {
+    return Timeline{recording.events, {}};
+}
+
+void write_chrome_trace(const Timeline& timeline, TimelineClock clock, std::ostream& out) {
+    const auto& events = timeline.events;
+    auto ts = timestamps(timeline, clock);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    JsonEvents json(out);
+
+    std::set<int64_t> nodes;
+    // A request and its response share a message id, so flights are keyed by
+    // (id, from, to) and numbered in send order.
+    std::map<std::tuple<int64_t, int64_t, int64_t>, size_t> flights;
+    size_t next_flight = 0;
+    // Index of the next TaskPop or Step, which ends the running task's slice
+    std::vector<size_t> slice_end(events.size(), events.size());
+    for (size_t i = events.size(), end = events.size(); i-- > 0;) {
+        slice_end[i] = end;
+        if (events[i].kind == EventKind::TaskPop || events[i].kind == EventKind::Step) {
+            end = i;
+        }
+    }
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        std::string route = std::to_string(e.b) + "->" + std::to_string(e.c);
+        switch (e.kind) {
+            case EventKind::TaskPop: {
+                nodes.insert(e.c);
+                double end = slice_end[i] < events.size() ? ts[slice_end[i]] : ts[i];
+                json.add("X", "task " + std::to_string(e.a), ts[i], track_of(e.c),
+                         "\"dur\":" + std::to_string(end - ts[i]) + ",\"args\":{\"due\":" + std::to_string(e.b) + "}");
+                break;
+            }
+            case EventKind::Send: {
+                nodes.insert(e.b);
+                size_t flight = next_flight++;
+                flights[{e.a, e.b, e.c}] = flight;
+                json.add("b", "msg " + std::to_string(e.a) + " " + route, ts[i], track_of(e.b),
+                         "\"cat\":\"network\",\"id\":" + std::to_string(flight));
+                break;
+            }
+            case EventKind::Delivery: {
+                auto it = flights.find({e.a, e.b, e.c});
+                if (it == flights.end()) {
+                    break;
+                }
+                json.add("e", "msg " + std::to_string(e.a) + " " + route, ts[i], track_of(e.b),
+                         "\"cat\":\"network\",\"id\":" + std::to_string(it->second));
+                flights.erase(it);
+                break;
+            }
+            case EventKind::Drop:
+                nodes.insert(e.b);
+                json.add("i", "drop msg " + std::to_string(e.a) + " " + route, ts[i], track_of(e.b),
+                         "\"cat\":\"network\",\"s\":\"t\"");
+                break;
+            case EventKind::RpcStart:
+            case EventKind::RpcEnd:
+                nodes.insert(e.b);
+                json.add(e.kind == EventKind::RpcStart ? "b" : "e", "rpc " + std::to_string(e.a), ts[i],
+                         track_of(e.b), "\"cat\":\"rpc\",\"id\":" + std::to_string(e.a) +
+                         (e.kind == EventKind::RpcStart ? ",\"args\":{\"callee\":" + std::to_string(e.c) + "}" : ""));
+                break;
+            case EventKind::NodeState:
+                nodes.insert(e.a);
+                json.add("i", std::string(role_name(e.b)) + " term " + std::to_string(e.c), ts[i], track_of(e.a),
+                         "\"s\":\"t\"");
+                break;
+            case EventKind::Step:
+                json.add("C", "executor queue", ts[i], 0, "\"args\":{\"tasks\":" + std::to_string(e.c) + "}");
+                break;
+            case EventKind::RngDraw:
+                break;
+        }
+    }
+
+    std::string clock_name = clock == TimelineClock::Virtual ? "virtual time, 1 tick = 1 ms" : "wall time";
+    json.add("M", "process_name", 0, 0, "\"args\":{\"name\":\"simulation (" + clock_name + ")\"}");
+    json.add("M", "thread_name", 0, 0, "\"args\":{\"name\":\"executor\"}");
+    for (int64_t node : nodes) {
+        if (node >= 0) {
+            json.add("M", "thread_name", 0, track_of(node),
+                     "\"args\":{\"name\":\"node " + std::to_string(node) + "\"}");
+        }
+    }
+    out << "\n]}\n";
+}
+
+} // namespace Trace
@@ -0,0 +1,63 @@
+#ifndef _TIMELINE_H_
+#define _TIMELINE_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "src/trace/event.h"
+#include "src/trace/trace.h"
+
+namespace Trace {
+
+// Which clock places events on the exported timeline.
+enum class TimelineClock {
+    // One tick of the simulated clock is drawn as one millisecond; the events
+    // of a tick are spread evenly across it, in the order they happened.
+    Virtual,
+    // Host time at which the event was observed, to see where the simulator
+    // itself spends its time.
+    Wall,
+};
+
+// "virtual" or "wall"; throws std::invalid_argument otherwise.
+TimelineClock parse_timeline_clock(const std::string& name);
+
+// The events of one run, with host timestamps when they were captured live.
+struct Timeline {
+    std::vector<Event> events;
+    // Nanoseconds since the run started, one per event; empty for timelines
+    // built from a recording.
+    std::vector<int64_t> wall_ns;
+};
+
+// Collects events and the host time each one arrived at.
+class TimelineRecorder : public EventSink {
+private:
+    Timeline timeline_;
+    int64_t start_ns_;
+public:
+    TimelineRecorder();
+    void on_event(const Event& event) override;
+    Timeline& timeline() { return timeline_; }
+};
+
+// Runs input to completion (silently) and captures its timeline.
+Timeline capture_timeline(const std::vector<uint8_t>& input);
+// Timeline of a recorded run (virtual time only).
+Timeline timeline_of(const Recording& recording);
+
+// Writes the timeline as Chrome trace-event JSON, which chrome://tracing and
+// the Perfetto UI both open. Tracks:
+//   - one per node with a slice per executor task run on its behalf, and an
+//     "executor" track for tasks no node owns
+//   - RPC spans (register_pending_rpc to register_rpc_completion) and message
+//     flights (send to delivery) as async spans on the caller's/sender's track
+//   - Raft role and term changes as instant events on the node's track
+//   - executor queue depth at the end of each step as a counter
+// Throws std::invalid_argument if clock is Wall and the timeline has no wall times.
+void write_chrome_trace(const Timeline& timeline, TimelineClock clock, std::ostream& out);
+
+} // namespace Trace
+
+#endif // _TIMELINE_H_
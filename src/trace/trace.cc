@@ -0,0 +1,317 @@
+#include "src/trace/trace.h"
+#include "src/log/log.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace Trace {
+
+namespace {
+
+const char TRACE_MAGIC[] = "RTRACE02";
+const size_t MAGIC_SIZE = 8;
+
+class Writer {
+private:
+    std::vector<uint8_t> bytes_;
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(value));
+    }
+    void signed_varint(int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    void raw(const void* data, size_t size) {
+        auto begin = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), begin, begin + size);
+    }
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+};
+
+class Reader {
+private:
+    const std::vector<uint8_t>& bytes_;
+    size_t offset_ = 0;
+    void need(size_t size) {
+        if (offset_ + size > bytes_.size()) {
+            throw std::runtime_error("Truncated trace file");
+        }
+    }
+public:
+    explicit Reader(const std::vector<uint8_t>& bytes) : bytes_(bytes) {}
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            need(1);
+            uint8_t byte = bytes_[offset_++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Malformed varint in trace file");
+    }
+    int64_t signed_varint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    void raw(void* out, size_t size) {
+        need(size);
+        std::memcpy(out, bytes_.data() + offset_, size);
+        offset_ += size;
+    }
+    // Guards against absurd counts in a corrupted file before allocating for them.
+    size_t count() {
+        uint64_t value = varint();
+        if (value > bytes_.size() - offset_) {
+            throw std::runtime_error("Malformed count in trace file");
+        }
+        return static_cast<size_t>(value);
+    }
+};
+
+// Hashes events until the checkpoint a seek starts from, then logs, keeps and
+// checks each one against the trace.
+class SeekSink : public EventSink {
+private:
+    const Recording& trace_;
+    std::ostream& log_;
+public:
+    RollingHash hash;
+    size_t count = 0;
+    bool detailed = false;
+    long long int last_step_time = 0;
+    SeekResult result;
+
+    SeekSink(const Recording& trace, std::ostream& log) : trace_(trace), log_(log) {}
+    void on_event(const Event& event) override {
+        if (event.kind == EventKind::Step) {
+            last_step_time = event.time;
+        }
+        if (!detailed) {
+            hash.update(event);
+            ++count;
+            return;
+        }
+        log_ << "[Trace] " << describe(event) << std::endl;
+        size_t index = result.from.event_index + result.events.size();
+        const Event* expected = index < trace_.events.size() ? &trace_.events[index] : nullptr;
+        if (!result.divergence && (expected == nullptr || *expected != event)) {
+            Divergence divergence;
+            divergence.event_index = index;
+            divergence.step = result.step;
+            if (expected) {
+                divergence.expected = *expected;
+            }
+            divergence.actual = event;
+            result.divergence = divergence;
+        }
+        if (event.kind == EventKind::Step) {
+            result.step = static_cast<int>(event.a);
+        }
+        result.events.push_back(event);
+    }
+};
+
+} // namespace
+
+Recorder::Recorder(std::vector<uint8_t> input, int checkpoint_interval) {
+    recording_.input = std::move(input);
+    recording_.checkpoint_interval = checkpoint_interval;
+}
+
+void Recorder::on_event(const Event& event) {
+    recording_.events.push_back(event);
+    hash_.update(event);
+    int interval = recording_.checkpoint_interval;
+    if (event.kind == EventKind::Step && interval > 0 && event.a % interval == 0) {
+        recording_.checkpoints.push_back(Checkpoint{
+            static_cast<int>(event.a), event.time, recording_.events.size(), hash_.value()});
+    }
+}
+
+Recording record(const std::vector<uint8_t>& input, int checkpoint_interval) {
+    Recorder recorder(input, checkpoint_interval);
+    Simulation::SimulationResult result;
+    {
+        Simulation::SuppressOutput suppress;
+        Simulation::SimulationContext ctx(Simulation::FuzzInput::from_bytes(input.data(), input.size()), &recorder);
+        while (Simulation::advance(ctx, result)) {}
+    }
+    Recording& recording = recorder.recording();
+    recording.steps = result.steps;
+    recording.oracle_violation = result.oracle_violation;
+    recording.violated_invariant = result.violated_invariant;
+    return std::move(recording);
+}
+
+void save(const Recording& recording, const std::string& path) {
+    Writer writer;
+    writer.raw(TRACE_MAGIC, MAGIC_SIZE);
+    writer.varint(recording.input.size());
+    writer.raw(recording.input.data(), recording.input.size());
+    writer.varint(recording.checkpoint_interval);
+    writer.varint(recording.steps);
+    writer.varint(recording.oracle_violation ? 1 : 0);
+    writer.varint(recording.violated_invariant.size());
+    writer.raw(recording.violated_invariant.data(), recording.violated_invariant.size());
+
+    writer.varint(recording.events.size());
+    long long int previous_time = 0;
+    for (const auto& event : recording.events) {
+        writer.varint(static_cast<uint64_t>(event.kind));
+        writer.signed_varint(event.time - previous_time);
+        writer.signed_varint(event.a);
+        writer.signed_varint(event.b);
+        writer.signed_varint(event.c);
+        previous_time = event.time;
+    }
+
+    writer.varint(recording.checkpoints.size());
+    for (const auto& checkpoint : recording.checkpoints) {
+        writer.varint(checkpoint.step);
+        writer.signed_varint(checkpoint.time);
+        writer.varint(checkpoint.event_index);
+        writer.raw(&checkpoint.rolling_hash, sizeof(checkpoint.rolling_hash));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(writer.bytes().data()), writer.bytes().size());
+    if (!file) {
+        throw std::runtime_error("Unable to write trace to " + path);
+    }
+}
+
+Recording load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open trace " + path);
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader reader(bytes);
+    char magic[MAGIC_SIZE];
+    reader.raw(magic, MAGIC_SIZE);
+    if (std::memcmp(magic, TRACE_MAGIC, MAGIC_SIZE) != 0) {
+        throw std::runtime_error(path + " is not a trace file");
+    }
+
+    Recording recording;
+    recording.input.resize(reader.count());
+    reader.raw(recording.input.data(), recording.input.size());
+    recording.checkpoint_interval = static_cast<int>(reader.varint());
+    recording.steps = static_cast<int>(reader.varint());
+    recording.oracle_violation = reader.varint() != 0;
+    recording.violated_invariant.resize(reader.count());
+    reader.raw(recording.violated_invariant.data(), recording.violated_invariant.size());
+
+    recording.events.resize(reader.count());
+    long long int time = 0;
+    for (auto& event : recording.events) {
+        event.kind = static_cast<EventKind>(reader.varint());
+        time += reader.signed_varint();
+        event.time = time;
+        event.a = reader.signed_varint();
+        event.b = reader.signed_varint();
+        event.c = reader.signed_varint();
+    }
+
+    recording.checkpoints.resize(reader.count());
+    for (auto& checkpoint : recording.checkpoints) {
+        checkpoint.step = static_cast<int>(reader.varint());
+        checkpoint.time = reader.signed_varint();
+        checkpoint.event_index = reader.varint();
+        reader.raw(&checkpoint.rolling_hash, sizeof(checkpoint.rolling_hash));
+    }
+    return recording;
+}
+
+std::string describe(const Divergence& divergence) {
+    std::string msg = "First divergence at event " + std::to_string(divergence.event_index) +
+                      ", after step " + std::to_string(divergence.step) + "\n";
+    msg += "  expected: " + (divergence.expected ? describe(*divergence.expected) : std::string("end of run")) + "\n";
+    msg += "  actual:   " + (divergence.actual ? describe(*divergence.actual) : std::string("end of run")) + "\n";
+    return msg;
+}
+
+std::optional<Divergence> first_divergence(const Recording& expected, const Recording& actual) {
+    size_t common = std::min(expected.events.size(), actual.events.size());
+    int step = 0;
+    for (size_t i = 0; i <= common; ++i) {
+        bool expected_ended = i == expected.events.size();
+        bool actual_ended = i == actual.events.size();
+        if (expected_ended && actual_ended) {
+            return std::nullopt;
+        }
+        if (expected_ended || actual_ended || expected.events[i] != actual.events[i]) {
+            Divergence divergence;
+            divergence.event_index = i;
+            divergence.step = step;
+            if (!expected_ended) {
+                divergence.expected = expected.events[i];
+            }
+            if (!actual_ended) {
+                divergence.actual = actual.events[i];
+            }
+            return divergence;
+        }
+        if (expected.events[i].kind == EventKind::Step) {
+            step = static_cast<int>(expected.events[i].a);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Divergence> verify(const Recording& trace) {
+    return first_divergence(trace, record(trace.input, trace.checkpoint_interval));
+}
+
+SeekResult seek(const Recording& trace, long long int time, std::ostream& log) {
+    SeekSink sink(trace, log);
+    const Checkpoint* start = nullptr;
+    for (const auto& checkpoint : trace.checkpoints) {
+        if (checkpoint.time <= time) {
+            start = &checkpoint;
+        }
+    }
+    // Without a checkpoint early enough the whole run is replayed in detail:
+    // the context already draws from its RNG while it is built, before step 1
+    std::unique_ptr<Simulation::SuppressOutput> suppress;
+    std::optional<Log::ScopedSink> to_log;
+    if (start) {
+        sink.result.from = *start;
+        suppress = std::make_unique<Simulation::SuppressOutput>();
+    } else {
+        to_log.emplace(log);
+        sink.detailed = true;
+    }
+    const Checkpoint& from = sink.result.from;
+
+    Simulation::SimulationResult result;
+    Simulation::SimulationContext ctx(Simulation::FuzzInput::from_bytes(trace.input.data(), trace.input.size()), &sink);
+    if (start) {
+        while (ctx.steps() < from.step && Simulation::advance(ctx, result)) {}
+        if (ctx.steps() != from.step || sink.count != from.event_index || sink.hash.value() != from.rolling_hash) {
+            throw std::runtime_error("Run diverged from the trace before the checkpoint at step " +
+                                     std::to_string(from.step) + "; verify the trace to find where");
+        }
+        suppress.reset();
+        to_log.emplace(log);
+        sink.detailed = true;
+    }
+
+    sink.result.step = from.step;
+    while (sink.last_step_time < time && Simulation::advance(ctx, result)) {}
+    sink.result.state_hash = ctx.state_hash();
+    return sink.result;
+}
+
+} // namespace Trace
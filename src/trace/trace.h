@@ -0,0 +1,95 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "src/trace/event.h"
+
+namespace Trace {
+
+// Where a replay can start checking from: the rolling hash of every event up
+// to the end of a step.
+struct Checkpoint {
+    int step = 0;
+    long long int time = 0;
+    // Events before the checkpoint
+    size_t event_index = 0;
+    uint64_t rolling_hash = 0;
+
+    bool operator==(const Checkpoint& other) const {
+        return step == other.step && time == other.time && event_index == other.event_index &&
+               rolling_hash == other.rolling_hash;
+    }
+};
+
+// Everything a run decided, in order, plus enough to run it again.
+struct Recording {
+    std::vector<uint8_t> input;
+    int checkpoint_interval = 0;
+    std::vector<Event> events;
+    std::vector<Checkpoint> checkpoints;
+    int steps = 0;
+    bool oracle_violation = false;
+    std::string violated_invariant;
+};
+
+// Collects the events of a run, taking a checkpoint every interval steps.
+class Recorder : public EventSink {
+private:
+    Recording recording_;
+    RollingHash hash_;
+public:
+    Recorder(std::vector<uint8_t> input, int checkpoint_interval);
+    void on_event(const Event& event) override;
+    uint64_t rolling_hash() const { return hash_.value(); }
+    Recording& recording() { return recording_; }
+};
+
+// Runs input to completion (silently) and records it.
+Recording record(const std::vector<uint8_t>& input, int checkpoint_interval = 1000);
+
+// Compact binary trace file: "RTRACE02", then varints (zigzag for signed
+// fields, time as a delta from the previous event). Throws
+// std::runtime_error on I/O errors and malformed files.
+void save(const Recording& recording, const std::string& path);
+Recording load(const std::string& path);
+
+// The first event two runs disagree on. A side is empty when its run ended first.
+struct Divergence {
+    size_t event_index = 0;
+    // Steps both runs had completed before the divergence
+    int step = 0;
+    std::optional<Event> expected, actual;
+};
+std::string describe(const Divergence& divergence);
+
+std::optional<Divergence> first_divergence(const Recording& expected, const Recording& actual);
+
+// Re-runs the recorded input and compares the fresh run with the trace.
+std::optional<Divergence> verify(const Recording& trace);
+
+struct SeekResult {
+    // Checkpoint the detailed replay started from; the default (step 0, no
+    // event) if none was early enough and the run was replayed from its start
+    Checkpoint from;
+    // Events between that checkpoint and the target time
+    std::vector<Event> events;
+    std::optional<Divergence> divergence;
+    int step = 0;
+    uint64_t state_hash = 0;
+};
+
+// Brings a fresh run of the trace's input to virtual time `time`. Only the
+// stretch after the nearest checkpoint at or before `time` (or the whole run,
+// if there is none) is replayed in detail: up to there the run executes with logging off and only hashes its
+// events, which must match the checkpoint. From there on, component logs and
+// events go to log and every event is checked against the trace.
+SeekResult seek(const Recording& trace, long long int time, std::ostream& log);
+
+} // namespace Trace
+
+#endif // _TRACE_H_
@@ -0,0 +1,57 @@
+#include "bench/benchmark.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <stdexcept>
+
+TEST(BenchmarkTest, CalibratesAndSkipsFilteredBenchmarks) {
+    Bench::Options options;
+    options.filter = "kept";
+    options.min_time_ms = 1;
+    options.rounds = 2;
+    Bench::Runner runner(options);
+
+    uint64_t calls = 0;
+    ASSERT_TRUE(runner.run("kept/loop", [&calls](uint64_t n, Bench::Counters& counters) {
+        volatile uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum = sum + i;
+        }
+        ++calls;
+        counters["batch"] = static_cast<double>(n);
+    }));
+    ASSERT_FALSE(runner.run("dropped/loop", [](uint64_t, Bench::Counters&) {}));
+
+    ASSERT_EQ(runner.results().size(), 1u);
+    const auto& result = runner.results()[0];
+    ASSERT_GT(result.iterations, 1u);
+    ASSERT_GT(result.ns_per_op, 0);
+    ASSERT_EQ(result.counters.at("batch"), static_cast<double>(result.iterations));
+    // At least one calibration batch plus the timed rounds
+    ASSERT_GE(calls, 3u);
+}
+
+TEST(BenchmarkTest, JsonReportReadsBackAsBaseline) {
+    Bench::Result a{"executor/push_pop", 1000, 12.5, 8e7, {{"depth", 1024}}};
+    Bench::Result b{"fuzz/exec/nodes=5", 10, 250000.25, 4000, {}};
+    auto path = (std::filesystem::path(testing::TempDir()) / "bench.json").string();
+    Bench::write_json({a, b}, path);
+
+    auto baseline = Bench::read_baseline(path);
+    ASSERT_EQ(baseline.size(), 2u);
+    ASSERT_DOUBLE_EQ(baseline.at("executor/push_pop"), 12.5);
+    ASSERT_DOUBLE_EQ(baseline.at("fuzz/exec/nodes=5"), 250000.25);
+    ASSERT_THROW(Bench::read_baseline(path + ".missing"), std::runtime_error);
+}
+
+TEST(BenchmarkTest, ParsesCommonFlags) {
+    const char* argv[] = {"bench", "--filter=rng", "--min-time-ms=5", "--rounds=4", "--json=out.json"};
+    std::vector<std::string> rest;
+    auto options = Bench::parse_options(5, const_cast<char**>(argv), rest);
+    ASSERT_EQ(options.filter, "rng");
+    ASSERT_EQ(options.min_time_ms, 5);
+    ASSERT_EQ(options.rounds, 4);
+    ASSERT_EQ(rest, std::vector<std::string>{"--json=out.json"});
+
+    const char* bad[] = {"bench", "--rounds=0"};
+    ASSERT_THROW(Bench::parse_options(2, const_cast<char**>(bad), rest), std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+#include "src/coverage/coverage_map.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(CoverageMapTest, HitCountsFallIntoAFLBuckets) {
+    Coverage::CoverageMap run;
+    const int hits[] = {1, 2, 3, 5, 9, 20, 100, 300};
+    for (int state = 0; state < 8; state++) {
+        for (int i = 0; i < hits[state]; i++) {
+            run.record(state);
+        }
+    }
+    run.classify();
+    for (int state = 0; state < 8; state++) {
+        ASSERT_EQ(run.at(Coverage::slot_of(state)), 1 << state);
+    }
+    ASSERT_EQ(run.count(), 8u);
+
+    run.clear();
+    ASSERT_EQ(run.count(), 0u);
+    ASSERT_TRUE(run == Coverage::CoverageMap());
+}
+
+TEST(CoverageMapTest, MergeReportsNewStatesThenNewHitCounts) {
+    Coverage::GlobalCoverage global;
+    Coverage::CoverageMap run;
+    run.record(7);
+    run.classify();
+    ASSERT_EQ(global.merge(run), Coverage::Novelty::NewStates);
+    ASSERT_EQ(global.merge(run), Coverage::Novelty::None);
+
+    run.clear();
+    run.record(7);
+    run.record(7);
+    run.classify();
+    std::vector<uint64_t> changed;
+    ASSERT_EQ(global.merge(run, 0, Coverage::MAP_SIZE, &changed), Coverage::Novelty::NewHitCounts);
+    ASSERT_EQ(global.covered(), 1u);
+    ASSERT_TRUE(global.covers(7));
+
+    // Replaying the records rebuilds the same union
+    ASSERT_EQ(changed, (std::vector<uint64_t>{uint64_t(Coverage::slot_of(7)) << 8 | 2}));
+    Coverage::GlobalCoverage restored;
+    restored.restore(uint64_t(Coverage::slot_of(7)) << 8 | 1);
+    restored.restore(changed[0]);
+    ASSERT_EQ(restored.at(Coverage::slot_of(7)), global.at(Coverage::slot_of(7)));
+    ASSERT_EQ(restored.covered(), 1u);
+}
+
+TEST(CoverageMapTest, MergeOnlyTouchesItsRange) {
+    Coverage::GlobalCoverage global;
+    Coverage::CoverageMap run;
+    run.record(1);
+    run.classify();
+    uint32_t slot = Coverage::slot_of(1);
+    ASSERT_EQ(global.merge(run, 0, slot), Coverage::Novelty::None);
+    ASSERT_EQ(global.merge(run, slot + 1, Coverage::MAP_SIZE), Coverage::Novelty::None);
+    ASSERT_EQ(global.merge(run, slot, slot + 1), Coverage::Novelty::NewStates);
+}
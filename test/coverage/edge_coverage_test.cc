@@ -0,0 +1,78 @@
+#include "src/coverage/edge_coverage.h"
+#include "src/coverage/coverage_map.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+
+// What clang's -fsanitize-coverage=trace-pc-guard,pc-table calls; the tests
+// call them by hand, for a module of their own.
+extern "C" void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop);
+extern "C" void __sanitizer_cov_pcs_init(const uintptr_t* pcs_begin, const uintptr_t* pcs_end);
+extern "C" void __sanitizer_cov_trace_pc_guard(uint32_t* guard);
+
+namespace {
+
+void first_function() {}
+void second_function() {}
+
+} // namespace
+
+TEST(EdgeCoverageTest, GuardsAreNumberedOnce) {
+    static uint32_t guards[3];
+    size_t before = Coverage::edge_count();
+    __sanitizer_cov_trace_pc_guard_init(guards, guards + 3);
+    EXPECT_EQ(Coverage::edge_count(), before + 3);
+    EXPECT_EQ(guards[0], before + 1);
+    EXPECT_EQ(guards[2], before + 3);
+    // Modules may register the same guards again
+    __sanitizer_cov_trace_pc_guard_init(guards, guards + 3);
+    EXPECT_EQ(Coverage::edge_count(), before + 3);
+}
+
+TEST(EdgeCoverageTest, TakenEdgesGoToTheScopedRun) {
+    static uint32_t guards[2];
+    __sanitizer_cov_trace_pc_guard_init(guards, guards + 2);
+    size_t edge = guards[0] - 1;
+    size_t hit_before = Coverage::edges_hit();
+
+    Coverage::CoverageMap run;
+    {
+        Coverage::ScopedEdgeFeedback feedback(&run);
+        __sanitizer_cov_trace_pc_guard(&guards[0]);
+        __sanitizer_cov_trace_pc_guard(&guards[0]);
+    }
+    __sanitizer_cov_trace_pc_guard(&guards[1]);
+
+    EXPECT_EQ(run.count(), 1u);
+    EXPECT_EQ(run.at(Coverage::slot_of(Coverage::edge_hash(edge))), 2);
+    // Taken outside a run still counts as taken
+    EXPECT_TRUE(Coverage::edge_hit(edge));
+    EXPECT_TRUE(Coverage::edge_hit(edge + 1));
+    EXPECT_EQ(Coverage::edges_hit(), hit_before + 2);
+}
+
+TEST(EdgeCoverageTest, ReportsFunctionsWithColdEdges) {
+    static uint32_t guards[5];
+    auto first = reinterpret_cast<uintptr_t>(&first_function);
+    auto second = reinterpret_cast<uintptr_t>(&second_function);
+    // Two functions: entry and one edge, entry and two edges
+    static uintptr_t pcs[10];
+    uintptr_t table[10] = {first, 1, first + 4, 0, second, 1, second + 4, 0, second + 8, 0};
+    std::copy(table, table + 10, pcs);
+    __sanitizer_cov_trace_pc_guard_init(guards, guards + 5);
+    __sanitizer_cov_pcs_init(pcs, pcs + 10);
+
+    __sanitizer_cov_trace_pc_guard(&guards[0]);
+    __sanitizer_cov_trace_pc_guard(&guards[1]);
+    __sanitizer_cov_trace_pc_guard(&guards[2]);
+
+    auto cold = Coverage::cold_functions("");
+    ASSERT_EQ(cold.size(), 1u);
+    EXPECT_EQ(cold[0].edges, 3u);
+    EXPECT_EQ(cold[0].cold, 2u);
+    ASSERT_EQ(cold[0].locations.size(), 2u);
+    // Without a symbolizer, edges are placed by their offset into the function
+    EXPECT_EQ(cold[0].locations[0], "+0x4");
+    EXPECT_TRUE(Coverage::cold_functions("no such function").empty());
+    EXPECT_NE(Coverage::describe_cold_functions("").find("2/3 cold"), std::string::npos);
+}
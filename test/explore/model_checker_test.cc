@@ -0,0 +1,110 @@
+#include "src/explore/model_checker.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+Explore::ExploreBounds bounds_until(long long max_time, bool reduction, bool dedup) {
+    Explore::ExploreBounds bounds;
+    bounds.max_time = max_time;
+    bounds.reduction = reduction;
+    bounds.dedup = dedup;
+    return bounds;
+}
+
+} // namespace
+
+TEST(ModelCheckerTest, ChecksElectionSafetyForThreeNodes) {
+    Explore::ModelConfig config;
+    auto result = Explore::explore(config, bounds_until(20, true, true));
+    EXPECT_TRUE(result.complete);
+    EXPECT_TRUE(result.violation.empty()) << result.describe();
+    // The signature leaves out nothing the rest of an execution depends on
+    EXPECT_TRUE(result.proved_election_safety()) << result.describe();
+    // The bounds reach the first election, and a winner
+    EXPECT_TRUE(result.leader_elected);
+    EXPECT_EQ(result.highest_term, 1);
+    EXPECT_GT(result.states_per_second(), 0);
+}
+
+TEST(ModelCheckerTest, ProvesElectionSafetyWithoutDedup) {
+    Explore::ModelConfig config;
+    config.nr_nodes = 2;
+    auto result = Explore::explore(config, bounds_until(30, true, false));
+    EXPECT_TRUE(result.proved_election_safety()) << result.describe();
+    EXPECT_TRUE(result.leader_elected);
+}
+
+TEST(ModelCheckerTest, DedupOnlyMergesStatesNothingTellsApart) {
+    Explore::ModelConfig config;
+    config.nr_nodes = 2;
+    // Up to the new leader's first heartbeats
+    auto full = Explore::explore(config, bounds_until(30, false, false));
+    auto deduplicated = Explore::explore(config, bounds_until(30, false, true));
+    ASSERT_TRUE(full.proved_election_safety());
+    ASSERT_TRUE(deduplicated.proved_election_safety());
+    EXPECT_EQ(deduplicated.distinct_states, full.distinct_states);
+    EXPECT_EQ(deduplicated.node_states, full.node_states);
+    EXPECT_LT(deduplicated.transitions, full.transitions / 100);
+}
+
+TEST(ModelCheckerTest, FindsTwoLeadersWhenVotesAreForged) {
+    Explore::ModelConfig config;
+    config.forge_votes = true;
+    auto result = Explore::explore(config, bounds_until(20, true, true));
+    ASSERT_FALSE(result.violation.empty());
+    EXPECT_FALSE(result.proved_election_safety());
+    // The trace ends with the action that made the second leader
+    EXPECT_FALSE(result.trace.empty());
+    EXPECT_NE(result.describe().find(result.violation), std::string::npos);
+}
+
+TEST(ModelCheckerTest, ReductionReachesEveryNodeStateWithFewerExecutions) {
+    Explore::ModelConfig config;
+    config.nr_nodes = 2;
+    auto full = Explore::explore(config, bounds_until(30, false, false));
+    auto reduced = Explore::explore(config, bounds_until(30, true, false));
+    ASSERT_TRUE(full.complete);
+    ASSERT_TRUE(reduced.complete);
+    EXPECT_EQ(reduced.node_states, full.node_states);
+    EXPECT_LT(reduced.executions, full.executions);
+}
+
+TEST(ModelCheckerTest, ReductionWithDedupReachesEveryNodeState) {
+    Explore::ModelConfig config;
+    auto stateful = Explore::explore(config, bounds_until(20, false, true));
+    auto reduced = Explore::explore(config, bounds_until(20, true, true));
+    EXPECT_EQ(reduced.node_states, stateful.node_states);
+    EXPECT_LT(reduced.transitions, stateful.transitions);
+}
+
+TEST(ModelCheckerTest, SearchIsDeterministic) {
+    Explore::ModelConfig config;
+    config.election_timeout_max = 25;
+    config.rng_seed = 5;
+    auto first = Explore::explore(config, bounds_until(25, true, true));
+    auto second = Explore::explore(config, bounds_until(25, true, true));
+    EXPECT_EQ(first.transitions, second.transitions);
+    EXPECT_EQ(first.distinct_states, second.distinct_states);
+    EXPECT_EQ(first.node_states, second.node_states);
+}
+
+TEST(ModelCheckerTest, CutExecutionsProveNothing) {
+    Explore::ModelConfig config;
+    auto bounds = bounds_until(20, true, true);
+    bounds.max_depth = 10;
+    auto result = Explore::explore(config, bounds);
+    EXPECT_FALSE(result.complete);
+    EXPECT_FALSE(result.proved_election_safety());
+
+    bounds.max_depth = 100;
+    bounds.max_transitions = 50;
+    result = Explore::explore(config, bounds);
+    EXPECT_FALSE(result.complete);
+    EXPECT_EQ(result.transitions, 50u);
+}
+
+TEST(ModelCheckerTest, RefusesEmptyBounds) {
+    Explore::ModelConfig config;
+    config.nr_nodes = 0;
+    EXPECT_THROW(Explore::explore(config, Explore::ExploreBounds{}), std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+#include "src/fuzzer/corpus_store.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+std::string fresh_dir(const std::string& name) {
+    auto dir = std::filesystem::path(testing::TempDir()) / name;
+    std::filesystem::remove_all(dir);
+    return dir.string();
+}
+
+} // namespace
+
+TEST(CorpusStoreTest, ReopenedStoreSeesAppendedStateAndDropsTornTail) {
+    auto dir = fresh_dir("corpus_store_reopen");
+    {
+        Fuzzer::CorpusStore store(dir);
+        ASSERT_TRUE(store.entries().empty());
+        store.append_entry({1, 2, 3});
+        store.append_entry({4});
+        store.append_coverage({10, 20});
+        store.append_coverage({30});
+    }
+    {
+        // Simulate a crash halfway through writing a record
+        std::ofstream corpus(dir + "/corpus.bin", std::ios::binary | std::ios::app);
+        uint32_t length = 100;
+        corpus.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        corpus.write("abc", 3);
+    }
+    {
+        Fuzzer::CorpusStore store(dir);
+        ASSERT_EQ(store.entries(), (std::vector<std::vector<uint8_t>>{{1, 2, 3}, {4}}));
+        ASSERT_EQ(store.coverage(), (std::vector<uint64_t>{10, 20, 30}));
+        store.append_entry({5});
+    }
+    Fuzzer::CorpusStore store(dir);
+    ASSERT_EQ(store.entries().size(), 3);
+    ASSERT_EQ(store.entries().back(), std::vector<uint8_t>{5});
+}
+
+TEST(CorpusStoreTest, MinimizationKeepsSmallestCoveringSet) {
+    std::vector<std::vector<uint8_t>> entries = {
+        {0, 0, 0, 0},  // covers 1,2
+        {0},           // covers 1,2 as well, but smaller
+        {0, 0},        // covers 3
+        {0, 0, 0},     // covers 1,2,3
+    };
+    std::vector<std::vector<uint64_t>> hashes = {{1, 2}, {1, 2}, {3}, {1, 2, 3}};
+    auto kept = Fuzzer::minimize_corpus(hashes, entries);
+    ASSERT_EQ(kept, std::vector<size_t>{3});
+
+    // No single entry covers everything anymore: ties go to the smaller inputs
+    hashes[3] = {1, 3};
+    kept = Fuzzer::minimize_corpus(hashes, entries);
+    ASSERT_EQ(kept, (std::vector<size_t>{1, 2}));
+}
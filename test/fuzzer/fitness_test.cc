@@ -0,0 +1,52 @@
+#include "src/fuzzer/fuzzer.h"
+#include "src/oracle/oracle.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+
+TEST(FitnessTest, WeighsEachSignal) {
+    Oracle::Proximity proximity{2, 1, 3};
+    EXPECT_EQ(Oracle::fitness(proximity, Oracle::FitnessWeights{}), 2 * 4 + 1 * 8 + 3 * 1);
+    EXPECT_EQ(Oracle::fitness(proximity, Oracle::FitnessWeights{0, 0, 1}), 3);
+}
+
+TEST(FitnessTest, ParsesWeights) {
+    auto weights = Oracle::parse_fitness_weights("splits=2,gap=0");
+    EXPECT_EQ(weights.concurrent_candidates, Oracle::FitnessWeights{}.concurrent_candidates);
+    EXPECT_EQ(weights.split_votes, 2);
+    EXPECT_EQ(weights.term_gap, 0);
+    EXPECT_THROW(Oracle::parse_fitness_weights("leaders=1"), std::invalid_argument);
+    EXPECT_THROW(Oracle::parse_fitness_weights("gap"), std::invalid_argument);
+    EXPECT_THROW(Oracle::parse_fitness_weights("gap=-1"), std::invalid_argument);
+}
+
+TEST(FitnessTest, RunsReportHowCloseTheyCame) {
+    Simulation::FuzzInput input;
+    input.nr_nodes = 5;
+    input.rng_seed = 3;
+    input.max_steps = 3000;
+    auto result = Simulation::run_simulation(input.to_bytes());
+    ASSERT_FALSE(result.oracle_violation);
+    // Someone stood for election
+    EXPECT_GE(result.proximity.concurrent_candidates, 1);
+    // Deterministic, like the coverage
+    EXPECT_EQ(Simulation::run_simulation(input.to_bytes()).proximity, result.proximity);
+}
+
+TEST(FitnessTest, GuidedCampaignsKeepFitterInputs) {
+    Fuzzer::CoverageFuzzer unguided(7);
+    Fuzzer::CoverageFuzzer guided(7);
+    guided.set_fitness(true);
+    for (auto* fuzzer : {&unguided, &guided}) {
+        fuzzer->set_shrink_violations(false);
+        fuzzer->seed_corpus(Simulation::FuzzInput{}.to_bytes());
+        fuzzer->run(200);
+    }
+    // Both score their runs; only the guided one hands scores to the scheduler
+    EXPECT_GT(unguided.best_fitness(), 0);
+    EXPECT_GT(guided.best_fitness(), 0);
+    EXPECT_EQ(guided.executions_to_fitness(guided.best_fitness()), guided.fitness_curve().back().first);
+    EXPECT_EQ(unguided.scheduler().entry(0).fitness, 0);
+    EXPECT_GT(guided.scheduler().entry(0).fitness, 0);
+}
@@ -0,0 +1,51 @@
+#include "src/fuzzer/parallel_fuzzer.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+TEST(ParallelFuzzerTest, ConcurrentPublishersNeverLoseEntriesOrCoverage) {
+    Fuzzer::ConcurrentCorpus corpus(4 * 1000);
+    Fuzzer::ShardedCoverage coverage;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            Coverage::CoverageMap run;
+            for (int i = 0; i < 1000; i++) {
+                corpus.publish({static_cast<uint8_t>(t), static_cast<uint8_t>(i % 256), static_cast<uint8_t>(i / 256)});
+                // Every thread merges the same states; each must count once.
+                run.record(i);
+                run.classify();
+                coverage.merge(run);
+                run.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<uint32_t> slots;
+    for (int i = 0; i < 1000; i++) {
+        slots.insert(Coverage::slot_of(i));
+    }
+    ASSERT_EQ(coverage.size(), slots.size());
+    ASSERT_EQ(corpus.size(), 4000);
+    std::set<std::vector<uint8_t>> entries;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        ASSERT_NE(corpus.get(i), nullptr);
+        entries.insert(*corpus.get(i));
+    }
+    ASSERT_EQ(entries.size(), 4000);
+    ASSERT_FALSE(corpus.publish({0}));
+}
+
+TEST(ParallelFuzzerTest, WorkersStealFromEachOther) {
+    Fuzzer::WorkStealingDeque deque;
+    deque.push(Fuzzer::FuzzJob{1});
+    deque.push(Fuzzer::FuzzJob{2});
+    ASSERT_EQ(deque.pop()->iterations, 2);
+    ASSERT_EQ(deque.steal()->iterations, 1);
+    ASSERT_FALSE(deque.steal().has_value());
+}
@@ -0,0 +1,102 @@
+#include "src/fuzzer/power_schedule.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+Fuzzer::EntryMetadata entry(int steps, std::vector<uint32_t> slots) {
+    Fuzzer::EntryMetadata meta;
+    meta.steps = steps;
+    meta.slots = std::move(slots);
+    return meta;
+}
+
+// Entry 0 reaches only a state every run hits, entry 1 also reaches one hit once.
+Fuzzer::PowerScheduler common_and_rare(Fuzzer::PowerSchedule schedule) {
+    Fuzzer::PowerScheduler scheduler(schedule);
+    scheduler.add_entry(entry(1000, {1, 2}));
+    scheduler.add_entry(entry(1000, {1, 3}));
+    for (int i = 0; i < 50; ++i) {
+        scheduler.record_hits({1, 2});
+    }
+    scheduler.record_hits({1, 3});
+    return scheduler;
+}
+
+} // namespace
+
+TEST(PowerScheduleTest, ParsesScheduleNames) {
+    EXPECT_EQ(Fuzzer::parse_power_schedule("fast"), Fuzzer::PowerSchedule::Fast);
+    EXPECT_STREQ(Fuzzer::schedule_name(Fuzzer::parse_power_schedule("rare")), "rare");
+    EXPECT_THROW(Fuzzer::parse_power_schedule("coe"), std::runtime_error);
+}
+
+TEST(PowerScheduleTest, ExploreFavoursCheapEntriesReachingManyStates) {
+    Fuzzer::PowerScheduler scheduler(Fuzzer::PowerSchedule::Explore);
+    scheduler.add_entry(entry(100, {1, 2, 3, 4, 5, 6}));
+    scheduler.add_entry(entry(5000, {1}));
+    scheduler.add_entry(entry(1000, {1, 2}));
+    EXPECT_GT(scheduler.energy(0), scheduler.energy(2));
+    EXPECT_GT(scheduler.energy(2), scheduler.energy(1));
+}
+
+TEST(PowerScheduleTest, RareAndFastFavourEntriesReachingRareStates) {
+    auto rare = common_and_rare(Fuzzer::PowerSchedule::Rare);
+    EXPECT_GT(rare.energy(1), rare.energy(0));
+    auto fast = common_and_rare(Fuzzer::PowerSchedule::Fast);
+    EXPECT_GT(fast.energy(1), fast.energy(0));
+    // Hit counts do not matter to explore
+    auto explore = common_and_rare(Fuzzer::PowerSchedule::Explore);
+    EXPECT_EQ(explore.energy(1), explore.energy(0));
+}
+
+TEST(PowerScheduleTest, RoundsGiveEachEntryItsEnergyInTurn) {
+    auto scheduler = common_and_rare(Fuzzer::PowerSchedule::Fast);
+    std::mt19937 rng(1);
+    for (size_t idx = 0; idx < scheduler.size(); ++idx) {
+        uint32_t energy = scheduler.energy(idx);
+        for (uint32_t i = 0; i < energy; ++i) {
+            EXPECT_EQ(scheduler.next(rng), idx);
+        }
+    }
+    EXPECT_EQ(scheduler.entry(1).times_picked, 1u);
+    // Then back to the start of the corpus
+    EXPECT_EQ(scheduler.next(rng), 0u);
+}
+
+TEST(PowerScheduleTest, FitterEntriesGetMoreEnergy) {
+    Fuzzer::PowerScheduler scheduler(Fuzzer::PowerSchedule::Explore);
+    scheduler.add_entry(entry(1000, {1, 2}));
+    auto fit = entry(1000, {1, 2});
+    fit.fitness = 20;
+    scheduler.add_entry(fit);
+    EXPECT_DOUBLE_EQ(scheduler.fitness_boost(0), 1.0);
+    EXPECT_DOUBLE_EQ(scheduler.fitness_boost(1), 4.0);
+    EXPECT_EQ(scheduler.energy(1), 4 * scheduler.energy(0));
+}
+
+TEST(PowerScheduleTest, UniformPicksFitterEntriesMoreOften) {
+    Fuzzer::PowerScheduler scheduler(Fuzzer::PowerSchedule::Uniform);
+    scheduler.add_entry(entry(1000, {1}));
+    auto fit = entry(1000, {2});
+    fit.fitness = 10;
+    scheduler.add_entry(fit);
+    std::mt19937 rng(1);
+    int fit_picks = 0;
+    for (int i = 0; i < 5000; ++i) {
+        fit_picks += scheduler.next(rng) == 1 ? 1 : 0;
+    }
+    // Weights 1 and 4
+    EXPECT_NEAR(fit_picks, 4000, 200);
+}
+
+TEST(PowerScheduleTest, FastEnergyGrowsEachTimeAnEntryIsPicked) {
+    auto scheduler = common_and_rare(Fuzzer::PowerSchedule::Fast);
+    std::mt19937 rng(1);
+    uint32_t before = scheduler.energy(0);
+    for (uint32_t i = 0; i < before; ++i) {
+        scheduler.next(rng);
+    }
+    EXPECT_GT(scheduler.energy(0), before);
+}
@@ -0,0 +1,64 @@
+#include "src/fuzzer/shrinker.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+
+namespace {
+
+// Stands in for the simulation: violates "election_safety" at step 300 when the
+// cluster has at least 5 nodes and the network delay is at least 40.
+Simulation::SimulationResult fake_run(const std::vector<uint8_t>& bytes) {
+    auto input = Simulation::FuzzInput::from_bytes(bytes.data(), bytes.size());
+    Simulation::SimulationResult result;
+    result.steps = input.max_steps;
+    if (input.nr_nodes >= 5 && input.max_network_delay >= 40 && input.max_steps >= 300) {
+        result.oracle_violation = true;
+        result.violated_invariant = "election_safety";
+        result.steps = 300;
+    }
+    return result;
+}
+
+std::vector<uint8_t> violating_input() {
+    Simulation::FuzzInput input;
+    input.rng_seed = 1234;
+    input.nr_nodes = 7;
+    input.max_network_delay = 450;
+    input.heartbeat_interval = 70;
+    input.max_steps = 20000;
+    input.branch_step = 900;
+    input.branch_seed = 99;
+    input.normalize();
+    return input.to_bytes();
+}
+
+} // namespace
+
+TEST(ShrinkerTest, ReducesEveryParameterToTheViolationBoundary) {
+    Fuzzer::Shrinker shrinker(fake_run);
+    auto result = shrinker.shrink(violating_input());
+
+    EXPECT_EQ(result.invariant, "election_safety");
+    EXPECT_EQ(result.violation_step, 300);
+    EXPECT_EQ(result.parameters.max_steps, 300);
+    EXPECT_EQ(result.parameters.nr_nodes, 5);
+    EXPECT_EQ(result.parameters.max_network_delay, 40);
+    EXPECT_EQ(result.parameters.election_timeout_min, 50);
+    EXPECT_EQ(result.parameters.heartbeat_interval, 10);
+    EXPECT_EQ(result.parameters.branch_step, 0);
+    // The shrunk input must still reproduce on its own
+    EXPECT_TRUE(fake_run(result.input).oracle_violation);
+}
+
+TEST(ShrinkerTest, StopsAtTheExecutionBudget) {
+    Fuzzer::Shrinker shrinker(fake_run, 5);
+    auto result = shrinker.shrink(violating_input());
+    EXPECT_LE(result.executions, 5);
+    EXPECT_TRUE(fake_run(result.input).oracle_violation);
+}
+
+TEST(ShrinkerTest, RejectsInputsThatDoNotViolate) {
+    Simulation::FuzzInput input;
+    input.nr_nodes = 3;
+    Fuzzer::Shrinker shrinker(fake_run);
+    EXPECT_THROW(shrinker.shrink(input.to_bytes()), std::invalid_argument);
+}
@@ -0,0 +1,158 @@
+#include "src/io/codec.h"
+#include "src/io/messages.h"
+
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+IO::Envelope random_envelope(std::mt19937& rng, bool allow_batch = true) {
+    // Mostly small values, sometimes extreme ones, as ids and terms can be
+    auto value = [&rng]() {
+        switch (rng() % 4) {
+            case 0: return static_cast<int>(rng() % 10);
+            case 1: return static_cast<int>(rng());
+            case 2: return -static_cast<int>(rng() % 1000);
+            default: return static_cast<int>(rng() % 100000);
+        }
+    };
+    size_t type = rng() % (allow_batch ? IO::NR_MESSAGE_TYPES : IO::NR_MESSAGE_TYPES - 1);
+    IO::Envelope msg{value(), value(), value(), IO::PingRequest{}};
+    switch (type) {
+        case IO::message_type<IO::PingRequest>: break;
+        case IO::message_type<IO::PingResponse>: msg.content = IO::PingResponse{}; break;
+        case IO::message_type<IO::AppendEntriesRequest>: msg.content = IO::AppendEntriesRequest{value(), value()}; break;
+        case IO::message_type<IO::AppendEntriesResponse>: msg.content = IO::AppendEntriesResponse{value()}; break;
+        case IO::message_type<IO::RequestVoteRequest>: msg.content = IO::RequestVoteRequest{value(), value()}; break;
+        case IO::message_type<IO::RequestVoteResponse>: msg.content = IO::RequestVoteResponse{value(), rng() % 2 == 0}; break;
+        case IO::message_type<IO::HeartbeatBatch>: {
+            std::vector<IO::Envelope> batch;
+            for (size_t i = rng() % 5; i > 0; --i) {
+                batch.push_back(random_envelope(rng, false));
+            }
+            msg.content = IO::HeartbeatBatch{std::move(batch)};
+            break;
+        }
+    }
+    return msg;
+}
+
+} // namespace
+
+TEST(CodecTest, RoundTripsEveryMessageType) {
+    std::vector<IO::Envelope> messages = {
+        {0, 0, 1, IO::PingRequest{}},
+        {1, 1, 0, IO::PingResponse{}},
+        {2, 3, 4, IO::AppendEntriesRequest{7, 3}},
+        {2, 4, 3, IO::AppendEntriesResponse{8}},
+        {300, 2, 0, IO::RequestVoteRequest{9, 2}},
+        {300, 0, 2, IO::RequestVoteResponse{9, true}},
+    };
+    messages.push_back({-1, 0, 1, IO::HeartbeatBatch{{messages[2], messages[3]}}});
+    for (const auto& msg : messages) {
+        auto bytes = IO::encode(msg);
+        ASSERT_EQ(bytes.size(), IO::encoded_size(msg));
+        ASSERT_EQ(bytes[0], IO::WIRE_VERSION);
+        ASSERT_EQ(IO::decode(bytes), msg) << IO::message_name(msg.type());
+    }
+    // Small fields take one byte each: version, name, id, from, to, term, leader
+    ASSERT_EQ(IO::encode(messages[2]).size(), 7u);
+}
+
+TEST(CodecTest, ViewReadsFieldsAndBatchInPlace) {
+    IO::Envelope first{5, 3, 7, IO::AppendEntriesRequest{12, 3}};
+    IO::Envelope second{6, 8, 4, IO::AppendEntriesResponse{12}};
+    auto frame = IO::encode(IO::Envelope{-4, 0, 2, IO::HeartbeatBatch{{first, second}}});
+
+    auto view = IO::EnvelopeView::decode(frame);
+    ASSERT_EQ(view.type(), IO::message_type<IO::HeartbeatBatch>);
+    ASSERT_EQ(view.message_id(), -4);
+    ASSERT_EQ(view.batch().size(), 2u);
+    std::vector<IO::Envelope> inner;
+    for (auto entry : view.batch()) {
+        inner.push_back(entry.to_envelope());
+    }
+    ASSERT_EQ(inner, (std::vector<IO::Envelope>{first, second}));
+    auto head = *view.batch().begin();
+    ASSERT_EQ(head.term(), 12);
+    ASSERT_EQ(head.peer(), 3);
+}
+
+TEST(CodecTest, EncodesIntoCallerBuffer) {
+    IO::Envelope msg{1, 0, 2, IO::RequestVoteResponse{3, false}};
+    std::vector<uint8_t> buffer(64, 0xee);
+    size_t written = IO::encode(msg, buffer);
+    ASSERT_EQ(written, IO::encoded_size(msg));
+    ASSERT_EQ(IO::decode(std::span<const uint8_t>(buffer.data(), written)), msg);
+
+    std::vector<uint8_t> small(written - 1);
+    ASSERT_THROW(IO::encode(msg, small), IO::CodecError);
+}
+
+TEST(CodecTest, RejectsMalformedFrames) {
+    auto frame = IO::encode(IO::Envelope{1, 0, 2, IO::AppendEntriesResponse{3}});
+    auto with = [&frame](auto change) {
+        auto copy = frame;
+        change(copy);
+        return copy;
+    };
+    ASSERT_THROW(IO::decode(with([](auto& f) { f[0] = 2; })), IO::CodecError);
+    ASSERT_THROW(IO::decode(with([](auto& f) { f[1] = 42; })), IO::CodecError);
+    ASSERT_THROW(IO::decode(with([](auto& f) { f.push_back(0); })), IO::CodecError);
+    ASSERT_THROW(IO::decode(with([](auto& f) { f.pop_back(); })), IO::CodecError);
+    // The id as 0x82 0x00 is 2, but not minimally encoded
+    ASSERT_THROW(IO::decode(with([](auto& f) { f[2] = 0x82; f.insert(f.begin() + 3, 0x00); })), IO::CodecError);
+    ASSERT_THROW(IO::decode(std::vector<uint8_t>{}), IO::CodecError);
+
+    IO::Envelope inner{-1, 0, 1, IO::HeartbeatBatch{}};
+    ASSERT_THROW(IO::encode(IO::Envelope{-2, 0, 1, IO::HeartbeatBatch{{inner}}}),
+                 IO::CodecError);
+}
+
+TEST(CodecTest, RandomMessagesRoundTrip) {
+    std::mt19937 rng(1234);
+    std::vector<uint8_t> buffer(4096);
+    for (int i = 0; i < 20000; ++i) {
+        auto msg = random_envelope(rng);
+        size_t written = IO::encode(msg, buffer);
+        ASSERT_EQ(written, IO::encoded_size(msg));
+        ASSERT_EQ(IO::decode(std::span<const uint8_t>(buffer.data(), written)), msg);
+    }
+}
+
+TEST(CodecTest, CorruptedFramesFailOrDecodeCanonically) {
+    std::mt19937 rng(99);
+    int decoded = 0;
+    for (int i = 0; i < 20000; ++i) {
+        auto frame = IO::encode(random_envelope(rng));
+        switch (rng() % 3) {
+            case 0: frame[rng() % frame.size()] ^= static_cast<uint8_t>(1 + rng() % 255); break;
+            case 1: frame.resize(rng() % frame.size()); break;
+            default: frame.insert(frame.begin() + rng() % (frame.size() + 1), static_cast<uint8_t>(rng())); break;
+        }
+        IO::Envelope msg;
+        try {
+            msg = IO::decode(frame);
+        } catch (const IO::CodecError&) {
+            continue;
+        }
+        // Anything accepted is the one encoding of what it decodes to
+        ++decoded;
+        ASSERT_EQ(IO::encode(msg), frame);
+    }
+    ASSERT_GT(decoded, 0);
+}
+
+TEST(CodecTest, MessageTraitsFollowTheTypeList) {
+    static_assert(IO::NR_MESSAGE_TYPES == std::variant_size_v<IO::Message>);
+    ASSERT_EQ(IO::message_type<IO::PingRequest>, 0u);
+    ASSERT_EQ(IO::message_type<IO::HeartbeatBatch>, IO::NR_MESSAGE_TYPES - 1);
+    ASSERT_STREQ(IO::message_name(IO::message_type<IO::RequestVoteResponse>), "REQUEST_VOTE_RESPONSE");
+    ASSERT_TRUE(IO::is_request(IO::message_type<IO::AppendEntriesRequest>));
+    ASSERT_TRUE(IO::is_response(IO::message_type<IO::AppendEntriesResponse>));
+    ASSERT_FALSE(IO::is_request(IO::message_type<IO::HeartbeatBatch>));
+    ASSERT_FALSE(IO::is_response(IO::message_type<IO::HeartbeatBatch>));
+    IO::Envelope msg{7, 1, 2, IO::RequestVoteRequest{3, 1}};
+    ASSERT_EQ(msg.type(), IO::message_type<IO::RequestVoteRequest>);
+}
@@ -2,11 +2,22 @@
 #include "src/clock/clock.h"
 #include "src/rng/rng.h"
 #include "src/io/network.h"
+#include "src/io/coalescer.h"
 
 #include "gtest/gtest.h"
 #include <ranges>
 #include <stdexcept>
 
+namespace {
+
+// Every message gets the smallest delay
+class NoDelayRNG final : public RNG::RNG {
+public:
+    int draw(int lo, int) override { return lo; }
+};
+
+} // namespace
+
 TEST(IoTest, NetworkPushesAndSendsOnExpectedOrder) {
     auto clk = std::make_shared<Clock::DeterministicClock>();
 
@@ -32,21 +43,18 @@ TEST(IoTest, NetworkPushesAndSendsOnExpectedOrder) {
 
     auto msg1 = IO::Envelope{
         0,
-        IO::MessageName::PING_REQUEST,
         0,
         1,
         IO::PingRequest{}
     };
     auto msg2 = IO::Envelope{
         1,
-        IO::MessageName::PING_REQUEST,
         0,
         2,
         IO::PingResponse{}
     };
     auto msg3 = IO::Envelope{
         2,
-        IO::MessageName::PING_RESPONSE,
         2,
         0,
         IO::PingResponse{}
@@ -62,4 +70,103 @@ TEST(IoTest, NetworkPushesAndSendsOnExpectedOrder) {
     ASSERT_EQ(fetched_msgs[0], msg1); //must be first because it is on the lower timestamp and lower msg id
     ASSERT_EQ(fetched_msgs[1], msg3); // must be second because is on the lower timestamp, but higher msg id
     ASSERT_EQ(fetched_msgs[2], msg2); // must be last because is on the higher timestamp
-}
\ No newline at end of file
+}
+TEST(IoTest, CoalescerBatchesHeartbeatsPerHostPair) {
+    auto clk = std::make_shared<Clock::DeterministicClock>();
+    auto executor = std::make_shared<Executor::PriorityQueueExecutor>(clk);
+    auto network = std::make_shared<IO::Network>(clk, std::make_shared<NoDelayRNG>(), 10);
+    // Nodes 0 and 1 on host 0, nodes 2 and 3 on host 1
+    IO::HeartbeatCoalescer coalescer(network, clk, executor, {0, 0, 1, 1}, 5);
+    network->set_outbox(&coalescer);
+
+    auto heartbeat = [](int id, int from, int to) {
+        return IO::Envelope{id, from, to, IO::AppendEntriesRequest{1, from}};
+    };
+    network->push_entry(heartbeat(0, 0, 2));
+    network->push_entry(heartbeat(1, 1, 3));
+    network->push_entry(heartbeat(2, 0, 1)); // same host: not held
+    network->push_entry(IO::Envelope{3, 0, 3, IO::RequestVoteRequest{1, 0}});
+    ASSERT_EQ(network->messages_sent(), 2u);
+
+    for (int i = 0; i < 5; ++i) {
+        clk->tick();
+        executor->run_until_blocked();
+    }
+    ASSERT_EQ(network->messages_sent(), 3u);
+    ASSERT_EQ(coalescer.batches_sent(), 1u);
+    ASSERT_EQ(coalescer.heartbeats_batched(), 2u);
+
+    auto fetched = network->fetch_ready();
+    ASSERT_EQ(fetched.size(), 3u);
+    const auto& batch = fetched.back();
+    ASSERT_TRUE(std::holds_alternative<IO::HeartbeatBatch>(batch.content));
+    ASSERT_EQ(batch.from, 0);
+    ASSERT_EQ(batch.to, 1);
+    auto inner = std::get<IO::HeartbeatBatch>(batch.content).messages();
+    ASSERT_EQ(inner.size(), 2u);
+    ASSERT_EQ(inner[0], heartbeat(0, 0, 2));
+    ASSERT_EQ(inner[1], heartbeat(1, 1, 3));
+}
+TEST(IoTest, LinkModelSerializesMessagesBySize) {
+    auto clk = std::make_shared<Clock::DeterministicClock>();
+    auto network = std::make_shared<IO::Network>(clk, std::make_shared<NoDelayRNG>(), 10);
+    // 5 bytes per tick; a ping with small ids encodes to 5 bytes, plus 2 of framing
+    network->set_link_model(IO::LinkModel{5, 1, 2});
+    auto ping = [](int id, int to) { return IO::Envelope{id, 0, to, IO::PingRequest{}}; };
+    for (int id = 0; id < 3; ++id) {
+        network->push_entry(ping(id, 1));
+    }
+    network->push_entry(ping(3, 2)); // own link: not queued behind the others
+    ASSERT_EQ(network->link_backlog(0, 1), 3u);
+
+    // Last bytes leave at 7, 14 and 21 bytes (ticks 2, 3 and 5), plus 1 tick of latency
+    std::vector<std::vector<int>> arrivals;
+    for (int t = 0; t <= 6; ++t) {
+        std::vector<int> ids;
+        for (const auto& msg : network->fetch_ready()) {
+            ids.push_back(msg.message_id);
+        }
+        arrivals.push_back(ids);
+        clk->tick();
+    }
+    ASSERT_EQ(arrivals, (std::vector<std::vector<int>>{{}, {}, {}, {0, 3}, {1}, {}, {2}}));
+    ASSERT_EQ(network->link_backlog(0, 1), 0u);
+
+    auto stats = network->link_stats();
+    ASSERT_EQ(stats.size(), 2u);
+    auto& link = stats[0].to == 1 ? stats[0] : stats[1];
+    ASSERT_EQ(link.messages, 3u);
+    ASSERT_EQ(link.bytes, 21u);
+    ASSERT_DOUBLE_EQ(link.busy_ticks, 4.2);
+    ASSERT_DOUBLE_EQ(link.max_queueing_delay, 2.8);
+    ASSERT_DOUBLE_EQ(link.mean_queueing_delay(), 1.4);
+    ASSERT_DOUBLE_EQ(link.utilization(7), 0.6);
+}
+
+TEST(IoTest, FullLinksDropMessages) {
+    auto clk = std::make_shared<Clock::DeterministicClock>();
+    auto network = std::make_shared<IO::Network>(clk, std::make_shared<NoDelayRNG>(), 10);
+    // Nodes 0 and 1 share host 0: their messages to host 1 queue on one link
+    network->set_link_model(IO::LinkModel{7, 0, 0, 2}, {0, 0, 1});
+    auto ping = [](int id, int from) { return IO::Envelope{id, from, 2, IO::PingRequest{}}; };
+    network->push_entry(ping(0, 0));
+    network->push_entry(ping(1, 1));
+    network->push_entry(ping(2, 0));
+    ASSERT_EQ(network->messages_sent(), 2u);
+    ASSERT_EQ(network->messages_dropped(), 1u);
+    ASSERT_EQ(network->link_backlog(0, 1), 2u);
+    // The dropped request's RPC is lost to its caller, once
+    auto lost = network->fetch_lost();
+    ASSERT_EQ(lost.size(), 1u);
+    ASSERT_EQ(lost[0].message_id, 2);
+    ASSERT_EQ(lost[0].caller, 0);
+    ASSERT_TRUE(network->fetch_lost().empty());
+
+    clk->tick();
+    ASSERT_EQ(network->link_backlog(0, 1), 1u);
+    network->push_entry(ping(3, 1));
+    ASSERT_EQ(network->messages_sent(), 3u);
+    ASSERT_EQ(network->link_stats()[0].dropped, 1u);
+
+    ASSERT_THROW(network->set_link_model(IO::LinkModel{-1}), std::invalid_argument);
+}
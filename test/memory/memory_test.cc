@@ -0,0 +1,101 @@
+#include "src/memory/memory.h"
+#include "src/node/node.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct FakeNode {
+    int id_;
+    Node::Task loop() { co_await std::suspend_always{}; }
+    Node::Task heartbeat(int) { co_await std::suspend_always{}; }
+    Node::Task handle(IO::Envelope, IO::RequestVoteRequest) { co_return; }
+};
+
+Simulation::FuzzInput input_with_seed(uint32_t seed, int max_steps) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+} // namespace
+
+TEST(MemoryTest, FramesAreTrackedByNodeAndKind) {
+    Memory::RunMemory run;
+    FakeNode node{3};
+    {
+        Memory::ScopedRun scoped(&run);
+        node.loop().h_.resume();
+        node.heartbeat(1).h_.resume();
+        node.heartbeat(2);
+        IO::RequestVoteRequest request{};
+        node.handle(IO::Envelope{.message_id = 0, .from = 0, .to = 3, .content = request}, request).h_.resume();
+    }
+    // Outside of the run: not charged
+    auto untracked = node.loop();
+
+    EXPECT_EQ(run.live_frames(Memory::FrameKind::MainLoop), 1u);
+    EXPECT_EQ(run.live_frames(Memory::FrameKind::Heartbeat), 2u);
+    // The handler ran to completion and released its frame
+    EXPECT_EQ(run.live_frames(Memory::FrameKind::RequestVoteHandler), 0u);
+    EXPECT_GT(run.frame_bytes(), 0u);
+    EXPECT_GE(run.peak_frame_bytes(), run.frame_bytes());
+
+    Memory::Report report;
+    run.count_frames(report);
+    EXPECT_EQ(report.live_frames(), 3u);
+    EXPECT_EQ(report.leaks(), 2u);
+    ASSERT_EQ(report.frames_by_node.size(), 1u);
+    EXPECT_EQ(report.frames_by_node[0], std::make_pair(3, size_t{3}));
+
+    run.destroy_frames();
+    EXPECT_EQ(run.frame_bytes(), 0u);
+    EXPECT_EQ(run.live_frames(Memory::FrameKind::Heartbeat), 0u);
+    untracked.h_.destroy();
+}
+
+TEST(MemoryTest, FinishedRunOnlyHoldsMainLoops) {
+    Simulation::SuppressOutput suppress;
+    Simulation::StaticSimulationContext ctx(input_with_seed(7, 3000));
+    Simulation::SimulationResult result;
+    while (Simulation::advance(ctx, result)) {}
+    ASSERT_FALSE(result.oracle_violation) << result.error_message;
+
+    const auto& report = result.memory;
+    int nr_nodes = ctx.input().nr_nodes;
+    EXPECT_EQ(report.frames_by_kind[static_cast<size_t>(Memory::FrameKind::MainLoop)], static_cast<size_t>(nr_nodes));
+    // Completed RPCs are forgotten: what is left is at most one call per
+    // node still waiting on the network or the executor.
+    EXPECT_LE(report.pending_rpcs, static_cast<size_t>(nr_nodes * nr_nodes));
+    EXPECT_GT(report.usage.frames, 0u);
+    EXPECT_GE(report.peak, report.usage.frames);
+    EXPECT_NE(report.describe().find("main_loop: " + std::to_string(nr_nodes)), std::string::npos);
+}
+
+TEST(MemoryTest, BudgetStopsTheRun) {
+    Simulation::SuppressOutput suppress;
+    Simulation::StaticSimulationContext ctx(input_with_seed(7, 3000));
+    ctx.set_memory_budget(1);
+    Simulation::SimulationResult result;
+    while (Simulation::advance(ctx, result)) {}
+
+    EXPECT_TRUE(result.memory_exceeded);
+    EXPECT_FALSE(result.oracle_violation);
+    EXPECT_EQ(result.steps, 1);
+    EXPECT_NE(result.error_message.find("Memory budget of 1 bytes exceeded"), std::string::npos);
+    EXPECT_GT(result.memory.usage.total(), 1u);
+}
+
+TEST(MemoryTest, ProcessBudgetAppliesToNewRuns) {
+    Simulation::set_run_memory_budget(1);
+    auto bounded = Simulation::run_simulation(input_with_seed(7, 3000).to_bytes());
+    Simulation::set_run_memory_budget(0);
+    auto unbounded = Simulation::run_simulation(input_with_seed(7, 3000).to_bytes());
+
+    EXPECT_TRUE(bounded.memory_exceeded);
+    EXPECT_FALSE(unbounded.memory_exceeded);
+    EXPECT_EQ(unbounded.steps, 3000);
+}
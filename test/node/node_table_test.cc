@@ -0,0 +1,61 @@
+#include "src/node/node_table.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(NodeTableTest, TracksChangedRowsOnce) {
+    Node::NodeTable table(100);
+    ASSERT_EQ(table.changed().size(), 100u);
+    table.clear_changed();
+    ASSERT_TRUE(table.changed().empty());
+
+    table.set_term(42, 3);
+    table.set_role(42, Node::CANDIDATE);
+    table.set_voted_for(7, 42);
+    // Writing the current value or the heartbeat time is not a change
+    table.set_votes_received(9, 0);
+    table.set_last_heartbeat(11, 500);
+    ASSERT_EQ(table.changed(), (std::vector<int>{42, 7}));
+    ASSERT_EQ(table.voted_for(7), 42);
+    ASSERT_FALSE(table.voted_for(8).has_value());
+    ASSERT_EQ(table.last_heartbeat(11), 500);
+}
+
+TEST(NodeTableTest, DigestFollowsStateNotHistory) {
+    Node::NodeTable a(10), b(10);
+    ASSERT_EQ(a.digest(), b.digest());
+
+    a.set_term(1, 2);
+    a.set_role(1, Node::LEADER);
+    ASSERT_NE(a.digest(), b.digest());
+
+    // Same final state reached another way
+    b.set_role(1, Node::CANDIDATE);
+    b.set_role(1, Node::LEADER);
+    b.set_term(1, 5);
+    b.set_term(1, 2);
+    ASSERT_EQ(a.digest(), b.digest());
+
+    // Which row holds a state matters
+    Node::NodeTable c(10);
+    c.set_term(2, 2);
+    c.set_role(2, Node::LEADER);
+    ASSERT_NE(a.digest(), c.digest());
+}
+
+TEST(NodeTableTest, PartitionedRangesMergeInRowOrder) {
+    Node::NodeTable whole(12), split(12);
+    split.partition({0, 4, 9, 12});
+    whole.clear_changed();
+    split.clear_changed();
+    ASSERT_THROW(split.partition({0, 5, 5, 12}), std::invalid_argument);
+
+    for (int row : {10, 2, 7, 3, 10}) {
+        whole.set_term(row, row + 1);
+        split.set_term(row, row + 1);
+    }
+    // Ranges hold their changes until merged
+    ASSERT_TRUE(split.changed().empty());
+    split.merge_partitions();
+    ASSERT_EQ(split.changed(), (std::vector<int>{2, 3, 7, 10}));
+    ASSERT_EQ(split.digest(), whole.digest());
+}
@@ -10,4 +10,61 @@ TEST(SchedulerTest, AllTasksRun) {
         }
     }
 
-}
\ No newline at end of file
+}
+
+TEST(ByteStreamRNGTest, EmptyStreamMatchesSeededRNG) {
+    RNG::UniformDistributionRange seeded(7);
+    RNG::ByteStreamRNG bytes({}, 7);
+    for (int j = 0; j < 100; j++) {
+        ASSERT_EQ(seeded.draw(0, j), bytes.draw(0, j));
+    }
+}
+
+TEST(ByteStreamRNGTest, BytesDecideUntilTheyRunOut) {
+    RNG::ByteStreamRNG rng({5, 200, 0x34, 0x12}, 7);
+    EXPECT_EQ(rng.draw(0, 9), 5);
+    EXPECT_EQ(rng.draw(10, 20), 10 + 200 % 11);
+    // Ranges wider than a byte take two
+    EXPECT_EQ(rng.draw(0, 59999), 0x1234);
+    EXPECT_EQ(rng.remaining(), 0u);
+
+    RNG::UniformDistributionRange seeded(7);
+    for (int j = 0; j < 10; j++) {
+        ASSERT_EQ(rng.draw(0, 1000), seeded.draw(0, 1000));
+    }
+}
+
+TEST(ByteStreamRNGTest, ChangingOneByteChangesOneDecision) {
+    std::vector<uint8_t> stream = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto changed = stream;
+    changed[3] ^= 1;
+    RNG::ByteStreamRNG a(stream, 1), b(changed, 1);
+    for (int j = 0; j < 20; j++) {
+        int x = a.draw(0, 100), y = b.draw(0, 100);
+        if (j == 3) {
+            ASSERT_NE(x, y);
+        } else {
+            ASSERT_EQ(x, y);
+        }
+    }
+}
+
+TEST(SplitMixRNGTest, DrawsStayInRangeAndReplay) {
+    RNG::SplitMixRNG rng(42);
+    std::vector<int> hits(11, 0);
+    std::vector<int> drawn;
+    for (int j = 0; j < 11000; j++) {
+        int value = rng.draw(-5, 5);
+        ASSERT_GE(value, -5);
+        ASSERT_LE(value, 5);
+        ++hits[value + 5];
+        drawn.push_back(value);
+    }
+    for (int count : hits) {
+        EXPECT_GT(count, 800);
+    }
+    rng.reseed(42);
+    for (int value : drawn) {
+        ASSERT_EQ(rng.draw(-5, 5), value);
+    }
+}
@@ -38,7 +38,6 @@ TEST(RouterTest, RouterSendsMessagesToInboxAndSchedulesDispatch) {
 
     auto msg1 = IO::Envelope{
         .message_id = 0,
-        .name = IO::MessageName::PING_REQUEST,
         .from = 0,
         .to = 1,
         .content = IO::PingRequest{},
@@ -47,7 +46,6 @@ TEST(RouterTest, RouterSendsMessagesToInboxAndSchedulesDispatch) {
 
     auto msg2 = IO::Envelope{
         .message_id = 1,
-        .name = IO::MessageName::PING_RESPONSE,
         .from = 1,
         .to = 0,
         .content = IO::PingResponse{},
@@ -0,0 +1,264 @@
+#include "src/runtime/event_loop.h"
+#include "src/runtime/raft_process.h"
+#include "src/runtime/tcp_network.h"
+#include "src/io/codec.h"
+#include "src/log/log.h"
+
+#include "gtest/gtest.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Polls until done() holds or timeout_ms pass; returns done().
+template<typename Poll, typename Done>
+bool poll_until(Poll poll, Done done, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        poll();
+    }
+    return done();
+}
+
+// A blocking connection to port on localhost, as a peer that frames its
+// own messages would open.
+int connect_raw(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    return fd;
+}
+
+void send_frame(int fd, const IO::Envelope& msg) {
+    auto bytes = IO::encode(msg);
+    uint32_t length = htonl(static_cast<uint32_t>(bytes.size()));
+    std::vector<uint8_t> frame(sizeof(length));
+    std::memcpy(frame.data(), &length, sizeof(length));
+    frame.insert(frame.end(), bytes.begin(), bytes.end());
+    ASSERT_EQ(send(fd, frame.data(), frame.size(), MSG_NOSIGNAL), static_cast<ssize_t>(frame.size()));
+}
+
+} // namespace
+
+TEST(RuntimeTest, EventLoopRunsTimersInDueOrder) {
+    Runtime::EventLoop loop;
+    std::vector<int> fired;
+    auto start = std::chrono::steady_clock::now();
+    loop.call_after(30, [&fired]() { fired.push_back(2); });
+    loop.call_after(5, [&fired]() { fired.push_back(1); });
+    ASSERT_TRUE(poll_until([&loop]() { loop.poll(-1); }, [&fired]() { return fired.size() == 2; }, 2000));
+    ASSERT_EQ(fired, (std::vector<int>{1, 2}));
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+}
+
+TEST(RuntimeTest, TcpNetworkDeliversFramedMessagesInOrder) {
+    Runtime::EventLoop loop;
+    std::vector<Runtime::Endpoint> peers;
+    std::vector<int> listeners;
+    for (int i = 0; i < 2; ++i) {
+        listeners.push_back(Runtime::open_listener({"127.0.0.1", 0}));
+        peers.push_back({"127.0.0.1", Runtime::bound_port(listeners.back())});
+    }
+    Runtime::TcpNetwork a(loop, 0, peers, listeners[0]);
+    Runtime::TcpNetwork b(loop, 1, peers, listeners[1]);
+
+    std::vector<IO::Envelope> sent;
+    for (int i = 0; i < 500; ++i) {
+        sent.push_back({i, 0, 1, IO::AppendEntriesRequest{i * 1000, 0}});
+        a.push_entry(sent.back());
+    }
+    std::vector<IO::Envelope> received;
+    ASSERT_TRUE(poll_until([&]() {
+        loop.poll(10);
+        for (auto& msg : b.fetch_ready()) {
+            received.push_back(msg);
+        }
+    }, [&]() { return received.size() == sent.size(); }, 5000));
+    ASSERT_EQ(received, sent);
+
+    // The response finds its request and times the round trip
+    b.push_entry({7, 1, 0, IO::AppendEntriesResponse{7000}});
+    ASSERT_TRUE(poll_until([&]() { loop.poll(10); }, [&]() { return a.has_messages(); }, 5000));
+    ASSERT_EQ(a.fetch_ready()[0].message_id, 7);
+    ASSERT_EQ(a.rpc_latencies_us().size(), 1u);
+    ASSERT_EQ(a.messages_sent(), 500u);
+    ASSERT_EQ(b.messages_received(), 500u);
+}
+
+TEST(RuntimeTest, TcpNetworkWaitsForPeersToComeUp) {
+    Runtime::EventLoop loop;
+    int listener = Runtime::open_listener({"127.0.0.1", 0});
+    // A free port nobody listens on yet
+    int reserved = Runtime::open_listener({"127.0.0.1", 0});
+    int late_port = Runtime::bound_port(reserved);
+    close(reserved);
+    std::vector<Runtime::Endpoint> peers = {{"127.0.0.1", Runtime::bound_port(listener)}, {"127.0.0.1", late_port}};
+    Runtime::TcpNetwork a(loop, 0, peers, listener);
+    a.push_entry({1, 0, 1, IO::PingRequest{}});
+    // Connecting is refused and retried
+    poll_until([&]() { loop.poll(5); }, []() { return false; }, 50);
+
+    Runtime::TcpNetwork b(loop, 1, peers);
+    std::vector<IO::Envelope> received;
+    ASSERT_TRUE(poll_until([&]() {
+        loop.poll(5);
+        for (auto& msg : b.fetch_ready()) {
+            received.push_back(msg);
+        }
+    }, [&]() { return !received.empty(); }, 5000));
+    ASSERT_EQ(received[0], (IO::Envelope{1, 0, 1, IO::PingRequest{}}));
+}
+
+TEST(RuntimeTest, TcpNetworkBoundsWhatAPeerThatStaysDownHolds) {
+    Runtime::EventLoop loop;
+    int listener = Runtime::open_listener({"127.0.0.1", 0});
+    int reserved = Runtime::open_listener({"127.0.0.1", 0});
+    int dead_port = Runtime::bound_port(reserved);
+    close(reserved);
+    std::vector<Runtime::Endpoint> peers = {{"127.0.0.1", Runtime::bound_port(listener)}, {"127.0.0.1", dead_port}};
+    Runtime::TcpNetwork a(loop, 0, peers, listener);
+
+    const int overflow = 10;
+    const int sent = static_cast<int>(Runtime::TcpNetwork::MAX_QUEUED_FRAMES) + overflow;
+    for (int i = 0; i < sent; ++i) {
+        a.push_entry({i, 0, 1, IO::RequestVoteRequest{1, 0}});
+    }
+    // The oldest requests make room for the newest
+    ASSERT_EQ(a.queued_frames(1), Runtime::TcpNetwork::MAX_QUEUED_FRAMES);
+    auto lost = a.fetch_lost();
+    ASSERT_EQ(lost.size(), static_cast<size_t>(overflow));
+    ASSERT_EQ(lost[0].message_id, 0);
+    ASSERT_EQ(lost[0].caller, 0);
+
+    // The rest time out, and a failed reconnect drops their stale frames
+    ASSERT_TRUE(poll_until([&]() {
+        loop.poll(10);
+        auto more = a.fetch_lost();
+        lost.insert(lost.end(), more.begin(), more.end());
+    }, [&]() { return lost.size() == static_cast<size_t>(sent) && a.queued_frames(1) == 0; },
+                           Runtime::TcpNetwork::RPC_TIMEOUT_MS + 2000));
+    ASSERT_EQ(a.pending_requests(), 0u);
+
+    // A response to a request given up on is dropped
+    int fd = connect_raw(a.port());
+    send_frame(fd, IO::Envelope{sent - 1, 1, 0, IO::RequestVoteResponse{1, true}});
+    ASSERT_TRUE(poll_until([&]() { loop.poll(5); }, [&]() { return a.late_responses() == 1; }, 5000));
+    ASSERT_FALSE(a.has_messages());
+    close(fd);
+}
+
+TEST(RuntimeTest, TcpNetworkDropsMisaddressedFrames) {
+    Log::ScopedSink quiet(Log::null_stream());
+    Runtime::EventLoop loop;
+    int listener = Runtime::open_listener({"127.0.0.1", 0});
+    std::vector<Runtime::Endpoint> peers = {{"127.0.0.1", 0}, {"127.0.0.1", Runtime::bound_port(listener)}};
+    Runtime::TcpNetwork b(loop, 1, peers, listener);
+
+    // For another node, for a node that does not exist, in a batch for this node
+    std::vector<IO::Envelope> misaddressed = {
+        {1, 0, 0, IO::PingRequest{}},
+        {2, 0, 7, IO::PingRequest{}},
+        {-1, 0, 1, IO::HeartbeatBatch{{IO::Envelope{3, 0, 2, IO::AppendEntriesRequest{1, 0}}}}},
+    };
+    for (const auto& msg : misaddressed) {
+        int fd = connect_raw(b.port());
+        send_frame(fd, msg);
+        uint8_t byte;
+        // The connection is closed on it
+        ASSERT_TRUE(poll_until([&]() { loop.poll(5); }, [&]() { return recv(fd, &byte, 1, MSG_DONTWAIT) == 0; },
+                               5000));
+        close(fd);
+    }
+    ASSERT_EQ(b.misaddressed_frames(), misaddressed.size());
+    ASSERT_FALSE(b.has_messages());
+
+    int fd = connect_raw(b.port());
+    send_frame(fd, IO::Envelope{4, 0, 1, IO::PingRequest{}});
+    ASSERT_TRUE(poll_until([&]() { loop.poll(5); }, [&]() { return b.has_messages(); }, 5000));
+    ASSERT_EQ(b.fetch_ready()[0].message_id, 4);
+    close(fd);
+}
+
+TEST(RuntimeTest, ProcessesElectOneLeaderOverTcp) {
+    Log::ScopedSink quiet(Log::null_stream());
+    std::vector<Runtime::Endpoint> peers;
+    std::vector<int> listeners;
+    for (int i = 0; i < 3; ++i) {
+        listeners.push_back(Runtime::open_listener({"127.0.0.1", 0}));
+        peers.push_back({"127.0.0.1", Runtime::bound_port(listeners.back())});
+    }
+    std::vector<std::unique_ptr<Runtime::RaftProcess>> processes;
+    for (int i = 0; i < 3; ++i) {
+        Runtime::ProcessOptions options;
+        options.id = i;
+        options.peers = peers;
+        options.election_timeout_min = 50;
+        options.election_timeout_max = 100;
+        options.heartbeat_interval = 10;
+        options.seed = i + 1;
+        options.listen_fd = listeners[i];
+        processes.push_back(std::make_unique<Runtime::RaftProcess>(options));
+    }
+    auto poll_all = [&processes]() {
+        for (auto& process : processes) {
+            process->poll(1);
+        }
+    };
+    auto leaders = [&processes]() {
+        int count = 0;
+        for (auto& process : processes) {
+            count += process->node().get_state() == Node::LEADER;
+        }
+        return count;
+    };
+    ASSERT_TRUE(poll_until(poll_all, [&]() { return leaders() == 1; }, 10000));
+
+    // A few heartbeat rounds later everyone follows the leader's term
+    poll_until(poll_all, []() { return false; }, 200);
+    ASSERT_EQ(leaders(), 1);
+    for (auto& process : processes) {
+        ASSERT_EQ(process->node().get_term(), processes[0]->node().get_term());
+        if (process->node().get_state() == Node::LEADER) {
+            ASSERT_GT(process->network().rpc_latencies_us().size(), 0u);
+        }
+    }
+}
+
+TEST(RuntimeTest, CandidateKeepsElectingWhenPeersDieMidElection) {
+    Log::ScopedSink quiet(Log::null_stream());
+    std::vector<Runtime::Endpoint> peers;
+    std::vector<int> listeners;
+    for (int i = 0; i < 3; ++i) {
+        listeners.push_back(Runtime::open_listener({"127.0.0.1", 0}));
+        peers.push_back({"127.0.0.1", Runtime::bound_port(listeners.back())});
+    }
+    Runtime::ProcessOptions options;
+    options.id = 0;
+    options.peers = peers;
+    options.election_timeout_min = 20;
+    options.election_timeout_max = 40;
+    options.heartbeat_interval = 10;
+    options.listen_fd = listeners[0];
+    Runtime::RaftProcess candidate(options);
+
+    // Peers 1 and 2 take the first vote requests in, then die without answering
+    auto poll = [&candidate]() { candidate.poll(1); };
+    ASSERT_TRUE(poll_until(poll, [&]() { return candidate.network().bytes_sent() > 0; }, 5000));
+    poll_until(poll, []() { return false; }, 20);
+    for (int i = 1; i < 3; ++i) {
+        close(listeners[i]);
+    }
+    // The lost votes do not hold the candidate: it times out into new elections
+    int first_term = candidate.node().get_term();
+    ASSERT_TRUE(poll_until(poll, [&]() { return candidate.node().get_term() >= first_term + 2; }, 5000));
+    ASSERT_EQ(candidate.node().get_state(), Node::CANDIDATE);
+}
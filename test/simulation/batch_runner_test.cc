@@ -0,0 +1,115 @@
+#include "src/simulation/batch_runner.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/simulation/simulation_harness.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+class CollectingWriter : public Simulation::SummaryWriter {
+public:
+    std::vector<Simulation::RunSummary> summaries;
+    void write(const Simulation::RunSummary& summary) override { summaries.push_back(summary); }
+
+    // By index, without timings, so batches can be compared
+    std::vector<Simulation::RunSummary> sorted() const {
+        auto result = summaries;
+        for (auto& summary : result) {
+            summary.wall_ms = 0;
+        }
+        std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.index < b.index; });
+        return result;
+    }
+};
+
+} // namespace
+
+TEST(BatchRunnerTest, ThreadCountDoesNotChangeResults) {
+    auto input_at = [](size_t index) { return Simulation::input_for_seed(100 + index, 300); };
+    CollectingWriter serial, parallel;
+    auto serial_stats = Simulation::run_batch(8, input_at, serial, {.threads = 1});
+    auto parallel_stats = Simulation::run_batch(8, input_at, parallel, {.threads = 4});
+
+    ASSERT_EQ(serial_stats.runs, 8u);
+    ASSERT_EQ(parallel_stats.threads, 4);
+    ASSERT_EQ(serial_stats.violations, parallel_stats.violations);
+    auto summaries = serial.sorted();
+    ASSERT_EQ(summaries, parallel.sorted());
+    for (size_t i = 0; i < 8; ++i) {
+        const auto& summary = summaries[i];
+        ASSERT_EQ(summary.index, i);
+        ASSERT_EQ(summary.seed, 100 + i);
+        ASSERT_GT(summary.states, 0u);
+        ASSERT_EQ(summary.steps, 300);
+    }
+}
+
+TEST(BatchRunnerTest, SummaryMatchesASingleRun) {
+    auto input = Simulation::input_for_seed(7, 500);
+    CollectingWriter writer;
+    Simulation::run_batch(1, [&](size_t) { return input; }, writer);
+    auto result = Simulation::run_simulation(input.to_bytes());
+
+    ASSERT_EQ(writer.summaries.size(), 1u);
+    ASSERT_EQ(writer.summaries[0].violation, result.oracle_violation);
+    ASSERT_EQ(writer.summaries[0].steps, result.steps);
+    ASSERT_EQ(writer.summaries[0].states, result.coverage.count());
+}
+
+TEST(BatchRunnerTest, BinarySummariesRoundTrip) {
+    std::stringstream stream;
+    Simulation::BinarySummaryWriter writer(stream);
+    Simulation::RunSummary first{0, 42, false, 1000, 17, 1.5, ""};
+    Simulation::RunSummary second{1, 43, true, 212, 9, 0.25, "Election Safety"};
+    writer.write(first);
+    writer.write(second);
+    // A torn third record is dropped
+    stream << std::string(5, '\x01');
+
+    auto summaries = Simulation::read_binary_summaries(stream);
+    ASSERT_EQ(summaries.size(), 2u);
+    ASSERT_EQ(summaries[0], first);
+    ASSERT_EQ(summaries[1], second);
+
+    std::stringstream bad("RCORPUS1");
+    ASSERT_THROW(Simulation::read_binary_summaries(bad), std::runtime_error);
+}
+
+TEST(BatchRunnerTest, CsvQuotesInvariants) {
+    std::stringstream stream;
+    Simulation::CsvSummaryWriter writer(stream);
+    writer.write(Simulation::RunSummary{3, 9, true, 10, 2, 0.5, "term \"N\" regressed"});
+    ASSERT_EQ(stream.str(), "index,seed,violation,steps,states,wall_ms,invariant\n"
+                            "3,9,1,10,2,0.500,\"term \"\"N\"\" regressed\"\n");
+}
+
+TEST(BatchRunnerTest, ReadsHexInputsSkippingComments) {
+    auto a = Simulation::input_for_seed(1, 200);
+    auto b = Simulation::input_for_seed(2, 300);
+    std::stringstream file("# corpus\n" + Simulation::to_hex(a.to_bytes()) + "\n\n  " +
+                           Simulation::to_hex(b.to_bytes()) + "\r\n");
+    auto inputs = Simulation::read_inputs(file);
+    ASSERT_EQ(inputs.size(), 2u);
+    ASSERT_EQ(inputs[0].to_bytes(), a.to_bytes());
+    ASSERT_EQ(inputs[1].to_bytes(), b.to_bytes());
+
+    std::stringstream bad("zz\n");
+    ASSERT_THROW(Simulation::read_inputs(bad), std::invalid_argument);
+}
+
+TEST(BatchRunnerTest, KeepsOneLogPerRun) {
+    auto dir = std::filesystem::temp_directory_path() / ("batch_logs_" + std::to_string(getpid()));
+    CollectingWriter writer;
+    Simulation::run_batch(3, [](size_t index) { return Simulation::input_for_seed(index, 100); }, writer,
+                          {.threads = 2, .log_dir = dir.string()});
+    for (int i = 0; i < 3; ++i) {
+        auto log = dir / ("run_" + std::to_string(i) + ".log");
+        ASSERT_TRUE(std::filesystem::exists(log));
+        ASSERT_GT(std::filesystem::file_size(log), 0u);
+    }
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,75 @@
+#include "src/simulation/fork_server.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include "gtest/gtest.h"
+
+TEST(ForkServerTest, BranchesMatchReplayFromScratch) {
+    Simulation::FuzzInput input;
+    input.rng_seed = 7;
+    input.max_steps = 2000;
+
+    Simulation::CheckpointPolicy policy;
+    policy.step = 1000;
+    Simulation::ForkServer server(input.to_bytes(), policy);
+    ASSERT_TRUE(server.reach_checkpoint());
+    ASSERT_EQ(server.checkpoint_step(), 1000);
+
+    for (uint32_t branch_seed = 1; branch_seed <= 3; branch_seed++) {
+        auto forked = server.branch(branch_seed);
+        auto replayed = Simulation::run_simulation(server.branch_input(branch_seed));
+        ASSERT_EQ(forked.oracle_violation, replayed.oracle_violation);
+        ASSERT_TRUE(forked.coverage == replayed.coverage);
+        ASSERT_EQ(forked.proximity, replayed.proximity);
+    }
+}
+
+TEST(ForkServerTest, DefaultPolicyBranchesReplay) {
+    Simulation::FuzzInput input;
+    input.rng_seed = 7;
+    input.max_steps = 300;
+
+    // Step 0 cannot be named by an input: the first checkpoint is after step 1
+    Simulation::ForkServer server(input.to_bytes(), Simulation::CheckpointPolicy{});
+    ASSERT_TRUE(server.reach_checkpoint());
+    ASSERT_EQ(server.checkpoint_step(), 1);
+
+    for (uint32_t branch_seed = 1; branch_seed <= 3; branch_seed++) {
+        auto forked = server.branch(branch_seed);
+        auto replayed = Simulation::run_simulation(server.branch_input(branch_seed));
+        ASSERT_TRUE(forked.coverage == replayed.coverage);
+        ASSERT_EQ(forked.proximity, replayed.proximity);
+    }
+}
+
+TEST(ForkServerTest, BranchesKeepTheDecisionStream) {
+    Simulation::FuzzInput input;
+    input.rng_seed = 7;
+    input.max_steps = 2000;
+    for (int i = 0; i < 512; i++) {
+        input.decisions.push_back(static_cast<uint8_t>(i * 37));
+    }
+
+    Simulation::CheckpointPolicy policy;
+    policy.step = 500;
+    Simulation::ForkServer server(input.to_bytes(), policy);
+    ASSERT_TRUE(server.reach_checkpoint());
+
+    auto forked = server.branch(3);
+    auto replayed = Simulation::run_simulation(server.branch_input(3));
+    ASSERT_TRUE(forked.coverage == replayed.coverage);
+}
+
+TEST(ForkServerTest, NewStateCheckpointSkipsKnownStates) {
+    Simulation::FuzzInput input;
+    input.rng_seed = 7;
+    input.max_steps = 2000;
+
+    Coverage::GlobalCoverage known;
+    known.merge(Simulation::run_simulation(input.to_bytes()).coverage);
+
+    Simulation::CheckpointPolicy policy;
+    policy.on_new_state = true;
+    Simulation::ForkServer server(input.to_bytes(), policy);
+    // The unbranched trunk never leaves the states it already covered.
+    ASSERT_FALSE(server.reach_checkpoint(&known));
+}
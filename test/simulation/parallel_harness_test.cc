@@ -0,0 +1,95 @@
+#include "src/simulation/parallel_harness.h"
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/node/node.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+Simulation::FuzzInput input_with_seed(uint32_t seed, int max_steps) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+struct Outcome {
+    std::vector<size_t> hashes;
+    size_t tasks_run = 0;
+    size_t messages_sent = 0;
+    int leaders = 0;
+
+    bool operator==(const Outcome& other) const = default;
+};
+
+Outcome run_to_end(const Simulation::FuzzInput& input, Simulation::Topology topology, Simulation::ParallelOptions options) {
+    Simulation::ParallelSimulationContext ctx(input, topology, options);
+    Outcome result;
+    while (!ctx.done()) {
+        result.hashes.push_back(ctx.step());
+    }
+    result.tasks_run = ctx.tasks_run();
+    result.messages_sent = ctx.messages_sent();
+    for (int row = 0; row < ctx.table().size(); ++row) {
+        result.leaders += ctx.table().role(row) == Node::LEADER;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(ParallelHarnessTest, SameRunWhateverTheThreadsAndPartitions) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(11, 2000);
+    Simulation::Topology topology{300, 5};
+    Outcome serial = run_to_end(input, topology, {1, 1});
+    ASSERT_EQ(serial.hashes.size(), 2000u);
+    ASSERT_GT(serial.leaders, 0);
+    for (auto options : {Simulation::ParallelOptions{1, 7}, Simulation::ParallelOptions{2, 2},
+                         Simulation::ParallelOptions{4, 9}}) {
+        ASSERT_EQ(run_to_end(input, topology, options), serial) << options.threads << " threads, " << options.partitions
+                                                         << " partitions";
+    }
+}
+
+TEST(ParallelHarnessTest, GroupSplitAcrossPartitionsKeepsElectionSafety) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(3, 10000);
+    // One node per partition: every message crosses partitions
+    Simulation::ParallelSimulationContext ctx(input, {}, {3, 5});
+    ASSERT_EQ(ctx.partitions(), 5);
+    ASSERT_EQ(ctx.threads(), 3);
+    Simulation::SimulationResult result;
+    while (Simulation::advance(ctx, result)) {}
+    ASSERT_FALSE(result.oracle_violation) << result.error_message;
+    ASSERT_EQ(result.steps, 10000);
+    ASSERT_GT(ctx.messages_sent(), 0u);
+    int leaders = 0;
+    for (int row = 0; row < 5; ++row) {
+        leaders += ctx.table().role(row) == Node::LEADER;
+    }
+    ASSERT_LE(leaders, 1);
+    ASSERT_EQ(result.memory.frames_by_kind[static_cast<size_t>(Memory::FrameKind::MainLoop)], 5u);
+    ASSERT_EQ(run_to_end(input, {}, {1, 1}), run_to_end(input, {}, {3, 5}));
+}
+
+TEST(ParallelHarnessTest, LinkLatencyWidensTheWindow) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(5, 100);
+    Simulation::Topology topology{20, 5};
+    topology.links.base_latency = 4;
+    Simulation::ParallelSimulationContext ctx(input, topology, {2, 4});
+    ASSERT_EQ(ctx.lookahead(), 4);
+    ctx.step();
+    ASSERT_EQ(ctx.steps(), 4);
+    ASSERT_EQ(run_to_end(input, topology, {1, 1}), run_to_end(input, topology, {2, 4}));
+
+    Simulation::Topology hosts{20, 5, 5};
+    ASSERT_THROW(Simulation::ParallelSimulationContext(input, hosts), std::invalid_argument);
+    Simulation::Topology shaped{20, 5};
+    shaped.links.bandwidth = 100;
+    ASSERT_THROW(Simulation::ParallelSimulationContext(input, shaped), std::invalid_argument);
+}
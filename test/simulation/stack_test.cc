@@ -0,0 +1,55 @@
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/trace/event.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+Simulation::FuzzInput input_with_seed(uint32_t seed, int max_steps) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+template<typename Context>
+std::vector<size_t> step_hashes(const Simulation::FuzzInput& input, Simulation::Topology topology = {}) {
+    Simulation::SuppressOutput suppress;
+    Context ctx(input, nullptr, topology);
+    std::vector<size_t> hashes;
+    while (!ctx.done()) {
+        hashes.push_back(ctx.step());
+    }
+    return hashes;
+}
+
+} // namespace
+
+TEST(StackTest, StaticStackRunsTheSameSimulation) {
+    for (uint32_t seed : {1u, 7u, 400u}) {
+        auto input = input_with_seed(seed, 1500);
+        input.decisions = {3, 1, 4, 1, 5, 9, 2, 6};
+        auto expected = step_hashes<Simulation::SimulationContext>(input);
+        ASSERT_EQ(expected.size(), 1500u);
+        ASSERT_EQ(step_hashes<Simulation::StaticSimulationContext>(input), expected) << "seed " << seed;
+    }
+}
+
+TEST(StackTest, StaticStackRunsTheSameFleet) {
+    auto input = input_with_seed(5, 800);
+    Simulation::Topology topology{60, 3, 6, true};
+    ASSERT_EQ(step_hashes<Simulation::StaticSimulationContext>(input, topology),
+              step_hashes<Simulation::SimulationContext>(input, topology));
+}
+
+TEST(StackTest, StaticStackRefusesToTrace) {
+    Simulation::SuppressOutput suppress;
+    class NullSink : public Trace::EventSink {
+    public:
+        void on_event(const Trace::Event&) override {}
+    } sink;
+    ASSERT_THROW(Simulation::StaticSimulationContext(input_with_seed(5, 100), &sink), std::invalid_argument);
+}
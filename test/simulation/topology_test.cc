@@ -0,0 +1,112 @@
+#include "src/simulation/simulation_harness.h"
+#include "src/simulation/fuzz_input.h"
+#include "src/node/node.h"
+#include "src/node/state.h"
+#include "src/trace/event.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+Simulation::FuzzInput input_with_seed(uint32_t seed, int max_steps) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = max_steps;
+    input.normalize();
+    return input;
+}
+
+} // namespace
+
+// Remembers which groups ever had a leader.
+class LeaderSink : public Trace::EventSink {
+public:
+    std::set<int64_t> groups;
+    void on_event(const Trace::Event& event) override {
+        if (event.kind == Trace::EventKind::NodeState && event.b == Node::LEADER) {
+            groups.insert(event.a / 5);
+        }
+    }
+};
+
+TEST(TopologyTest, GroupsElectLeadersIndependently) {
+    Simulation::SuppressOutput suppress;
+    LeaderSink sink;
+    Simulation::SimulationContext ctx(input_with_seed(5, 2000), &sink, Simulation::Topology{300, 5});
+    Simulation::SimulationResult result;
+    while (Simulation::advance(ctx, result)) {}
+    ASSERT_FALSE(result.oracle_violation) << result.error_message;
+    ASSERT_EQ(result.steps, 2000);
+
+    // Every group holds its own elections, so terms drift apart between groups
+    ASSERT_GT(sink.groups.size(), 10u);
+    std::set<int> terms;
+    for (const auto& node : ctx.nodes()) {
+        terms.insert(node->get_term());
+    }
+    ASSERT_GT(terms.size(), 1u);
+    ASSERT_EQ(ctx.state_hash(), ctx.table().digest());
+}
+
+TEST(TopologyTest, SmallClustersKeepTheirStateHash) {
+    Simulation::SuppressOutput suppress;
+    Simulation::SimulationContext ctx(input_with_seed(5, 300));
+    while (!ctx.done()) {
+        ctx.step();
+    }
+    ASSERT_EQ(ctx.state_hash(), State::ClusterState::capture(ctx.nodes()).hash());
+}
+
+TEST(TopologyTest, RejectsGroupsTooSmallOrUneven) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(5, 300);
+    ASSERT_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{100, 2}), std::invalid_argument);
+    ASSERT_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{100, 7}), std::invalid_argument);
+    ASSERT_NO_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{100, 5}));
+}
+
+TEST(TopologyTest, CoalescingHeartbeatsSendsFewerMessages) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(5, 1500);
+    size_t sent[2];
+    for (bool coalesce : {false, true}) {
+        Simulation::Topology topology{300, 3, 10, coalesce};
+        Simulation::SimulationContext ctx(input, nullptr, topology);
+        Simulation::SimulationResult result;
+        while (Simulation::advance(ctx, result)) {}
+        ASSERT_FALSE(result.oracle_violation) << result.error_message;
+        ASSERT_EQ(ctx.coalescer() != nullptr, coalesce);
+        sent[coalesce] = ctx.network().messages_sent();
+        if (coalesce) {
+            ASSERT_GT(ctx.coalescer()->heartbeats_batched(), ctx.coalescer()->batches_sent());
+        }
+    }
+    ASSERT_LT(sent[1], sent[0]);
+}
+
+TEST(TopologyTest, RejectsTooFewHosts) {
+    Simulation::SuppressOutput suppress;
+    auto input = input_with_seed(5, 300);
+    ASSERT_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{30, 5, 4}), std::invalid_argument);
+    ASSERT_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{30, 5, 0, true}),
+                 std::invalid_argument);
+    ASSERT_NO_THROW(Simulation::SimulationContext(input, nullptr, Simulation::Topology{30, 5, 5, true}));
+}
+
+TEST(TopologyTest, DroppedMessagesFailTheirRpcs) {
+    Simulation::SuppressOutput suppress;
+    Simulation::Topology topology;
+    // A byte per tick, 200 bytes of framing and one message per link: most
+    // of the traffic is dropped
+    topology.links = IO::LinkModel{1, 0, 200, 1};
+    Simulation::SimulationContext ctx(input_with_seed(5, 6000), nullptr, topology);
+    Simulation::SimulationResult result;
+    while (Simulation::advance(ctx, result)) {}
+    ASSERT_FALSE(result.oracle_violation) << result.error_message;
+    size_t dropped = ctx.network().messages_dropped();
+    ASSERT_GT(dropped, 200u);
+    // The caller of each lost RPC resumed and finished instead of waiting
+    // forever: only RPCs still in flight are pending
+    ASSERT_LT(ctx.memory_report().pending_rpcs, dropped / 4);
+}
@@ -8,6 +8,7 @@
 #include "gtest/gtest.h"
 #include <coroutine>
 #include <memory>
+#include <optional>
 #include <variant>
 
 template<typename T>
@@ -29,12 +30,10 @@ public:
     ~Task() { if (h) h.destroy(); }
 };
 
-Task<IO::Envelope> publish_to_system(std::shared_ptr<System::System> sys) {
+Task<std::optional<IO::Envelope>> publish_to_system(std::shared_ptr<System::System> sys) {
     int from = 0;
     int to = 1;
-    IO::MessageName name = IO::MessageName::PING_REQUEST;
-    IO::Message content = IO::PingRequest{};
-    IO::Envelope response = co_await sys->rpc(from, to, name, content);
+    std::optional<IO::Envelope> response = co_await sys->rpc(from, to, IO::PingRequest{});
     co_return response;
 }
 
@@ -56,7 +55,6 @@ TEST(SystemTest, RPCPublishesToNetworkAndResumesCaller) {
     auto result = IO::PingResponse{};
     auto response = IO::Envelope{
         0,
-        IO::MessageName::PING_RESPONSE,
         1,
         0,
         result
@@ -70,7 +68,6 @@ TEST(SystemTest, RPCPublishesToNetworkAndResumesCaller) {
     ASSERT_EQ(response, caller_coro.h.promise().result);
     auto expected_envelope = IO::Envelope{
         .message_id = 0,
-        .name = IO::MessageName::PING_REQUEST,
         .from = 0,
         .to = 1,
         .content = IO::PingRequest{}
@@ -78,4 +75,27 @@ TEST(SystemTest, RPCPublishesToNetworkAndResumesCaller) {
     auto network_items = network->fetch_ready();
     ASSERT_EQ(network_items.size(), 1);
     ASSERT_EQ(network_items[0], expected_envelope);
-}
\ No newline at end of file
+}
+TEST(SystemTest, FailedRPCResumesCallerWithoutResponse) {
+    auto rng = std::make_shared<RNG::UniformDistributionRange>(400);
+    auto clock = std::make_shared<Clock::DeterministicClock>();
+    auto network = std::make_shared<IO::Network>(clock, rng, 0);
+    auto executor = std::make_shared<Executor::PriorityQueueExecutor>(clock);
+    auto scheduler = std::make_shared<Scheduler::DeterministicScheduler>(executor, rng, clock, 0);
+    auto system = std::make_shared<System::System>(scheduler, clock, rng, network);
+
+    auto caller_coro = publish_to_system(system);
+    caller_coro.h.resume();
+    system->fail_rpc(0, 0);
+    // Over already: a late response or a second failure must not resume it again
+    system->fail_rpc(0, 0);
+    while(executor->has_work()) {
+        clock->tick();
+        executor->run_until_blocked();
+    }
+    ASSERT_TRUE(caller_coro.h.done());
+    ASSERT_FALSE(caller_coro.h.promise().result.has_value());
+    ASSERT_TRUE(system->suspended_rpcs.empty());
+    ASSERT_TRUE(system->responses.empty());
+    ASSERT_THROW(system->register_rpc_completion(0, IO::Envelope{0, 1, 0, IO::PingResponse{}}), std::runtime_error);
+}
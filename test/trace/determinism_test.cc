@@ -0,0 +1,57 @@
+#include "src/trace/determinism.h"
+#include "src/simulation/fuzz_input.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+
+namespace {
+
+std::vector<uint8_t> input_with_seed(uint32_t seed) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = 400;
+    return input.to_bytes();
+}
+
+} // namespace
+
+TEST(DeterminismTest, RepeatedRunsAgreeAcrossThreads) {
+    auto report = Trace::check_determinism(input_with_seed(11), 6, 3);
+    ASSERT_TRUE(report.deterministic());
+    ASSERT_EQ(report.runs, 6);
+    ASSERT_EQ(report.steps, 400);
+    ASSERT_GT(report.events, 400u);
+    ASSERT_EQ(report.hash, Trace::fingerprint(input_with_seed(11)).final_hash);
+    ASSERT_NE(report.hash, Trace::fingerprint(input_with_seed(12)).final_hash);
+}
+
+TEST(DeterminismTest, FingerprintsTheStaticStackStepByStep) {
+    auto expected = Trace::static_fingerprint(input_with_seed(11));
+    ASSERT_EQ(expected.step_hashes.size(), 400u);
+    ASSERT_FALSE(Trace::first_differing_step(expected, Trace::static_fingerprint(input_with_seed(11))).has_value());
+    ASSERT_TRUE(Trace::first_differing_step(expected, Trace::static_fingerprint(input_with_seed(12))).has_value());
+}
+
+TEST(DeterminismTest, LocatesTheFirstDifferingStep) {
+    auto expected = Trace::fingerprint(input_with_seed(11));
+    ASSERT_FALSE(Trace::first_differing_step(expected, expected).has_value());
+
+    // Hashes roll forward, so a changed decision shows up in every later step too
+    auto changed = expected;
+    for (size_t i = 99; i < changed.step_hashes.size(); ++i) {
+        changed.step_hashes[i] ^= 1;
+    }
+    ASSERT_EQ(Trace::first_differing_step(expected, changed), 100);
+
+    auto shorter = expected;
+    shorter.step_hashes.resize(250);
+    ASSERT_EQ(Trace::first_differing_step(expected, shorter), 251);
+
+    auto tail = expected;
+    tail.final_hash ^= 1;
+    ASSERT_EQ(Trace::first_differing_step(expected, tail), 401);
+}
+
+TEST(DeterminismTest, RejectsNonPositiveCounts) {
+    ASSERT_THROW(Trace::check_determinism(input_with_seed(11), 0, 1), std::invalid_argument);
+    ASSERT_THROW(Trace::check_determinism(input_with_seed(11), 2, 0), std::invalid_argument);
+}
@@ -0,0 +1,65 @@
+#include "src/trace/timeline.h"
+#include "src/trace/trace.h"
+#include "src/simulation/fuzz_input.h"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::vector<uint8_t> input_with_seed(uint32_t seed) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = 1000;
+    return input.to_bytes();
+}
+
+size_t count(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+TEST(TimelineTest, EveryTaskIsAttributedToANode) {
+    auto timeline = Trace::capture_timeline(input_with_seed(3));
+    ASSERT_EQ(timeline.wall_ns.size(), timeline.events.size());
+    size_t tasks = 0;
+    for (const auto& event : timeline.events) {
+        if (event.kind == Trace::EventKind::TaskPop) {
+            ++tasks;
+            ASSERT_GE(event.c, 0) << Trace::describe(event);
+        }
+    }
+    ASSERT_GT(tasks, 0u);
+}
+
+TEST(TimelineTest, ExportsTracksSpansAndCounters) {
+    auto timeline = Trace::capture_timeline(input_with_seed(3));
+    std::ostringstream json;
+    Trace::write_chrome_trace(timeline, Trace::TimelineClock::Virtual, json);
+    std::string text = json.str();
+
+    ASSERT_EQ(text.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    ASSERT_NE(text.find("\"name\":\"node 0\""), std::string::npos);
+    ASSERT_NE(text.find("\"name\":\"executor queue\""), std::string::npos);
+    ASSERT_NE(text.find("CANDIDATE term 1"), std::string::npos);
+    // Every RPC and message span that opens also closes, or is still open at the end
+    ASSERT_GT(count(text, "\"cat\":\"rpc\""), 0u);
+    ASSERT_GE(count(text, "\"ph\":\"b\",\"name\":\"msg"), count(text, "\"ph\":\"e\",\"name\":\"msg"));
+
+    std::ostringstream wall;
+    Trace::write_chrome_trace(timeline, Trace::TimelineClock::Wall, wall);
+    ASSERT_NE(wall.str().find("wall time"), std::string::npos);
+}
+
+TEST(TimelineTest, RecordingsOnlyHaveVirtualTime) {
+    auto timeline = Trace::timeline_of(Trace::record(input_with_seed(3), 100));
+    std::ostringstream json;
+    Trace::write_chrome_trace(timeline, Trace::TimelineClock::Virtual, json);
+    ASSERT_THROW(Trace::write_chrome_trace(timeline, Trace::TimelineClock::Wall, json), std::invalid_argument);
+    ASSERT_THROW(Trace::parse_timeline_clock("cpu"), std::invalid_argument);
+}
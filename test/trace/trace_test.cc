@@ -0,0 +1,76 @@
+#include "src/trace/trace.h"
+#include "src/simulation/fuzz_input.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <sstream>
+
+namespace {
+
+std::vector<uint8_t> input_with_seed(uint32_t seed) {
+    Simulation::FuzzInput input;
+    input.rng_seed = seed;
+    input.max_steps = 600;
+    return input.to_bytes();
+}
+
+} // namespace
+
+TEST(TraceTest, SavedTraceLoadsBackAndVerifies) {
+    auto recording = Trace::record(input_with_seed(7), 100);
+    ASSERT_EQ(recording.steps, 600);
+    ASSERT_EQ(recording.checkpoints.size(), 6u);
+
+    auto path = (std::filesystem::path(testing::TempDir()) / "trace_roundtrip.bin").string();
+    Trace::save(recording, path);
+    auto loaded = Trace::load(path);
+    ASSERT_EQ(loaded.input, recording.input);
+    ASSERT_TRUE(loaded.events == recording.events);
+    ASSERT_TRUE(loaded.checkpoints == recording.checkpoints);
+    ASSERT_FALSE(Trace::verify(loaded).has_value());
+}
+
+TEST(TraceTest, ReportsTheFirstDivergingEvent) {
+    auto expected = Trace::record(input_with_seed(7), 100);
+    auto tampered = expected;
+    size_t index = tampered.events.size() / 2;
+    tampered.events[index].c += 1;
+
+    auto divergence = Trace::first_divergence(expected, tampered);
+    ASSERT_TRUE(divergence.has_value());
+    ASSERT_EQ(divergence->event_index, index);
+    ASSERT_GT(divergence->step, 0);
+
+    // A trace that stops early diverges where it ends
+    auto truncated = expected;
+    truncated.events.resize(index);
+    divergence = Trace::first_divergence(expected, truncated);
+    ASSERT_EQ(divergence->event_index, index);
+    ASSERT_FALSE(divergence->actual.has_value());
+
+    ASSERT_TRUE(Trace::first_divergence(expected, Trace::record(input_with_seed(8), 100)).has_value());
+}
+
+TEST(TraceTest, SeekReplaysOnlyFromTheNearestCheckpoint) {
+    auto trace = Trace::record(input_with_seed(7), 100);
+    std::ostringstream log;
+    auto result = Trace::seek(trace, 250, log);
+    ASSERT_EQ(result.from.step, 200);
+    ASSERT_EQ(result.step, 250);
+    ASSERT_FALSE(result.divergence.has_value());
+    ASSERT_EQ(result.events.front(), trace.events[result.from.event_index]);
+    ASSERT_EQ(result.events.back().kind, Trace::EventKind::Step);
+    ASSERT_NE(log.str().find("[Trace]"), std::string::npos);
+}
+
+TEST(TraceTest, SeekBeforeFirstCheckpointReplaysFromStart) {
+    auto trace = Trace::record(input_with_seed(7), 100);
+    ASSERT_GT(trace.checkpoints.front().time, 50);
+    std::ostringstream log;
+    auto result = Trace::seek(trace, 50, log);
+    ASSERT_EQ(result.from, Trace::Checkpoint{});
+    ASSERT_FALSE(result.divergence.has_value());
+    // Including what the context drew while it was built
+    ASSERT_EQ(result.events.front(), trace.events.front());
+    ASSERT_EQ(result.events.back().kind, Trace::EventKind::Step);
+    ASSERT_GE(result.events.back().time, 50);
+}